@@ -4,7 +4,6 @@
 #include <ws2tcpip.h>
 #include "bookmark.hpp"
 #include "../chimera.hpp"
-#include "../event/frame.hpp"
 #include <windows.h>
 #include <cstring>
 #include <optional>
@@ -14,8 +13,7 @@
 #include "../halo_data/script.hpp"
 #include "../halo_data/resolution.hpp"
 #include "../localization/localization.hpp"
-#include <mutex>
-#include <thread>
+#include "../job/job.hpp"
 
 namespace Chimera {
     #define MAX_HISTORY_SIZE 20
@@ -163,7 +161,7 @@ namespace Chimera {
     }
     static std::vector<QueryPacketDone> finished_packets;
 
-    static std::mutex querying;
+    static bool querying = false;
 
     QueryPacketDone query_server(const Bookmark &what) {
         QueryPacketDone finished_packet;
@@ -264,15 +262,10 @@ namespace Chimera {
         for(auto &b : bookmarks) {
             finished_packets.push_back(query_server(b));
         }
-
-        querying.unlock();
     }
 
     static void show_list() {
-        if(!querying.try_lock()) {
-            return;
-        }
-        querying.unlock();
+        querying = false;
 
         // Show the results
         auto &resolution = get_resolution();
@@ -342,29 +335,27 @@ namespace Chimera {
                     break;
             }
         }
-
-        remove_preframe_event(show_list);
     }
 
     bool history_list_command(int, const char **) {
-        if(!querying.try_lock()) {
+        if(querying) {
             console_error(localize("chimera_bookmark_list_command_busy"));
             return false;
         }
+        querying = true;
         console_output(localize("chimera_history_list_command_querying"));
-        add_preframe_event(show_list);
-        std::thread(query_list, load_bookmarks_file("history.txt")).detach();
+        queue_job([bookmarks = load_bookmarks_file("history.txt")]() { query_list(bookmarks); }, show_list);
         return true;
     }
 
     bool bookmark_list_command(int, const char **) {
-        if(!querying.try_lock()) {
+        if(querying) {
             console_error(localize("chimera_bookmark_list_command_busy"));
             return false;
         }
+        querying = true;
         console_output(localize("chimera_bookmark_list_command_querying"));
-        add_preframe_event(show_list);
-        std::thread(query_list, load_bookmarks_file("bookmark.txt")).detach();
+        queue_job([bookmarks = load_bookmarks_file("bookmark.txt")]() { query_list(bookmarks); }, show_list);
         return true;
     }
 
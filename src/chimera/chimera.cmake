@@ -35,6 +35,7 @@ add_library(chimera STATIC
     src/chimera/chimera.cpp
     src/chimera/command/command.cpp
     src/chimera/command/hotkey.cpp
+    src/chimera/command/split_arguments.cpp
     src/chimera/config/config.cpp
     src/chimera/config/ini.cpp
     src/chimera/console/console.cpp
@@ -51,6 +52,7 @@ add_library(chimera STATIC
     src/chimera/event/d3d9_reset.S
     src/chimera/event/damage.cpp
     src/chimera/event/damage.S
+    src/chimera/event/event_profile.cpp
     src/chimera/event/frame.cpp
     src/chimera/event/map_load.cpp
     src/chimera/event/tick.cpp
@@ -95,7 +97,9 @@ add_library(chimera STATIC
     src/chimera/fix/interpolate/interpolate.cpp
     src/chimera/fix/interpolate/light.cpp
     src/chimera/fix/interpolate/object.cpp
+    src/chimera/fix/interpolate/object_interpolator.cpp
     src/chimera/fix/interpolate/particle.cpp
+    src/chimera/fix/interpolate/particle_interpolator.cpp
     src/chimera/fix/leak_descriptors.cpp
     src/chimera/fix/model_detail.cpp
     src/chimera/fix/model_detail.S
@@ -146,6 +150,8 @@ add_library(chimera STATIC
     src/chimera/halo_data/multiplayer.cpp
     src/chimera/halo_data/object.cpp
     src/chimera/halo_data/object.S
+    src/chimera/halo_data/object_children.cpp
+    src/chimera/halo_data/object_index.cpp
     src/chimera/halo_data/particle.cpp
     src/chimera/halo_data/path.cpp
     src/chimera/halo_data/pause.cpp
@@ -156,6 +162,8 @@ add_library(chimera STATIC
     src/chimera/halo_data/script.S
     src/chimera/halo_data/server.cpp
     src/chimera/halo_data/tag.cpp
+    src/chimera/job/job.cpp
+    src/chimera/job/job_pool.cpp
     src/chimera/localization/localization.cpp
     src/chimera/map_loading/map_loading.cpp
     src/chimera/map_loading/map_loading.S
@@ -163,25 +171,29 @@ add_library(chimera STATIC
     src/chimera/math_trig/math_trig.cpp
     src/chimera/miscellaneous/controller.cpp
     src/chimera/miscellaneous/controller.S
+    src/chimera/miscellaneous/frame_pacer.cpp
+    src/chimera/miscellaneous/timing_telemetry.cpp
     src/chimera/output/draw_text.cpp
     src/chimera/output/draw_text.S
     src/chimera/output/output.cpp
     src/chimera/output/output.S
     src/chimera/signature/hook.cpp
+    src/chimera/signature/instruction.cpp
     src/chimera/signature/signature.cpp
     src/chimera/signature/hac/codefinder.cpp
     src/chimera/version.rc
     ${COMMAND_FILES}
 
     ${CMAKE_CURRENT_BINARY_DIR}/localization_strings.hpp
+    ${CMAKE_CURRENT_BINARY_DIR}/localization_keys.hpp
     ${CMAKE_CURRENT_BINARY_DIR}/color_codes.hpp
 )
 add_dependencies(chimera chimera-version)
 
-# Set how we'll generate localization_string
+# Set how we'll generate localization_strings and localization_keys
 add_custom_command(
-    OUTPUT ${CMAKE_CURRENT_BINARY_DIR}/localization_strings.hpp
-    COMMAND ${PYTHON_EXECUTABLE} ${CMAKE_CURRENT_SOURCE_DIR}/src/chimera/localization/localizer.py ${CMAKE_CURRENT_SOURCE_DIR}/src/chimera/localization/language ${CMAKE_CURRENT_BINARY_DIR}/localization_strings.hpp
+    OUTPUT ${CMAKE_CURRENT_BINARY_DIR}/localization_strings.hpp ${CMAKE_CURRENT_BINARY_DIR}/localization_keys.hpp
+    COMMAND ${PYTHON_EXECUTABLE} ${CMAKE_CURRENT_SOURCE_DIR}/src/chimera/localization/localizer.py ${CMAKE_CURRENT_SOURCE_DIR}/src/chimera/localization/language ${CMAKE_CURRENT_BINARY_DIR}/localization_strings.hpp ${CMAKE_CURRENT_BINARY_DIR}/localization_keys.hpp
     DEPENDS ${CMAKE_CURRENT_SOURCE_DIR}/src/chimera/localization/language/*
 )
 
@@ -90,6 +90,7 @@ namespace Chimera {
                 std::snprintf(error, sizeof(error), "Chimera does not support %s. Please use %s.", build_string, expected_version);
                 MessageBox(nullptr, error, "Error", MB_ICONERROR | MB_OK);
                 this->p_signatures.clear();
+                free_code_snapshot();
                 return;
             }
 
@@ -284,6 +285,9 @@ namespace Chimera {
             // Make it so number one
             set_up_delayed_init();
         }
+        else {
+            free_code_snapshot();
+        }
     }
 
     bool Chimera::feature_present(const char *feature) {
@@ -373,55 +377,52 @@ namespace Chimera {
 
     CommandResult Chimera::execute_command(const char *command, const Command **found_command, bool saves) {
         // Try to parse it
-        auto arguments = split_arguments(command);
+        SplitArguments arguments(command);
 
         // Check if there actually was something given
         if(arguments.size() != 0) {
             // Get the command name and lowercase it
-            std::string command_name = arguments[0];
-            for(char &c : command_name) {
-                c = std::tolower(c);
+            for(char *c = arguments.argument(0); *c; c++) {
+                *c = std::tolower(*c);
             }
 
-            // Remove the command name from the arguments
-            arguments.erase(arguments.begin());
-
             // Find and execute the command
-            for(auto &cmd : this->p_commands) {
-                if(std::strcmp(command_name.data(), cmd.name()) == 0) {
-                    if(found_command) {
-                        *found_command = &cmd;
-                    }
-                    extern const char *output_prefix;
-                    auto *old_prefix = output_prefix;
-                    if(std::strcmp(cmd.name(), "chimera") == 0) {
-                        output_prefix = nullptr;
-                    }
-                    else {
-                        output_prefix = cmd.name();
-                    }
-                    auto result = cmd.call(arguments);
-                    output_prefix = old_prefix;
-
-                    if(saves && this->p_config.get() && result == CommandResult::COMMAND_RESULT_SUCCESS && cmd.autosave() && arguments.size() > 0) {
-                        this->p_config->set_settings_for_command(command_name.data(), arguments);
-                    }
-                    return result;
+            auto *cmd = this->find_command(arguments[0]);
+            if(cmd) {
+                if(found_command) {
+                    *found_command = cmd;
                 }
+                return this->call_command(*cmd, arguments.size() - 1, arguments.argv() + 1, saves);
             }
         }
         return CommandResult::COMMAND_RESULT_FAILED_ERROR_NOT_FOUND;
     }
 
+    CommandResult Chimera::call_command(const Command &command, std::size_t arg_count, const char **args, bool saves) {
+        extern const char *output_prefix;
+        auto *old_prefix = output_prefix;
+        if(std::strcmp(command.name(), "chimera") == 0) {
+            output_prefix = nullptr;
+        }
+        else {
+            output_prefix = command.name();
+        }
+        auto result = command.call(arg_count, args);
+        output_prefix = old_prefix;
+
+        if(saves && this->p_config.get() && result == CommandResult::COMMAND_RESULT_SUCCESS && command.autosave() && arg_count > 0) {
+            this->p_config->set_settings_for_command(command.name(), std::vector<std::string>(args, args + arg_count));
+        }
+        return result;
+    }
+
     Language Chimera::get_language() const noexcept {
         return this->p_language;
     }
 
     void Chimera::set_language(Language language) noexcept {
-        if(this->p_language != language) {
-            this->p_language = language;
-            this->get_all_commands();
-        }
+        // Command categories and help are localized when they're used, so nothing else needs to change
+        this->p_language = language;
     }
 
     Chimera &get_chimera() {
@@ -436,6 +437,12 @@ namespace Chimera {
         delete chimera;
     }
 
+    extern "C" void flush_chimera() {
+        if(chimera) {
+            flush_config();
+        }
+    }
+
     #define SECONDARY_FEATURE (halo_type() == 2 ? "server" : "client")
 
     extern "C" int find_signatures() {
@@ -552,7 +559,33 @@ namespace Chimera {
     }
 
     void Chimera::reload_ini() {
-        this->p_ini = std::make_unique<Ini>("chimera.ini");
+        auto ini = std::make_unique<Ini>();
+        IniError error;
+        if(!ini->load("chimera.ini", error)) {
+            // We can't do anything without this, so show what's wrong and close
+            char message[1024];
+            if(error.line_number == 0) {
+                std::snprintf(message, sizeof(message), "chimera.ini could not be opened.\n\nMake sure it exists and you have permission to it.\n\nThe game must close now.\n");
+            }
+            else {
+                std::snprintf(message, sizeof(message), "chimera.ini error (line #%zu):\n\n%s\n\nThis line could not be parsed. The game must close now.\n", error.line_number, error.line.c_str());
+            }
+            if(this->feature_present("server")) {
+                std::cerr << message;
+            }
+            else {
+                MessageBox(nullptr, message, "Chimera configuration error", MB_ICONERROR | MB_OK);
+            }
+            ExitProcess(136);
+        }
+        this->p_ini = std::move(ini);
+    }
+
+    void ini_invalid_value(const char *key, const char *value, const char *expected) noexcept {
+        char error[512];
+        std::snprintf(error, sizeof(error), "%s (=> %s) is not %s", key, value, expected);
+        MessageBox(nullptr, error, "Can't read INI value", MB_ICONERROR | MB_OK);
+        std::terminate();
     }
 
     const Ini *Chimera::get_ini() const noexcept {
@@ -713,6 +746,9 @@ namespace Chimera {
         if(!is_server) {
             get_chimera().get_config().set_saving(true);
         }
+
+        // Startup hooking is done, so we don't need a copy of Halo's code anymore
+        free_code_snapshot();
     }
 
     static void set_up_delayed_init() {
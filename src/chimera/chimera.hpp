@@ -5,6 +5,9 @@
 
 #include <cstddef>
 #include <memory>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 #include "command/command.hpp"
 #include "event/event.hpp"
@@ -63,6 +66,16 @@ namespace Chimera {
          */
         CommandResult execute_command(const char *command, const Command **found_command = nullptr, bool saves = false);
 
+        /**
+         * Call a command that was already looked up
+         * @param  command   command to call
+         * @param  arg_count number of arguments, not including the command name
+         * @param  args      arguments, not including the command name
+         * @param  saves     save the arguments to the config if successful
+         * @return           result of command
+         */
+        CommandResult call_command(const Command &command, std::size_t arg_count, const char **args, bool saves = false);
+
         /**
          * Get the config
          * @return config
@@ -110,6 +123,32 @@ namespace Chimera {
          */
         const std::vector<Command> &get_commands() const noexcept;
 
+        /**
+         * Find a command by name
+         * @param  name name of the command (lowercase)
+         * @return      pointer to the command or nullptr if not found
+         */
+        const Command *find_command(const char *name) const noexcept;
+
+        /**
+         * Get all of the commands sorted by name
+         * @return all of the commands sorted by name
+         */
+        const std::vector<const Command *> &get_commands_by_name() const noexcept;
+
+        /**
+         * Find all commands whose names start with the prefix
+         * @param  prefix prefix to look for (lowercase)
+         * @return        range [first, last) of matching commands in get_commands_by_name()
+         */
+        std::pair<std::size_t, std::size_t> find_commands_with_prefix(const char *prefix) const noexcept;
+
+        /**
+         * Get all of the command categories in the order they were first seen
+         * @return all of the command categories
+         */
+        const std::vector<CommandCategory> &get_command_categories() const noexcept;
+
         /** Construct a Chimera */
         Chimera();
 
@@ -126,6 +165,15 @@ namespace Chimera {
         /** Commands in Chimera */
         std::vector<Command> p_commands;
 
+        /** Indices of commands in p_commands by name */
+        std::unordered_map<std::string_view, std::size_t> p_command_index;
+
+        /** Commands sorted by name; prefix lookups are binary searches over this */
+        std::vector<const Command *> p_commands_by_name;
+
+        /** Command categories */
+        std::vector<CommandCategory> p_command_categories;
+
         /** Config file for Chimera */
         std::unique_ptr<Config> p_config;
 
@@ -166,6 +214,11 @@ namespace Chimera {
          * Get all commands
          */
         void get_all_commands() noexcept;
+
+        /**
+         * Build the command name index, sorted list, and categories from p_commands
+         */
+        void index_commands();
     };
 
     /**
@@ -178,6 +231,11 @@ namespace Chimera {
      */
     extern "C" void destroy_chimera();
 
+    /**
+     * Write anything that hasn't been saved yet. This is called when the process exits.
+     */
+    extern "C" void flush_chimera();
+
     /**
      * Check if all features are valid.
      * @return 0 on failure, 1 on success
@@ -0,0 +1,192 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include <windows.h>
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+
+#include "../../../event/event_profile.hpp"
+#include "../../../event/frame.hpp"
+#include "../../../localization/localization.hpp"
+#include "../../../output/draw_text.hpp"
+#include "../../../output/output.hpp"
+#include "../../../chimera.hpp"
+#include "../../../command/command.hpp"
+
+namespace Chimera {
+    static void show_event_profile() noexcept;
+    static void dump_event_profile() noexcept;
+
+    bool event_profile_command(int argc, const char **argv) noexcept {
+        if(argc) {
+            if(std::strcmp(argv[0], "dump") == 0) {
+                dump_event_profile();
+                return true;
+            }
+            else if(std::strcmp(argv[0], "reset") == 0) {
+                reset_event_profiles();
+                return true;
+            }
+            else {
+                bool new_enabled = STR_TO_BOOL(argv[0]);
+                if(new_enabled != event_profiler_enabled) {
+                    if(new_enabled) {
+                        add_preframe_event(show_event_profile, EventPriority::EVENT_PRIORITY_FINAL);
+                    }
+                    else {
+                        remove_preframe_event(show_event_profile);
+                    }
+                    set_event_profiler_enabled(new_enabled);
+                }
+            }
+        }
+
+        console_output(BOOL_TO_STR(event_profiler_enabled));
+        return true;
+    }
+
+    static const char *priority_name(EventPriority priority) noexcept {
+        switch(priority) {
+            case EventPriority::EVENT_PRIORITY_BEFORE:
+                return "before";
+            case EventPriority::EVENT_PRIORITY_DEFAULT:
+                return "default";
+            case EventPriority::EVENT_PRIORITY_AFTER:
+                return "after";
+            case EventPriority::EVENT_PRIORITY_FINAL:
+                return "final";
+        }
+        return "unknown";
+    }
+
+    // Get the module and offset of a function so it can be found in a map file
+    static void function_name(const void *function, char *name, std::size_t name_size) noexcept {
+        HMODULE module;
+        if(GetModuleHandleExA(GET_MODULE_HANDLE_EX_FLAG_FROM_ADDRESS | GET_MODULE_HANDLE_EX_FLAG_UNCHANGED_REFCOUNT, reinterpret_cast<LPCSTR>(function), &module)) {
+            char path[MAX_PATH] = {};
+            GetModuleFileNameA(module, path, sizeof(path));
+            const char *module_name = path;
+            for(const char *i = path; *i; i++) {
+                if(*i == '/' || *i == '\\') {
+                    module_name = i + 1;
+                }
+            }
+            std::snprintf(name, name_size, "%s+%X", module_name, reinterpret_cast<std::uintptr_t>(function) - reinterpret_cast<std::uintptr_t>(module));
+        }
+        else {
+            std::snprintf(name, name_size, "0x%.08X", reinterpret_cast<std::uintptr_t>(function));
+        }
+    }
+
+    // Get the profiles sorted by total time spent, most first
+    static std::vector<const EventListenerProfile *> sorted_profiles() noexcept {
+        auto &profiles = get_event_profiles();
+        std::vector<const EventListenerProfile *> sorted;
+        sorted.reserve(profiles.size());
+        for(auto &profile : profiles) {
+            sorted.push_back(&profile);
+        }
+        std::sort(sorted.begin(), sorted.end(), [](auto *a, auto *b) { return a->total_ns > b->total_ns; });
+        return sorted;
+    }
+
+    static void dump_event_profile() noexcept {
+        char path[MAX_PATH];
+        std::snprintf(path, sizeof(path), "%schimera_event_profile.csv", get_chimera().get_path());
+        std::ofstream o(path, std::ios_base::out | std::ios_base::trunc);
+        char line[512];
+
+        #define DUMP_FMT "%s,%s,%s,%s,%s,%s,%s,%s,%s\n"
+        std::snprintf(line, sizeof(line), DUMP_FMT, "Event", "Priority", "Function", "Calls", "Total (us)", "Mean (us)", "P50 (us)", "P99 (us)", "Max (us)");
+        o << line;
+        #undef DUMP_FMT
+
+        for(auto *profile : sorted_profiles()) {
+            char function[MAX_PATH + 16];
+            function_name(profile->function, function, sizeof(function));
+            std::snprintf(line, sizeof(line), "%s,%s,%s,%llu,%.3f,%.3f,%.3f,%.3f,%.3f\n",
+                profile->event_name,
+                priority_name(profile->priority),
+                function,
+                static_cast<unsigned long long>(profile->calls),
+                profile->total_ns / 1000.0,
+                profile->total_ns / 1000.0 / profile->calls,
+                profile->percentile_ns(50.0) / 1000.0,
+                profile->percentile_ns(99.0) / 1000.0,
+                profile->max_ns / 1000.0
+            );
+            o << line;
+        }
+
+        o.flush();
+        o.close();
+
+        console_output(localize("chimera_event_profile_command_dumped"), path);
+    }
+
+    static constexpr std::size_t max_rows = 16;
+
+    static constexpr std::int16_t x_function = 630;
+    static constexpr std::int16_t x_function_width = 170;
+
+    static constexpr std::int16_t x_event = x_function - x_function_width;
+    static constexpr std::int16_t x_event_width = 90;
+
+    static constexpr std::int16_t x_priority = x_event - x_event_width;
+    static constexpr std::int16_t x_priority_width = 55;
+
+    static constexpr std::int16_t x_calls = x_priority - x_priority_width;
+    static constexpr std::int16_t x_calls_width = 60;
+
+    static constexpr std::int16_t x_p50 = x_calls - x_calls_width;
+    static constexpr std::int16_t x_p50_width = 55;
+
+    static constexpr std::int16_t x_p99 = x_p50 - x_p50_width;
+    static constexpr std::int16_t x_p99_width = 55;
+
+    static constexpr std::int16_t x_max = x_p99 - x_p99_width;
+    static constexpr std::int16_t x_max_width = 55;
+
+    static ColorARGB blue = ColorARGB { 0.7, 0.45, 0.72, 1.0 };
+
+    static void show_event_profile() noexcept {
+        auto font = GenericFont::FONT_CONSOLE;
+        std::int16_t increment = font_pixel_height(font);
+        std::int16_t y = 480 - increment * (max_rows + 2);
+
+        auto column = [&font, &y](const char *text, std::int16_t x, std::int16_t width, FontAlignment alignment) {
+            apply_text(text, x, y, width, 480, blue, font, alignment, TextAnchor::ANCHOR_TOP_RIGHT);
+        };
+
+        // Header
+        column("Function", x_function, x_function_width, FontAlignment::ALIGN_RIGHT);
+        column("Event", x_event, x_event_width, FontAlignment::ALIGN_CENTER);
+        column("Priority", x_priority, x_priority_width, FontAlignment::ALIGN_CENTER);
+        column("Calls", x_calls, x_calls_width, FontAlignment::ALIGN_CENTER);
+        column("P50 us", x_p50, x_p50_width, FontAlignment::ALIGN_CENTER);
+        column("P99 us", x_p99, x_p99_width, FontAlignment::ALIGN_CENTER);
+        column("Max us", x_max, x_max_width, FontAlignment::ALIGN_CENTER);
+        y += increment;
+
+        // Show the functions taking the most time
+        auto sorted = sorted_profiles();
+        for(std::size_t i = 0; i < sorted.size() && i < max_rows; i++) {
+            auto *profile = sorted[i];
+            char buffer[MAX_PATH + 16];
+
+            function_name(profile->function, buffer, sizeof(buffer));
+            column(buffer, x_function, x_function_width, FontAlignment::ALIGN_RIGHT);
+            column(profile->event_name, x_event, x_event_width, FontAlignment::ALIGN_CENTER);
+            column(priority_name(profile->priority), x_priority, x_priority_width, FontAlignment::ALIGN_CENTER);
+            std::snprintf(buffer, sizeof(buffer), "%llu", static_cast<unsigned long long>(profile->calls));
+            column(buffer, x_calls, x_calls_width, FontAlignment::ALIGN_CENTER);
+            std::snprintf(buffer, sizeof(buffer), "%.1f", profile->percentile_ns(50.0) / 1000.0);
+            column(buffer, x_p50, x_p50_width, FontAlignment::ALIGN_CENTER);
+            std::snprintf(buffer, sizeof(buffer), "%.1f", profile->percentile_ns(99.0) / 1000.0);
+            column(buffer, x_p99, x_p99_width, FontAlignment::ALIGN_CENTER);
+            std::snprintf(buffer, sizeof(buffer), "%.1f", profile->max_ns / 1000.0);
+            column(buffer, x_max, x_max_width, FontAlignment::ALIGN_CENTER);
+            y += increment;
+        }
+    }
+}
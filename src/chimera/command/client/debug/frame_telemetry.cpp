@@ -0,0 +1,297 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include <d3d9.h>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+
+#include "../../../event/d3d9_end_scene.hpp"
+#include "../../../event/d3d9_reset.hpp"
+#include "../../../event/frame.hpp"
+#include "../../../event/tick.hpp"
+#include "../../../fix/interpolate/object.hpp"
+#include "../../../job/job.hpp"
+#include "../../../localization/localization.hpp"
+#include "../../../miscellaneous/timing_telemetry.hpp"
+#include "../../../output/draw_text.hpp"
+#include "../../../output/output.hpp"
+#include "../../../chimera.hpp"
+#include "../../../command/command.hpp"
+
+namespace Chimera {
+    static TimingRing timing_ring;
+    static bool enabled = false;
+
+    // Samples and statistics are refreshed a few times per second rather than every frame
+    static std::vector<TimingSample> samples;
+    static TimingStatistics statistics;
+    static std::vector<double> graph_frame_times;
+    static std::chrono::steady_clock::time_point next_refresh;
+
+    static void record(TimingSampleType type) noexcept {
+        auto now = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+        timing_ring.push(TimingSample { now, get_tick_count(), type });
+    }
+
+    static void on_preframe_sample() noexcept {
+        record(TimingSampleType::TIMING_SAMPLE_PREFRAME);
+    }
+
+    static void on_frame_sample() noexcept {
+        record(TimingSampleType::TIMING_SAMPLE_FRAME);
+    }
+
+    static void on_pretick_sample() noexcept {
+        record(TimingSampleType::TIMING_SAMPLE_PRETICK);
+    }
+
+    static void on_tick_sample() noexcept {
+        record(TimingSampleType::TIMING_SAMPLE_TICK);
+    }
+
+    static double tick_interval_ms() noexcept {
+        return 1000.0 / effective_tick_rate();
+    }
+
+    static void show_telemetry() noexcept;
+    static void draw_graph(LPDIRECT3DDEVICE9 device) noexcept;
+    static void release_graph_state(LPDIRECT3DDEVICE9 device = nullptr, D3DPRESENT_PARAMETERS *present = nullptr) noexcept;
+    static void dump_telemetry() noexcept;
+
+    bool frame_telemetry_command(int argc, const char **argv) noexcept {
+        if(argc) {
+            if(std::strcmp(argv[0], "dump") == 0) {
+                dump_telemetry();
+                return true;
+            }
+
+            bool new_enabled = STR_TO_BOOL(argv[0]);
+            if(new_enabled != enabled) {
+                if(new_enabled) {
+                    timing_ring.clear();
+                    statistics = {};
+                    graph_frame_times.clear();
+
+                    // Take samples as close to the boundaries as possible
+                    add_preframe_event(on_preframe_sample, EventPriority::EVENT_PRIORITY_BEFORE);
+                    add_frame_event(on_frame_sample, EventPriority::EVENT_PRIORITY_FINAL);
+                    add_pretick_event(on_pretick_sample, EventPriority::EVENT_PRIORITY_BEFORE);
+                    add_tick_event(on_tick_sample, EventPriority::EVENT_PRIORITY_FINAL);
+                    add_preframe_event(show_telemetry, EventPriority::EVENT_PRIORITY_FINAL);
+                    add_d3d9_end_scene_event(draw_graph, EventPriority::EVENT_PRIORITY_FINAL);
+                    add_d3d9_reset_event(release_graph_state);
+                }
+                else {
+                    remove_preframe_event(on_preframe_sample);
+                    remove_frame_event(on_frame_sample);
+                    remove_pretick_event(on_pretick_sample);
+                    remove_tick_event(on_tick_sample);
+                    remove_preframe_event(show_telemetry);
+                    remove_d3d9_end_scene_event(draw_graph);
+                    remove_d3d9_reset_event(release_graph_state);
+                    release_graph_state();
+                }
+                enabled = new_enabled;
+            }
+        }
+
+        console_output(BOOL_TO_STR(enabled));
+        return true;
+    }
+
+    static const char *sample_type_name(TimingSampleType type) noexcept {
+        switch(type) {
+            case TimingSampleType::TIMING_SAMPLE_PREFRAME:
+                return "preframe";
+            case TimingSampleType::TIMING_SAMPLE_FRAME:
+                return "frame";
+            case TimingSampleType::TIMING_SAMPLE_PRETICK:
+                return "pretick";
+            case TimingSampleType::TIMING_SAMPLE_TICK:
+                return "tick";
+        }
+        return "unknown";
+    }
+
+    static void dump_telemetry() noexcept {
+        char path[MAX_PATH];
+        std::snprintf(path, sizeof(path), "%schimera_frame_telemetry.csv", get_chimera().get_path());
+
+        // Copy the samples now, but write them out on another thread
+        std::vector<TimingSample> dump_samples;
+        timing_ring.copy(dump_samples);
+        auto dump_statistics = compute_timing_statistics(dump_samples, tick_interval_ms());
+        std::string path_str = path;
+
+        queue_job([dump_samples = std::move(dump_samples), path_str]() {
+            std::ofstream o(path_str, std::ios_base::out | std::ios_base::trunc);
+            char line[256];
+            std::snprintf(line, sizeof(line), "%s,%s,%s\n", "Event", "Time (ms)", "Tick");
+            o << line;
+
+            std::int64_t start = dump_samples.empty() ? 0 : dump_samples[0].time_ns;
+            for(auto &sample : dump_samples) {
+                std::snprintf(line, sizeof(line), "%s,%.4f,%i\n", sample_type_name(sample.type), (sample.time_ns - start) / 1000000.0, sample.tick_count);
+                o << line;
+            }
+
+            o.flush();
+            o.close();
+        }, [path_str, dump_statistics]() {
+            console_output(localize("chimera_frame_telemetry_command_dumped"), path_str.c_str());
+            console_output("p50 %.02f ms, p95 %.02f ms, p99 %.02f ms, max %.02f ms, %zu hitches / %zu frames", dump_statistics.frame_p50_ms, dump_statistics.frame_p95_ms, dump_statistics.frame_p99_ms, dump_statistics.frame_max_ms, dump_statistics.hitches, dump_statistics.frames);
+            console_output("%zu ticks, %.03f ms average, %+.02f ms drift", dump_statistics.ticks, dump_statistics.tick_mean_ms, dump_statistics.tick_drift_ms);
+        });
+    }
+
+    static ColorARGB blue = ColorARGB { 0.7, 0.45, 0.72, 1.0 };
+
+    // Frames shown on the graph
+    #define GRAPH_FRAMES 240
+
+    static void show_telemetry() noexcept {
+        // Refresh the statistics
+        auto now = std::chrono::steady_clock::now();
+        if(now >= next_refresh) {
+            next_refresh = now + std::chrono::milliseconds(250);
+            timing_ring.copy(samples);
+            statistics = compute_timing_statistics(samples, tick_interval_ms());
+            graph_frame_times = frame_times_ms(samples);
+            if(graph_frame_times.size() > GRAPH_FRAMES) {
+                graph_frame_times.erase(graph_frame_times.begin(), graph_frame_times.end() - GRAPH_FRAMES);
+            }
+        }
+
+        auto font = GenericFont::FONT_CONSOLE;
+        std::int16_t increment = font_pixel_height(font);
+        std::int16_t y = 480 - increment * 4;
+        char buffer[256];
+
+        std::snprintf(buffer, sizeof(buffer), "p50 %.02f ms | p95 %.02f ms | p99 %.02f ms | max %.02f ms | %zu hitches", statistics.frame_p50_ms, statistics.frame_p95_ms, statistics.frame_p99_ms, statistics.frame_max_ms, statistics.hitches);
+        apply_text(std::string(buffer), 5, y, 630, increment, blue, font, FontAlignment::ALIGN_LEFT, TextAnchor::ANCHOR_TOP_LEFT);
+        y += increment;
+
+        std::snprintf(buffer, sizeof(buffer), "tick %.03f ms (expected %.03f ms) | drift %+.02f ms over %zu ticks", statistics.tick_mean_ms, tick_interval_ms(), statistics.tick_drift_ms, statistics.ticks);
+        apply_text(std::string(buffer), 5, y, 630, increment, blue, font, FontAlignment::ALIGN_LEFT, TextAnchor::ANCHOR_TOP_LEFT);
+        y += increment;
+
+        auto &objects = interpolate_object_statistics();
+        std::snprintf(buffer, sizeof(buffer), "objects %zu copied, %zu unchanged | %zu interpolated, %zu skipped", objects.copied, objects.unchanged, objects.interpolated, objects.skipped);
+        apply_text(std::string(buffer), 5, y, 630, increment, blue, font, FontAlignment::ALIGN_LEFT, TextAnchor::ANCHOR_TOP_LEFT);
+    }
+
+    struct GraphVertex {
+        float x, y, z, rhw;
+        D3DCOLOR color;
+    };
+    #define GRAPH_VERTEX_FVF (D3DFVF_XYZRHW | D3DFVF_DIFFUSE)
+
+    static constexpr D3DCOLOR argb(std::uint8_t a, std::uint8_t r, std::uint8_t g, std::uint8_t b) noexcept {
+        return (static_cast<D3DCOLOR>(a) << 24) | (static_cast<D3DCOLOR>(r) << 16) | (static_cast<D3DCOLOR>(g) << 8) | static_cast<D3DCOLOR>(b);
+    }
+
+    // This holds the states the graph sets so they can be put back after it's drawn. It has to be released before the device is reset, and
+    // it's made again the next time the graph is drawn.
+    static IDirect3DStateBlock9 *graph_state = nullptr;
+    static LPDIRECT3DDEVICE9 graph_state_device = nullptr;
+
+    static void set_graph_state(LPDIRECT3DDEVICE9 device) noexcept {
+        device->SetVertexShader(nullptr);
+        device->SetPixelShader(nullptr);
+        device->SetTexture(0, nullptr);
+        device->SetFVF(GRAPH_VERTEX_FVF);
+        device->SetRenderState(D3DRS_ZENABLE, FALSE);
+        device->SetRenderState(D3DRS_LIGHTING, FALSE);
+        device->SetRenderState(D3DRS_CULLMODE, D3DCULL_NONE);
+        device->SetRenderState(D3DRS_ALPHABLENDENABLE, TRUE);
+        device->SetRenderState(D3DRS_SRCBLEND, D3DBLEND_SRCALPHA);
+        device->SetRenderState(D3DRS_DESTBLEND, D3DBLEND_INVSRCALPHA);
+        device->SetTextureStageState(0, D3DTSS_COLOROP, D3DTOP_SELECTARG1);
+        device->SetTextureStageState(0, D3DTSS_COLORARG1, D3DTA_DIFFUSE);
+        device->SetTextureStageState(0, D3DTSS_ALPHAOP, D3DTOP_SELECTARG1);
+        device->SetTextureStageState(0, D3DTSS_ALPHAARG1, D3DTA_DIFFUSE);
+    }
+
+    static void release_graph_state(LPDIRECT3DDEVICE9, D3DPRESENT_PARAMETERS *) noexcept {
+        if(graph_state) {
+            graph_state->Release();
+            graph_state = nullptr;
+            graph_state_device = nullptr;
+        }
+    }
+
+    static void draw_graph(LPDIRECT3DDEVICE9 device) noexcept {
+        if(graph_frame_times.size() < 2) {
+            return;
+        }
+
+        D3DVIEWPORT9 viewport;
+        if(device->GetViewport(&viewport) != D3D_OK) {
+            return;
+        }
+
+        // The graph sits in the bottom left corner above the statistics. The top of the graph is four times the median frame time so
+        // hitches stand out.
+        float width = viewport.Width * 0.4F;
+        float height = viewport.Height * 0.15F;
+        float left = viewport.X + viewport.Width * 0.01F;
+        float bottom = viewport.Y + viewport.Height * (1.0F - 4.5F / 24.0F);
+        float top = bottom - height;
+        double scale_ms = statistics.frame_p50_ms > 0.0 ? statistics.frame_p50_ms * 4.0 : 50.0;
+
+        // Save only what the graph changes. Capturing a state block made from just these states is much cheaper than making a new
+        // state block of everything every frame.
+        if(graph_state && graph_state_device != device) {
+            release_graph_state();
+        }
+        if(!graph_state) {
+            if(device->BeginStateBlock() != D3D_OK) {
+                return;
+            }
+            set_graph_state(device);
+            if(device->EndStateBlock(&graph_state) != D3D_OK) {
+                graph_state = nullptr;
+                return;
+            }
+            graph_state_device = device;
+        }
+        graph_state->Capture();
+        set_graph_state(device);
+
+        // Background
+        D3DCOLOR background_color = argb(0x80, 0, 0, 0);
+        GraphVertex background[4] = {
+            { left, top, 0.0F, 1.0F, background_color },
+            { left + width, top, 0.0F, 1.0F, background_color },
+            { left, bottom, 0.0F, 1.0F, background_color },
+            { left + width, bottom, 0.0F, 1.0F, background_color }
+        };
+        device->DrawPrimitiveUP(D3DPT_TRIANGLESTRIP, 2, background, sizeof(*background));
+
+        // Median line
+        float median_y = bottom - static_cast<float>(statistics.frame_p50_ms / scale_ms) * height;
+        D3DCOLOR median_color = argb(0xC0, 0x73, 0xB8, 0xFF);
+        GraphVertex median[2] = {
+            { left, median_y, 0.0F, 1.0F, median_color },
+            { left + width, median_y, 0.0F, 1.0F, median_color }
+        };
+        device->DrawPrimitiveUP(D3DPT_LINELIST, 1, median, sizeof(*median));
+
+        // Frame times; hitches are red
+        GraphVertex line[GRAPH_FRAMES];
+        std::size_t count = graph_frame_times.size();
+        for(std::size_t i = 0; i < count; i++) {
+            double time = std::min(graph_frame_times[i], scale_ms);
+            bool hitch = graph_frame_times[i] > statistics.frame_p50_ms * 2.0;
+            line[i].x = left + width * i / (GRAPH_FRAMES - 1);
+            line[i].y = bottom - static_cast<float>(time / scale_ms) * height;
+            line[i].z = 0.0F;
+            line[i].rhw = 1.0F;
+            line[i].color = hitch ? argb(0xFF, 0xFF, 0x40, 0x40) : argb(0xFF, 0x40, 0xFF, 0x40);
+        }
+        device->DrawPrimitiveUP(D3DPT_LINESTRIP, count - 1, line, sizeof(*line));
+
+        graph_state->Apply();
+    }
+}
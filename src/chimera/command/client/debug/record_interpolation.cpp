@@ -0,0 +1,225 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include <windows.h>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "../../../event/tick.hpp"
+#include "../../../halo_data/antenna.hpp"
+#include "../../../halo_data/camera.hpp"
+#include "../../../halo_data/flag.hpp"
+#include "../../../halo_data/object.hpp"
+#include "../../../halo_data/particle.hpp"
+#include "../../../job/job.hpp"
+#include "../../../localization/localization.hpp"
+#include "../../../output/output.hpp"
+#include "../../../chimera.hpp"
+#include "../../../command/command.hpp"
+
+namespace Chimera {
+    // A recording is a header followed by one record for each tick. Everything is little endian and packed.
+    //
+    // Header:
+    //   char[4]  "CHIR"
+    //   uint32   version (1)
+    //   float    tick rate
+    //   uint32   sizeof(ModelNode), sizeof(CameraData), sizeof(Flag), sizeof(Antenna)
+    //
+    // Tick:
+    //   int32    tick count
+    //   uint16   object count, then for each object:
+    //              uint16 index, TagID tag ID, uint16 type, uint16 parent index, uint8 no collision, Point3D center,
+    //              uint16 node count, ModelNode[node count] nodes
+    //   uint16   particle count, then for each particle:
+    //              uint16 index, uint32 unknown0, Point3D position
+    //   uint16   camera type, CameraData camera data
+    //   uint8    flag count, then for each flag: uint8 index, Flag flag
+    //   uint8    antenna count, then for each antenna: uint8 index, Antenna antenna
+    #define RECORDING_VERSION 1
+
+    // Recordings stop on their own once they get this big so they don't use up Halo's address space.
+    #define MAX_RECORDING_SIZE (64 * 1024 * 1024)
+
+    // Recordings are stored in chunks of at least this size. Appending to one big vector would reallocate and copy everything each time
+    // it filled up, briefly needing up to twice the recording size.
+    #define RECORDING_CHUNK_SIZE (1024 * 1024)
+
+    static std::vector<std::vector<std::uint8_t>> recording;
+    static std::size_t recording_size = 0;
+    static std::size_t recorded_ticks = 0;
+    static bool recording_enabled = false;
+
+    // This is the record being written. It is reused for every tick and then appended to the recording.
+    static std::vector<std::uint8_t> record;
+
+    static void write(const void *data, std::size_t size) {
+        auto *bytes = reinterpret_cast<const std::uint8_t *>(data);
+        record.insert(record.end(), bytes, bytes + size);
+    }
+
+    template<typename T> static void write(const T &value) {
+        write(&value, sizeof(value));
+    }
+
+    // Write a placeholder count and return where it is so it can be filled in later
+    template<typename T> static std::size_t write_count() {
+        auto offset = record.size();
+        write(T {});
+        return offset;
+    }
+
+    template<typename T> static void fill_count(std::size_t offset, T count) {
+        std::memcpy(record.data() + offset, &count, sizeof(count));
+    }
+
+    // Append the record to the recording, starting a new chunk if it doesn't fit in the last one
+    static void finish_record() {
+        if(recording.empty() || recording.back().capacity() - recording.back().size() < record.size()) {
+            recording.emplace_back().reserve(std::max<std::size_t>(RECORDING_CHUNK_SIZE, record.size()));
+        }
+        recording.back().insert(recording.back().end(), record.begin(), record.end());
+        recording_size += record.size();
+        record.clear();
+    }
+
+    static void stop_recording() noexcept;
+
+    static void record_tick() noexcept {
+        write(get_tick_count());
+
+        // Objects
+        auto &object_table = ObjectTable::get_object_table();
+        auto object_count_offset = write_count<std::uint16_t>();
+        std::uint16_t object_count = 0;
+        for(std::size_t i = 0; i < object_table.current_size; i++) {
+            auto *object = object_table.get_dynamic_object(i);
+            if(!object) {
+                continue;
+            }
+            auto *nodes = object->nodes();
+            std::uint16_t node_count = nodes ? static_cast<std::uint16_t>(object->node_count()) : 0;
+            write(static_cast<std::uint16_t>(i));
+            write(object->tag_id);
+            write(static_cast<std::uint16_t>(object->type));
+            write(object->parent.index.index);
+            write(static_cast<std::uint8_t>(object->no_collision));
+            write(object->center_position);
+            write(node_count);
+            write(nodes, sizeof(*nodes) * node_count);
+            object_count++;
+        }
+        fill_count(object_count_offset, object_count);
+
+        // Particles
+        auto &particle_table = ParticleTable::get_particle_table();
+        auto particle_count_offset = write_count<std::uint16_t>();
+        std::uint16_t particle_count = 0;
+        for(std::size_t i = 0; i < particle_table.current_size; i++) {
+            auto *particle = particle_table.get_element(i);
+            if(!particle) {
+                continue;
+            }
+            write(static_cast<std::uint16_t>(i));
+            write(particle->unknown0);
+            write(particle->position);
+            particle_count++;
+        }
+        fill_count(particle_count_offset, particle_count);
+
+        // Camera
+        write(static_cast<std::uint16_t>(camera_type()));
+        write(camera_data());
+
+        // Flags
+        auto &flag_table = FlagTable::get_flag_table();
+        auto flag_count_offset = write_count<std::uint8_t>();
+        std::uint8_t flag_count = 0;
+        for(std::size_t i = 0; i < flag_table.current_size && i < 0x100; i++) {
+            write(static_cast<std::uint8_t>(i));
+            write(*flag_table.get_element(i));
+            flag_count++;
+        }
+        fill_count(flag_count_offset, flag_count);
+
+        // Antennas
+        auto &antenna_table = AntennaTable::get_antenna_table();
+        auto antenna_count_offset = write_count<std::uint8_t>();
+        std::uint8_t antenna_count = 0;
+        for(std::size_t i = 0; i < antenna_table.current_size && i < 0x100; i++) {
+            write(static_cast<std::uint8_t>(i));
+            write(*antenna_table.get_element(i));
+            antenna_count++;
+        }
+        fill_count(antenna_count_offset, antenna_count);
+
+        finish_record();
+        recorded_ticks++;
+        if(recording_size >= MAX_RECORDING_SIZE) {
+            stop_recording();
+        }
+    }
+
+    static void start_recording() noexcept {
+        recording.clear();
+        recording_size = 0;
+        recorded_ticks = 0;
+
+        write("CHIR", 4);
+        write(static_cast<std::uint32_t>(RECORDING_VERSION));
+        write(effective_tick_rate());
+        write(static_cast<std::uint32_t>(sizeof(ModelNode)));
+        write(static_cast<std::uint32_t>(sizeof(CameraData)));
+        write(static_cast<std::uint32_t>(sizeof(Flag)));
+        write(static_cast<std::uint32_t>(sizeof(Antenna)));
+        finish_record();
+
+        // Record after everything else has had a chance to change things this tick
+        add_tick_event(record_tick, EventPriority::EVENT_PRIORITY_FINAL);
+        recording_enabled = true;
+    }
+
+    static void stop_recording() noexcept {
+        remove_tick_event(record_tick);
+        recording_enabled = false;
+
+        char path[MAX_PATH];
+        std::snprintf(path, sizeof(path), "%schimera_interpolation_recording.bin", get_chimera().get_path());
+        std::string path_str = path;
+        auto ticks = recorded_ticks;
+
+        // Hand the recording off and write it out on another thread
+        queue_job([chunks = std::move(recording), path_str]() {
+            std::ofstream o(path_str, std::ios_base::out | std::ios_base::binary | std::ios_base::trunc);
+            for(auto &chunk : chunks) {
+                o.write(reinterpret_cast<const char *>(chunk.data()), chunk.size());
+            }
+            o.close();
+        }, [path_str, ticks]() {
+            console_output(localize("chimera_record_interpolation_command_saved"), ticks, path_str.c_str());
+        });
+        recording = {};
+        recording_size = 0;
+        record = {};
+    }
+
+    bool record_interpolation_command(int argc, const char **argv) noexcept {
+        if(argc) {
+            bool new_enabled = STR_TO_BOOL(argv[0]);
+            if(new_enabled != recording_enabled) {
+                if(new_enabled) {
+                    start_recording();
+                }
+                else {
+                    stop_recording();
+                }
+            }
+        }
+
+        console_output(BOOL_TO_STR(recording_enabled));
+        return true;
+    }
+}
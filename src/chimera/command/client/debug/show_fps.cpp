@@ -4,6 +4,7 @@
 #include "../../../output/draw_text.hpp"
 #include "../../../output/output.hpp"
 #include "../../../command/command.hpp"
+#include "../../../miscellaneous/frame_pacer.hpp"
 #include <chrono>
 
 namespace Chimera {
@@ -64,6 +65,16 @@ namespace Chimera {
         static ColorARGB blue = ColorARGB { 0.7, 0.45, 0.72, 1.0 };
         apply_text(std::move(avg), 100, 0, 100, font_pixel_height(GenericFont::FONT_CONSOLE), blue, GenericFont::FONT_CONSOLE, FontAlignment::ALIGN_RIGHT, TextAnchor::ANCHOR_TOP_RIGHT);
 
+        // Display frame pacing jitter if the frame rate is being throttled
+        auto *pacer = get_throttle_fps_pacer();
+        if(pacer && pacer->statistics().frames > 0) {
+            auto &statistics = pacer->statistics();
+            char jitter[64];
+            std::snprintf(jitter, sizeof(jitter), "%.02f ms, jitter %.02f ms (max %.02f ms)", statistics.mean_ms, statistics.jitter_ms, statistics.max_deviation_ms);
+            auto height = font_pixel_height(GenericFont::FONT_CONSOLE);
+            apply_text(std::string(jitter), 100, height, 300, height, blue, GenericFont::FONT_CONSOLE, FontAlignment::ALIGN_RIGHT, TextAnchor::ANCHOR_TOP_RIGHT);
+        }
+
         last_frame = now;
     }
 }
@@ -112,7 +112,7 @@ namespace Chimera {
             else if(std::strcmp(argv[0], localize("chimera_color_random")) == 0) {
                 chimera_set_color_override = PlayerColor::PLAYER_COLOR_RANDOM;
             }
-            else if(std::strcmp(argv[0], localize("off")) == 0) {
+            else if(std::strcmp(argv[0], "off") == 0) {
                 chimera_set_color_override = 0xFFFFFFFF;
             }
             else {
@@ -2,7 +2,6 @@
 
 #include <windows.h>
 #include <chrono>
-#include <thread>
 
 #include "../../command.hpp"
 #include "../../../signature/hook.hpp"
@@ -10,24 +9,68 @@
 #include "../../../chimera.hpp"
 #include "../../../output/output.hpp"
 #include "../../../event/frame.hpp"
+#include "../../../miscellaneous/frame_pacer.hpp"
 
 namespace Chimera {
     static float max_spf;
-    typedef std::chrono::high_resolution_clock clock;
-    static clock::time_point next_frame;
+    static FramePacer pacer;
+    static bool enabled = false;
+
+    #ifndef CREATE_WAITABLE_TIMER_HIGH_RESOLUTION
+    #define CREATE_WAITABLE_TIMER_HIGH_RESOLUTION 0x00000002
+    #endif
+
+    // Sleep on a waitable timer. Use a high resolution timer if this version of Windows has them since regular timers only wake up on
+    // the system timer tick.
+    static void sleep_for(FramePacer::clock::duration duration) {
+        static HANDLE timer = nullptr;
+        static bool timer_created = false;
+        if(!timer_created) {
+            timer_created = true;
+            typedef HANDLE (WINAPI *CreateWaitableTimerExW_t)(LPSECURITY_ATTRIBUTES, LPCWSTR, DWORD, DWORD);
+            auto create_waitable_timer_ex = reinterpret_cast<CreateWaitableTimerExW_t>(GetProcAddress(GetModuleHandleA("kernel32.dll"), "CreateWaitableTimerExW"));
+            if(create_waitable_timer_ex) {
+                timer = create_waitable_timer_ex(nullptr, nullptr, CREATE_WAITABLE_TIMER_HIGH_RESOLUTION, TIMER_ALL_ACCESS);
+            }
+            if(!timer) {
+                timer = CreateWaitableTimerW(nullptr, TRUE, nullptr);
+            }
+        }
+
+        // Waitable timers use 100 nanosecond units, and negative values are relative
+        LARGE_INTEGER due;
+        due.QuadPart = -static_cast<LONGLONG>(std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count() / 100);
+        if(timer && due.QuadPart < 0 && SetWaitableTimer(timer, &due, 0, nullptr, nullptr, FALSE)) {
+            WaitForSingleObject(timer, INFINITE);
+        }
+        else {
+            Sleep(static_cast<DWORD>(std::chrono::duration_cast<std::chrono::milliseconds>(duration).count()));
+        }
+    }
 
     static void on_preframe() {
-        while(clock::now() < next_frame) {
-            Sleep(0);
+        // Sleep for most of the wait
+        auto sleep_duration = pacer.sleep_duration(FramePacer::clock::now());
+        if(sleep_duration > FramePacer::clock::duration::zero()) {
+            auto before = FramePacer::clock::now();
+            sleep_for(sleep_duration);
+            pacer.record_sleep(sleep_duration, FramePacer::clock::now() - before);
+        }
+
+        // Spin for the rest
+        auto next_frame = pacer.next_frame();
+        while(FramePacer::clock::now() < next_frame) {
+            YieldProcessor();
         }
-        auto duration_to_add = std::chrono::duration<long long, std::micro>(static_cast<long long>(max_spf * 1000000));
-        long long multiplier = 1 + static_cast<long long>((clock::now() - next_frame) / duration_to_add);
-        next_frame += duration_to_add * multiplier;
+
+        pacer.frame_started(FramePacer::clock::now());
     }
 
-    bool throttle_fps_command(int argument_count, const char **arguments) noexcept {
-        static bool enabled = false;
+    const FramePacer *get_throttle_fps_pacer() noexcept {
+        return enabled ? &pacer : nullptr;
+    }
 
+    bool throttle_fps_command(int argument_count, const char **arguments) noexcept {
         if(argument_count) {
             float new_fps = std::strtof(arguments[0], nullptr);
 
@@ -39,7 +82,7 @@ namespace Chimera {
             else {
                 enabled = true;
                 max_spf = 1.0f / new_fps;
-                next_frame = clock::now();
+                pacer.start(std::chrono::duration_cast<FramePacer::clock::duration>(std::chrono::duration<double>(max_spf)), FramePacer::clock::now());
                 add_preframe_event(on_preframe);
             }
         }
@@ -5,22 +5,23 @@
 #include "../../../output/output.hpp"
 #include "../../../event/frame.hpp"
 #include "../../../halo_data/object.hpp"
+#include "../../../halo_data/object_index.hpp"
 
 namespace Chimera {
     static void shrink_empty_weapons() {
         // Get the object table
         auto &object_table = ObjectTable::get_object_table();
 
-        // Go through all objects.
-        for(std::size_t i = 0; i < object_table.max_elements; i++) {
-            // See if the object exists.
-            auto *object = object_table.get_dynamic_object(i);
+        // Go through all weapons that aren't being held.
+        for(auto &object_id : get_object_index().unparented_weapons) {
+            // See if the object still exists.
+            auto *object = object_table.get_dynamic_object(object_id);
             if(!object) {
                 continue;
             }
 
-            // Check if the object isn't visible or is not a weapon or is being held
-            if(object->no_collision || object->type != ObjectType::OBJECT_TYPE_WEAPON || !object->parent.is_null()) {
+            // Check if the object isn't visible or is being held
+            if(object->no_collision || !object->parent.is_null()) {
                 continue;
             }
 
@@ -79,16 +80,12 @@ namespace Chimera {
                 }
             }
 
-            // Next, get the model.
-            auto *model_tag = get_tag(*reinterpret_cast<TagID *>(tag_data + 0x28 + 0xC));
-            if(!model_tag) {
-                continue;
-            }
-            auto node_count = *reinterpret_cast<std::uint32_t *>(model_tag->data + 0xB8);
+            // Next, get the number of nodes.
+            auto node_count = object->node_count();
 
             // Shrink it!
             auto *nodes = object->nodes();
-            for(std::uint32_t i = 0; i < node_count; i++) {
+            for(std::size_t i = 0; i < node_count; i++) {
                 nodes[i].scale = 0.5F;
             }
         }
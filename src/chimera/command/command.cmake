@@ -31,6 +31,9 @@ set(COMMAND_FILES
     ${COMMAND_DIR}/client/custom_chat/chat_block_server_messages.cpp
     ${COMMAND_DIR}/client/custom_chat/chat_color_help.cpp
     ${COMMAND_DIR}/client/debug/budget.cpp
+    ${COMMAND_DIR}/client/debug/event_profile.cpp
+    ${COMMAND_DIR}/client/debug/frame_telemetry.cpp
+    ${COMMAND_DIR}/client/debug/record_interpolation.cpp
     ${COMMAND_DIR}/client/debug/load_ui_map.cpp
     ${COMMAND_DIR}/client/debug/send_chat_message.cpp
     ${COMMAND_DIR}/client/debug/show_coordinates.cpp
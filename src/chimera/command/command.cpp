@@ -1,5 +1,6 @@
 // SPDX-License-Identifier: GPL-3.0-only
 
+#include <algorithm>
 #include <cstring>
 #include <memory>
 #include "../localization/localization.hpp"
@@ -22,6 +23,14 @@ namespace Chimera {
         }
     }
 
+    const char *Command::category() const noexcept {
+        return localize_id(this->p_category);
+    }
+
+    const char *Command::help() const noexcept {
+        return localize_id(this->p_help);
+    }
+
     CommandResult Command::call(const std::vector<std::string> &arguments) const noexcept {
         // Get argument count
         std::size_t arg_count = arguments.size();
@@ -31,128 +40,26 @@ namespace Chimera {
             return this->call(0, nullptr);
         }
 
-        // Make our array
-        auto arguments_alloc(std::make_unique<const char *[]>(arg_count));
+        // Make our array, only allocating if there are a lot of arguments
+        const char *arguments_stack[16];
+        std::unique_ptr<const char *[]> arguments_alloc;
+        const char **arguments_array = arguments_stack;
+        if(arg_count > sizeof(arguments_stack) / sizeof(*arguments_stack)) {
+            arguments_alloc = std::make_unique<const char *[]>(arg_count);
+            arguments_array = arguments_alloc.get();
+        }
         for(std::size_t i = 0; i < arg_count; i++) {
-            arguments_alloc[i] = arguments[i].data();
+            arguments_array[i] = arguments[i].data();
         }
 
         // Do it!
-        return this->call(arg_count, arguments_alloc.get());
-    }
-
-    std::vector<std::string> split_arguments(const char *command) noexcept {
-        // This is the vector to return.
-        std::vector<std::string> arguments;
-
-        // This value will be true if we are inside quotes, during which the word will not separate into arguments.
-        bool in_quotes = false;
-
-        // If using a backslash, add the next character to the string regardless of what it is.
-        bool escape_character = false;
-
-        // Regardless of if there were any characters, there was an argument.
-        bool allow_empty_argument = false;
-
-        // Get the command
-        std::size_t command_size = std::strlen(command);
-
-        // Get the argument
-        std::string argument;
-        for(std::size_t i = 0; i < command_size; i++) {
-            if(escape_character) {
-                escape_character = false;
-            }
-            // Escape character - this will be used to include the next character regardless of what it is
-            else if(command[i] == '\\') {
-                escape_character = true;
-                continue;
-            }
-            // If a whitespace or octotothorpe is in quotations in the argument, then it is considered part of the argument.
-            else if(command[i] == '"') {
-                in_quotes = !in_quotes;
-                allow_empty_argument = true;
-                continue;
-            }
-            else if((command[i] == ' ' || command[i] == '\r' || command[i] == '\n' || command[i] == '#') && !in_quotes) {
-                // Add argument if not empty.
-                if(argument != "" || allow_empty_argument) {
-                    arguments.push_back(argument);
-                    argument = "";
-                    allow_empty_argument = false;
-                }
-
-                // Terminate if beginning a comment.
-                if(command[i] == '#') {
-                    break;
-                }
-                continue;
-            }
-            argument += command[i];
-        }
-
-        // Add the last argument.
-        if(argument != "" || allow_empty_argument) {
-            arguments.push_back(argument);
-        }
-
-        return arguments;
-    }
-
-    std::string unsplit_arguments(const std::vector<std::string> &arguments) noexcept {
-        // This is the string to return.
-        std::string unsplit;
-
-        for(std::size_t i = 0; i < arguments.size(); i++) {
-            // This is a reference to the argument we're dealing with.
-            const std::string &argument = arguments[i];
-
-            // This will be the final string we append to the unsplit string.
-            std::string argument_final;
-
-            // Set this to true if we need to surround this argument with quotes.
-            bool surround_with_quotes = false;
-
-            // Go through each character and add them one-by-one to argument_final.
-            for(const char &c : argument) {
-                switch(c) {
-                    // Backslashes and quotation marks should be escaped.
-                    case '\\':
-                    case '"':
-                        argument_final += '\\';
-                        break;
-
-                    // If we're using spaces or octothorpes, the argument should be surrounded with quotation marks. We could escape those, but this is more readable.
-                    case '#':
-                    case ' ':
-                        surround_with_quotes = true;
-                        break;
-
-                    default:
-                        break;
-                }
-                argument_final += c;
-            }
-
-            if(surround_with_quotes) {
-                argument_final = std::string("\"") + argument_final + "\"";
-            }
-
-            unsplit += argument_final;
-
-            // Add the space to separate the next argument.
-            if(i + 1 < arguments.size()) {
-                unsplit += " ";
-            }
-        }
-
-        return unsplit;
+        return this->call(arg_count, arguments_array);
     }
 
-    Command::Command(const char *name, const char *category, const char *feature, const char *help, CommandFunction function, bool autosave, std::size_t min_args, std::size_t max_args) :
+    Command::Command(const char *name, LocalizationID category, const char *feature, LocalizationID help, CommandFunction function, bool autosave, std::size_t min_args, std::size_t max_args) :
         p_name(name), p_category(category), p_feature(feature), p_help(help), p_function(function), p_autosave(autosave), p_min_args(min_args), p_max_args(max_args) {}
 
-    Command::Command(const char *name, const char *category, const char *feature, const char *help, CommandFunction function, bool autosave, std::size_t args) : Command(name, category, feature, help, function, autosave, args, args) {}
+    Command::Command(const char *name, LocalizationID category, const char *feature, LocalizationID help, CommandFunction function, bool autosave, std::size_t args) : Command(name, category, feature, help, function, autosave, args, args) {}
 
     void Chimera::get_all_commands() noexcept {
         this->p_commands.clear();
@@ -160,11 +67,11 @@ namespace Chimera {
         #define ADD_COMMAND(name, category, feature, command_fn, autosave, ...) \
             extern bool command_fn(int, const char **); \
             static_assert(autosave == false || autosave == true, "autosave value is not a boolean"); \
-            this->p_commands.emplace_back(name, localize(category), feature, localize(name "_command_help"), command_fn, autosave, __VA_ARGS__);
+            this->p_commands.emplace_back(name, LOCALIZATION_ID(category), feature, LOCALIZATION_ID(name "_command_help"), command_fn, autosave, __VA_ARGS__);
 
         // Chimera-specific commands
-        this->p_commands.emplace_back("chimera", localize("chimera_category_core"), "core", localize("chimera_command_help"), Chimera::chimera_command, false, 0, 1);
-        this->p_commands.emplace_back("chimera_signature_info", localize("chimera_category_core"), "core", localize("chimera_signature_info_command_help"), Chimera::signature_info_command, false, 1, 1);
+        this->p_commands.emplace_back("chimera", LOCALIZATION_ID("chimera_category_core"), "core", LOCALIZATION_ID("chimera_command_help"), Chimera::chimera_command, false, 0, 1);
+        this->p_commands.emplace_back("chimera_signature_info", LOCALIZATION_ID("chimera_category_core"), "core", LOCALIZATION_ID("chimera_signature_info_command_help"), Chimera::signature_info_command, false, 1, 1);
         ADD_COMMAND("chimera_about", "chimera_category_core", "core", about_command, true, 0, 0);
         ADD_COMMAND("chimera_language", "chimera_category_core", "core", language_command, true, 0, 1);
         ADD_COMMAND("chimera_chat_color_help", "chimera_category_custom_chat", "client_custom_chat", chat_color_help_command, true, 0, 1);
@@ -173,6 +80,9 @@ namespace Chimera {
 
         // Debug
         ADD_COMMAND("chimera_budget", "chimera_category_debug", "client", budget_command, true, 0, 1);
+        ADD_COMMAND("chimera_event_profile", "chimera_category_debug", "client", event_profile_command, false, 0, 1);
+        ADD_COMMAND("chimera_frame_telemetry", "chimera_category_debug", "client", frame_telemetry_command, false, 0, 1);
+        ADD_COMMAND("chimera_record_interpolation", "chimera_category_debug", "client", record_interpolation_command, false, 0, 1);
 
         if(this->feature_present("core_devmode_retail")) {
             ADD_COMMAND("chimera_devmode", "chimera_category_debug", "core_devmode_retail", devmode_retail_command, true, 0, 1);
@@ -193,7 +103,7 @@ namespace Chimera {
         ADD_COMMAND("chimera_map_info", "chimera_category_debug", "client", map_info_command, false, 0, 0);
 
         // Enhancements
-        this->p_commands.emplace_back("chimera_block_all_bullshit", localize("chimera_category_enhancement"), "client", localize("chimera_block_all_bullshit_help"), Chimera::block_all_bullshit_command, false, 0, 0);
+        this->p_commands.emplace_back("chimera_block_all_bullshit", LOCALIZATION_ID("chimera_category_enhancement"), "client", LOCALIZATION_ID("chimera_block_all_bullshit_help"), Chimera::block_all_bullshit_command, false, 0, 0);
         ADD_COMMAND("chimera_block_buffering", "chimera_category_enhancement", "client_disable_buffering", block_buffering_command, true, 0, 1);
         ADD_COMMAND("chimera_block_extra_weapon", "chimera_category_enhancement", "client_block_extra_weapon", block_extra_weapon_command, false, 0, 0);
         ADD_COMMAND("chimera_unblock_all_extra_weapons", "chimera_category_enhancement", "client_block_extra_weapon", unblock_all_extra_weapons_command, false, 0, 0);
@@ -255,5 +165,63 @@ namespace Chimera {
         ADD_COMMAND("chimera_bookmark_delete", "chimera_category_bookmark", "client", bookmark_delete_command, false, 0, 1);
         ADD_COMMAND("chimera_history_list", "chimera_category_bookmark", "client", history_list_command, false, 0, 0);
         ADD_COMMAND("chimera_history_connect", "chimera_category_bookmark", "client", history_connect_command, false, 1, 1);
+
+        this->index_commands();
+    }
+
+    void Chimera::index_commands() {
+        this->p_command_index.clear();
+        this->p_commands_by_name.clear();
+        this->p_command_categories.clear();
+
+        for(auto &command : this->p_commands) {
+            this->p_command_index.emplace(command.name(), &command - this->p_commands.data());
+            this->p_commands_by_name.push_back(&command);
+        }
+
+        auto by_name = [](const Command *a, const Command *b) { return std::strcmp(a->name(), b->name()) < 0; };
+        std::sort(this->p_commands_by_name.begin(), this->p_commands_by_name.end(), by_name);
+
+        // Going through the sorted list keeps each category sorted, too
+        for(auto *command : this->p_commands_by_name) {
+            auto id = command->category_id();
+            auto category = std::find_if(this->p_command_categories.begin(), this->p_command_categories.end(), [&id](const CommandCategory &c) { return c.id == id; });
+            if(category == this->p_command_categories.end()) {
+                this->p_command_categories.push_back(CommandCategory { id, { command } });
+            }
+            else {
+                category->commands.push_back(command);
+            }
+        }
+    }
+
+    const Command *Chimera::find_command(const char *name) const noexcept {
+        auto index = this->p_command_index.find(name);
+        if(index == this->p_command_index.end()) {
+            return nullptr;
+        }
+        return &this->p_commands[index->second];
+    }
+
+    const std::vector<const Command *> &Chimera::get_commands_by_name() const noexcept {
+        return this->p_commands_by_name;
+    }
+
+    std::pair<std::size_t, std::size_t> Chimera::find_commands_with_prefix(const char *prefix) const noexcept {
+        std::size_t prefix_length = std::strlen(prefix);
+        auto &commands = this->p_commands_by_name;
+
+        // Everything with the prefix is in one run since the list is sorted
+        auto first = std::lower_bound(commands.begin(), commands.end(), prefix, [&prefix_length](const Command *command, const char *prefix) {
+            return std::strncmp(command->name(), prefix, prefix_length) < 0;
+        });
+        auto last = std::upper_bound(first, commands.end(), prefix, [&prefix_length](const char *prefix, const Command *command) {
+            return std::strncmp(prefix, command->name(), prefix_length) < 0;
+        });
+        return std::pair(first - commands.begin(), last - commands.begin());
+    }
+
+    const std::vector<CommandCategory> &Chimera::get_command_categories() const noexcept {
+        return this->p_command_categories;
     }
 }
@@ -4,9 +4,13 @@
 #define CHIMERA_COMMAND_HPP
 
 #include <cstring>
+#include <memory>
 #include <vector>
 #include <string>
 
+#include "../localization/localization_id.hpp"
+#include "split_arguments.hpp"
+
 namespace Chimera {
     #define BOOL_TO_STR(boolean) (boolean ? "true" : "false")
     #define STR_TO_BOOL(str) (std::strcmp(str, "1") == 0 || std::strcmp(str, "true") == 0)
@@ -65,19 +69,23 @@ namespace Chimera {
 
         /**
          * Get the category of the command
-         * @return pointer to the category of the command
+         * @return pointer to the localized category of the command
+         */
+        const char *category() const noexcept;
+
+        /**
+         * Get the localization ID of the category of the command
+         * @return localization ID of the category of the command
          */
-        const char *category() const noexcept {
+        LocalizationID category_id() const noexcept {
             return this->p_category;
         }
 
         /**
          * Get the help of the command
-         * @return pointer to the help of the command
+         * @return pointer to the localized help of the command
          */
-        const char *help() const noexcept {
-            return this->p_help;
-        }
+        const char *help() const noexcept;
 
         /**
          * Get the minimum arguments of the command
@@ -121,40 +129,40 @@ namespace Chimera {
         /**
          * Instantiate a command
          * @param name     name of the command
-         * @param category category of the command
+         * @param category localization ID of the category of the command
          * @param feature  feature of the command
-         * @param help     help info of the command
+         * @param help     localization ID of the help info of the command
          * @param function function pointer of the command
          * @param autosave auto saves if successful and at least 1 arg was passed
          * @param min_args minimum arguments
          * @param max_args maximum arguments
          */
-        Command(const char *name, const char *category, const char *feature, const char *help, CommandFunction function, bool autosave, std::size_t min_args, std::size_t max_args);
+        Command(const char *name, LocalizationID category, const char *feature, LocalizationID help, CommandFunction function, bool autosave, std::size_t min_args, std::size_t max_args);
 
         /**
          * Instantiate a command
          * @param name     name of the command
-         * @param category category of the command
+         * @param category localization ID of the category of the command
          * @param feature  feature of the command
-         * @param help     help info of the command
+         * @param help     localization ID of the help info of the command
          * @param function function pointer of the command
          * @param autosave auto saves if successful and at least 1 arg was passed
          * @param args     required number of arguments
          */
-        Command(const char *name, const char *category, const char *feature, const char *help, CommandFunction function, bool autosave, std::size_t args = 0);
+        Command(const char *name, LocalizationID category, const char *feature, LocalizationID help, CommandFunction function, bool autosave, std::size_t args = 0);
 
     private:
         /** Name of the command */
         const char *p_name;
 
-        /** Category of the command */
-        const char *p_category;
+        /** Localization ID of the category of the command */
+        LocalizationID p_category;
 
         /** Feature required for the command */
         const char *p_feature;
 
-        /** Help of the command */
-        const char *p_help;
+        /** Localization ID of the help of the command */
+        LocalizationID p_help;
 
         /** Function to call for the command */
         CommandFunction p_function;
@@ -170,18 +178,15 @@ namespace Chimera {
     };
 
     /**
-     * Split the arguments
-     * @param command arguments to split
-     * @return        vector of split arguments
+     * Commands that share a category
      */
-    std::vector<std::string> split_arguments(const char *command) noexcept;
+    struct CommandCategory {
+        /** Localization ID of the category */
+        LocalizationID id;
 
-    /**
-     * Unsplit the arguments
-     * @param  arguments arguments to unsplit
-     * @return           combined arguments
-     */
-    std::string unsplit_arguments(const std::vector<std::string> &arguments) noexcept;
+        /** Commands in the category sorted by name */
+        std::vector<const Command *> commands;
+    };
 }
 
 #endif
@@ -12,7 +12,7 @@ namespace Chimera {
         if(argc) {
             bool found = false;
             for(Language l = static_cast<Language>(0); l < Language::CHIMERA_LANGUAGE_COUNT; l = static_cast<Language>(l + 1)) {
-                if(std::strcmp(localize("chimera_language_shortened_name", l), argv[0]) == 0) {
+                if(std::strcmp(localize_id(LOCALIZATION_ID("chimera_language_shortened_name"), l), argv[0]) == 0) {
                     get_chimera().set_language(l);
                     found = true;
                 }
@@ -33,7 +33,7 @@ namespace Chimera {
                 if(l == Language::CHIMERA_LANGUAGE_VAP) {
                     continue;
                 }
-                console_output(ConsoleColor::body_color(), "  - %s", localize("chimera_language_shortened_name", l));
+                console_output(ConsoleColor::body_color(), "  - %s", localize_id(LOCALIZATION_ID("chimera_language_shortened_name"), l));
             }
 
             output_prefix = old_prefix;
@@ -6,6 +6,7 @@
 #include "../../../output/output.hpp"
 #include "../../../chimera.hpp"
 #include "../../../signature/signature.hpp"
+#include "../../../signature/hook.hpp"
 #include "../../../halo_data/path.hpp"
 #include "../../command.hpp"
 
@@ -64,6 +65,44 @@ namespace Chimera {
 
             return true;
         }
+
+        // Or maybe we want to dump all of the hooks
+        if(std::strcmp(*argv, "hooks") == 0) {
+            char path[MAX_PATH];
+            std::snprintf(path, sizeof(path), "%schimera_hook_dump.csv", get_chimera().get_path());
+            std::ofstream o(path, std::ios_base::out | std::ios_base::trunc);
+            char line[256];
+
+            std::snprintf(line, sizeof(line), DUMP_FMT, "Address", "Trampoline", "Size", "Code");
+            o << line;
+
+            for(auto *hook : get_active_hooks()) {
+                char address[256];
+                char trampoline[256];
+                char size[256];
+                std::snprintf(address, sizeof(address), "0x%.08X", reinterpret_cast<std::uintptr_t>(hook->address));
+                std::snprintf(trampoline, sizeof(trampoline), "0x%.08X", reinterpret_cast<std::uintptr_t>(hook->hook));
+                std::snprintf(size, sizeof(size), "%zu", hook->hook_size);
+
+                // Write the code as hex
+                std::string code;
+                for(std::size_t i = 0; i < hook->hook_size; i++) {
+                    char byte[4];
+                    std::snprintf(byte, sizeof(byte), "%02X", static_cast<std::uint8_t>(hook->hook[i]));
+                    code += byte;
+                }
+
+                o << address << "," << trampoline << "," << size << "," << code << "\n";
+            }
+
+            o.flush();
+            o.close();
+
+            console_output(localize("chimera_signature_info_command_dumped_hooks"), path);
+
+            return true;
+        }
+
         for(auto &sig : get_chimera().p_signatures) {
             if(std::strcmp(sig.name(), *argv) == 0) {
                 extern const char *output_prefix;
@@ -7,25 +7,21 @@
 #include "../../../signature/hook.hpp"
 #include "../../../event/tick.hpp"
 #include "../../../halo_data/object.hpp"
+#include "../../../halo_data/object_index.hpp"
 #include "../../../halo_data/multiplayer.hpp"
 
 namespace Chimera {
     static void on_tick() noexcept {
         if(server_type() == ServerType::SERVER_LOCAL) {
             auto &object_table = ObjectTable::get_object_table();
-            for(std::size_t i = 0; i < object_table.current_size; i++) {
-                // First, does the object exist?
-                auto *object = object_table.get_dynamic_object(i);
+            for(auto &object_id : get_object_index().unparented_weapons) {
+                // First, does the object still exist?
+                auto *object = object_table.get_dynamic_object(object_id);
                 if(!object) {
                     continue;
                 }
 
-                // Next, is it a weapon?
-                if(object->type != ObjectType::OBJECT_TYPE_WEAPON) {
-                    continue;
-                }
-
-                // Next, is this owned by anything?
+                // Next, is this still not owned by anything?
                 if(!object->parent.is_null()) {
                     continue;
                 }
@@ -88,7 +84,7 @@ namespace Chimera {
 
                 // We can delete it if its battery is empty or its ammo is empty
                 if((!uses_battery || empty_battery) && (empty_ammo || !uses_ammo)) {
-                    delete_object(object->full_object_id());
+                    delete_object(object_id);
                 }
             }
         }
@@ -0,0 +1,140 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include <cstring>
+#include "split_arguments.hpp"
+
+namespace Chimera {
+    void SplitArguments::add_argument(const char *argument) {
+        // Move to the heap if we're out of room
+        if(this->p_count == INLINE_ARGUMENT_COUNT) {
+            this->p_heap_argv.assign(this->p_inline_argv, this->p_inline_argv + INLINE_ARGUMENT_COUNT);
+        }
+        if(this->p_count >= INLINE_ARGUMENT_COUNT) {
+            this->p_heap_argv.push_back(argument);
+            this->p_argv = this->p_heap_argv.data();
+        }
+        else {
+            this->p_inline_argv[this->p_count] = argument;
+        }
+        this->p_count++;
+    }
+
+    SplitArguments::SplitArguments(const char *command) noexcept {
+        // Get the command
+        std::size_t command_size = std::strlen(command);
+
+        // Unescaping never makes anything longer, and every argument but the last one replaces a separator with its null terminator, so
+        // this is always big enough.
+        char *buffer = this->p_inline_buffer;
+        if(command_size + 1 > sizeof(this->p_inline_buffer)) {
+            this->p_heap_buffer = std::make_unique<char []>(command_size + 1);
+            buffer = this->p_heap_buffer.get();
+        }
+
+        // This value will be true if we are inside quotes, during which the word will not separate into arguments.
+        bool in_quotes = false;
+
+        // If using a backslash, add the next character to the string regardless of what it is.
+        bool escape_character = false;
+
+        // Regardless of if there were any characters, there was an argument.
+        bool allow_empty_argument = false;
+
+        // Get the argument
+        char *argument = buffer;
+        char *argument_end = buffer;
+        for(std::size_t i = 0; i < command_size; i++) {
+            if(escape_character) {
+                escape_character = false;
+            }
+            // Escape character - this will be used to include the next character regardless of what it is
+            else if(command[i] == '\\') {
+                escape_character = true;
+                continue;
+            }
+            // If a whitespace or octotothorpe is in quotations in the argument, then it is considered part of the argument.
+            else if(command[i] == '"') {
+                in_quotes = !in_quotes;
+                allow_empty_argument = true;
+                continue;
+            }
+            else if((command[i] == ' ' || command[i] == '\r' || command[i] == '\n' || command[i] == '#') && !in_quotes) {
+                // Add argument if not empty.
+                if(argument_end != argument || allow_empty_argument) {
+                    *(argument_end++) = 0;
+                    this->add_argument(argument);
+                    argument = argument_end;
+                    allow_empty_argument = false;
+                }
+
+                // Terminate if beginning a comment.
+                if(command[i] == '#') {
+                    break;
+                }
+                continue;
+            }
+            *(argument_end++) = command[i];
+        }
+
+        // Add the last argument.
+        if(argument_end != argument || allow_empty_argument) {
+            *(argument_end++) = 0;
+            this->add_argument(argument);
+        }
+    }
+
+    std::vector<std::string> split_arguments(const char *command) noexcept {
+        SplitArguments split(command);
+        return std::vector<std::string>(split.argv(), split.argv() + split.size());
+    }
+
+    std::string unsplit_arguments(const std::vector<std::string> &arguments) noexcept {
+        // This is the string to return.
+        std::string unsplit;
+
+        for(std::size_t i = 0; i < arguments.size(); i++) {
+            // This is a reference to the argument we're dealing with.
+            const std::string &argument = arguments[i];
+
+            // This will be the final string we append to the unsplit string.
+            std::string argument_final;
+
+            // Set this to true if we need to surround this argument with quotes.
+            bool surround_with_quotes = false;
+
+            // Go through each character and add them one-by-one to argument_final.
+            for(const char &c : argument) {
+                switch(c) {
+                    // Backslashes and quotation marks should be escaped.
+                    case '\\':
+                    case '"':
+                        argument_final += '\\';
+                        break;
+
+                    // If we're using spaces or octothorpes, the argument should be surrounded with quotation marks. We could escape those, but this is more readable.
+                    case '#':
+                    case ' ':
+                        surround_with_quotes = true;
+                        break;
+
+                    default:
+                        break;
+                }
+                argument_final += c;
+            }
+
+            if(surround_with_quotes) {
+                argument_final = std::string("\"") + argument_final + "\"";
+            }
+
+            unsplit += argument_final;
+
+            // Add the space to separate the next argument.
+            if(i + 1 < arguments.size()) {
+                unsplit += " ";
+            }
+        }
+
+        return unsplit;
+    }
+}
@@ -0,0 +1,103 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#ifndef CHIMERA_SPLIT_ARGUMENTS_HPP
+#define CHIMERA_SPLIT_ARGUMENTS_HPP
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace Chimera {
+    /**
+     * Arguments split from a command. The arguments are unescaped into one buffer, and short commands don't allocate anything.
+     */
+    class SplitArguments {
+    public:
+        /**
+         * Get the number of arguments
+         * @return number of arguments
+         */
+        std::size_t size() const noexcept {
+            return this->p_count;
+        }
+
+        /**
+         * Get an argument
+         * @param  index index of the argument
+         * @return       null-terminated argument
+         */
+        const char *operator[](std::size_t index) const noexcept {
+            return this->p_argv[index];
+        }
+
+        /**
+         * Get an argument that can be modified in place
+         * @param  index index of the argument
+         * @return       null-terminated argument
+         */
+        char *argument(std::size_t index) noexcept {
+            return const_cast<char *>(this->p_argv[index]);
+        }
+
+        /**
+         * Get all of the arguments
+         * @return array of size() arguments
+         */
+        const char **argv() noexcept {
+            return this->p_argv;
+        }
+
+        /**
+         * Split the arguments the same way split_arguments() does
+         * @param command arguments to split
+         */
+        SplitArguments(const char *command) noexcept;
+
+        SplitArguments(const SplitArguments &copy) = delete;
+
+    private:
+        /** Commands up to this long (including the null terminator) are unescaped into p_inline_buffer */
+        static constexpr std::size_t INLINE_BUFFER_SIZE = 256;
+
+        /** Up to this many arguments are kept in p_inline_argv */
+        static constexpr std::size_t INLINE_ARGUMENT_COUNT = 16;
+
+        char p_inline_buffer[INLINE_BUFFER_SIZE];
+        const char *p_inline_argv[INLINE_ARGUMENT_COUNT];
+
+        /** Used for longer commands */
+        std::unique_ptr<char []> p_heap_buffer;
+
+        /** Used for commands with more arguments */
+        std::vector<const char *> p_heap_argv;
+
+        /** Arguments */
+        const char **p_argv = p_inline_argv;
+
+        /** Number of arguments */
+        std::size_t p_count = 0;
+
+        /**
+         * Add an argument
+         * @param argument argument to add
+         */
+        void add_argument(const char *argument);
+    };
+
+    /**
+     * Split the arguments
+     * @param command arguments to split
+     * @return        vector of split arguments
+     */
+    std::vector<std::string> split_arguments(const char *command) noexcept;
+
+    /**
+     * Unsplit the arguments
+     * @param  arguments arguments to unsplit
+     * @return           combined arguments
+     */
+    std::string unsplit_arguments(const std::vector<std::string> &arguments) noexcept;
+}
+
+#endif
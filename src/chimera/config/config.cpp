@@ -2,47 +2,162 @@
 
 #include <cstring>
 #include <fstream>
+#include <future>
+#include <memory>
 #include "../localization/localization.hpp"
 #include "../version.hpp"
 #include "../command/command.hpp"
 #include "../output/output.hpp"
 #include "../chimera.hpp"
+#include "../event/frame.hpp"
+#include "../job/job.hpp"
 #include "config.hpp"
 
 namespace Chimera {
+    // Wait this long after the last change before saving so a burst of changes only gets written once
+    #define CONFIG_SAVE_DELAY std::chrono::milliseconds(1000)
+
+    // ...but don't put off saving for longer than this
+    #define CONFIG_SAVE_MAX_DELAY std::chrono::milliseconds(5000)
+
+    // Config with unsaved changes, if any
+    static Config *pending_config = nullptr;
+
+    // Background writes that haven't finished yet
+    static std::size_t writes_in_flight = 0;
+
+    // Path and contents of the last background write. These are kept until it finishes so flush_config() can write them again if the
+    // process exits before then.
+    static std::string unfinished_write_path;
+    static std::string unfinished_write_data;
+
+    // This becomes ready once the last background write is done writing, whether or not its completion has run yet
+    static std::shared_future<void> unfinished_write_done;
+
+    static void save_pending_config() noexcept {
+        if(pending_config) {
+            pending_config->save_if_due();
+        }
+    }
+
+    // Write to a temporary file and then move it over the config file so a crash or a full disk never leaves a half-written config
+    static bool write_config_file(const std::string &path, const std::string &data, const char *temp_suffix) {
+        std::string temp_path = path + temp_suffix;
+        std::ofstream config(temp_path, std::ios_base::out | std::ios_base::trunc);
+        config.write(data.data(), data.size());
+        config.flush();
+        bool written = config.good();
+        config.close();
+
+        if(!written || !MoveFileEx(temp_path.data(), path.data(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH)) {
+            DeleteFile(temp_path.data());
+            return false;
+        }
+        return true;
+    }
+
     const std::vector<std::string> *Config::get_settings_for_command(const char *command) const {
-        for(auto &c : this->p_settings) {
-            if(std::strcmp(c.first.data(), command) == 0) {
-                return &c.second;
-            }
+        auto setting = this->p_settings_index.find(command);
+        if(setting == this->p_settings_index.end()) {
+            return nullptr;
         }
-        return nullptr;
+        return &setting->second->settings;
     }
 
     void Config::set_settings_for_command(const char *command, const std::vector<std::string> &settings) {
-        for(auto &c : this->p_settings) {
-            if(std::strcmp(c.first.data(), command) == 0) {
-                if(c.second == settings) {
-                    return;
-                }
-                this->p_settings.erase(this->p_settings.begin() + (&c - this->p_settings.data()));
-                break;
+        // Update it in place so the order in the file stays the same
+        auto line = unsplit_arguments(split_arguments(command)) + " " + unsplit_arguments(settings);
+        auto existing = this->p_settings_index.find(command);
+        if(existing != this->p_settings_index.end()) {
+            auto &setting = *existing->second;
+            if(setting.settings == settings) {
+                return;
             }
+            setting.settings = settings;
+            setting.line = std::move(line);
+        }
+        else {
+            auto &setting = this->p_settings.emplace_back(Setting { command, settings, std::move(line) });
+            this->p_settings_index.emplace(setting.command, &setting);
         }
-        this->p_settings.emplace_back(command, settings);
 
         if(this->p_saving) {
+            // Save once things settle down rather than right now
+            auto now = std::chrono::steady_clock::now();
+            if(!this->p_dirty) {
+                this->p_dirty = true;
+                this->p_dirty_since = now;
+                pending_config = this;
+                add_preframe_event(save_pending_config);
+            }
+            this->p_changed_at = now;
+        }
+    }
+
+    void Config::save_if_due() {
+        if(!this->p_dirty) {
+            return;
+        }
+
+        // Wait for the last write to finish so they can't land out of order
+        if(writes_in_flight) {
+            return;
+        }
+
+        auto now = std::chrono::steady_clock::now();
+        if(now - this->p_changed_at < CONFIG_SAVE_DELAY && now - this->p_dirty_since < CONFIG_SAVE_MAX_DELAY) {
+            return;
+        }
+
+        this->p_dirty = false;
+        pending_config = nullptr;
+        remove_preframe_event(save_pending_config);
+
+        writes_in_flight++;
+        unfinished_write_path = this->p_path;
+        unfinished_write_data = this->serialize();
+        auto done = std::make_shared<std::promise<void>>();
+        unfinished_write_done = done->get_future().share();
+        queue_job([path = unfinished_write_path, data = unfinished_write_data, done]() {
+            write_config_file(path, data, ".tmp");
+            done->set_value();
+        }, []() {
+            if(--writes_in_flight == 0) {
+                unfinished_write_path.clear();
+                unfinished_write_data.clear();
+            }
+        });
+    }
+
+    void Config::flush() {
+        if(this->p_dirty) {
             this->save();
         }
     }
 
     void Config::save() {
-        // Open
-        std::ofstream config(this->p_path, std::ios_base::out | std::ios_base::trunc);
+        // Let any background write land first so it can't overwrite this one. Only wait for the write itself; its completion runs
+        // whenever it normally would.
+        if(writes_in_flight) {
+            unfinished_write_done.wait();
+        }
+
+        this->p_dirty = false;
+        if(pending_config == this) {
+            pending_config = nullptr;
+            remove_preframe_event(save_pending_config);
+        }
+
+        // Use a different temporary file than background saves in case one was cut off
+        write_config_file(this->p_path, this->serialize(), ".save.tmp");
+    }
+
+    std::string Config::serialize() const {
+        std::string config;
 
         // Set header
-        config << "################################################################################\n";
-        config << "#                                                                              #\n";
+        config += "################################################################################\n";
+        config += "#                                                                              #\n";
 
         // Here's a thing
         LARGE_INTEGER pc;
@@ -73,20 +188,21 @@ namespace Chimera {
         }
         std::snprintf(saved_with_line + LEN/2, sizeof(saved_with_line) - LEN/2, "%36s   #", random_text);
 
-        config << saved_with_line << "\n";
-        config << "# ---------------------------------------------------------------------------- #\n";
-        config << localize("chimera_config_note") << "\n";
-        config << "#                                                                              #\n";
-        config << "################################################################################\n\n";
+        config += saved_with_line;
+        config += "\n";
+        config += "# ---------------------------------------------------------------------------- #\n";
+        config += localize("chimera_config_note");
+        config += "\n";
+        config += "#                                                                              #\n";
+        config += "################################################################################\n\n";
 
         // Set settings
         for(auto &c : this->p_settings) {
-            config << unsplit_arguments(split_arguments(c.first.data())) << " " << unsplit_arguments(c.second) << "\n";
+            config += c.line;
+            config += "\n";
         }
 
-        // Flush
-        config.flush();
-        config.close();
+        return config;
     }
 
     void Config::load() {
@@ -94,20 +210,35 @@ namespace Chimera {
         std::ifstream config(this->p_path, std::ios_base::in);
         std::string line;
         std::size_t line_count = 0;
+        auto &chimera = get_chimera();
+
         while(std::getline(config, line)) {
             line_count++;
             #define SHOW_ERROR(...) console_error(localize("chimera_error_config"), this->p_path.data()); \
                                     console_error("    %zu: %s", line_count, line.data()); \
                                     console_error(__VA_ARGS__);
 
-            const Command *command;
-            switch(get_chimera().execute_command(line.data(), &command, true)) {
+            SplitArguments arguments(line.data());
+            if(arguments.size() == 0) {
+                continue;
+            }
+
+            // Get the command name and lowercase it
+            for(char *c = arguments.argument(0); *c; c++) {
+                *c = std::tolower(*c);
+            }
+
+            const Command *command = chimera.find_command(arguments[0]);
+            if(!command) {
+                SHOW_ERROR(localize("chimera_error_command_not_found"));
+                continue;
+            }
+
+            switch(chimera.call_command(*command, arguments.size() - 1, arguments.argv() + 1, true)) {
                 case CommandResult::COMMAND_RESULT_SUCCESS:
                     break;
                 case CommandResult::COMMAND_RESULT_FAILED_ERROR_NOT_FOUND:
-                    if(split_arguments(line.data()).size()) {
-                        SHOW_ERROR(localize("chimera_error_command_not_found"));
-                    }
+                    SHOW_ERROR(localize("chimera_error_command_not_found"));
                     break;
                 case CommandResult::COMMAND_RESULT_FAILED_ERROR:
                     SHOW_ERROR(localize("chimera_error_command_error"), command->name());
@@ -127,4 +258,23 @@ namespace Chimera {
     }
 
     Config::Config(const char *path) : p_path(path) {}
+
+    Config::~Config() {
+        this->flush();
+    }
+
+    void flush_config() {
+        // The process is exiting, so the worker threads are gone and a background write may have been cut off. Write it again, and don't
+        // wait on the workers since they'll never finish.
+        if(writes_in_flight) {
+            write_config_file(unfinished_write_path, unfinished_write_data, ".save.tmp");
+            writes_in_flight = 0;
+            unfinished_write_path.clear();
+            unfinished_write_data.clear();
+        }
+
+        if(pending_config) {
+            pending_config->flush();
+        }
+    }
 }
@@ -3,8 +3,12 @@
 #ifndef CHIMERA_CONFIG_HPP
 #define CHIMERA_CONFIG_HPP
 
+#include <chrono>
+#include <deque>
 #include <vector>
 #include <string>
+#include <string_view>
+#include <unordered_map>
 
 namespace Chimera {
     class Config {
@@ -31,9 +35,15 @@ namespace Chimera {
             this->p_saving = saving;
         }
 
-        /** Save */
+        /** Save now, blocking until the file is written */
         void save();
 
+        /** Save now if there are unsaved changes */
+        void flush();
+
+        /** Save in the background if there are unsaved changes and nothing has changed for a bit */
+        void save_if_due();
+
         /** Load */
         void load();
 
@@ -43,16 +53,54 @@ namespace Chimera {
          */
         Config(const char *path);
 
+        Config(const Config &copy) = delete;
+
+        ~Config();
+
     private:
+        struct Setting {
+            /** Command name */
+            std::string command;
+
+            /** Arguments */
+            std::vector<std::string> settings;
+
+            /** Line to write to the config file */
+            std::string line;
+        };
+
         /** Path of the config file */
         std::string p_path;
 
-        /** Settings (command, settings pair) */
-        std::vector<std::pair<std::string, std::vector<std::string>>> p_settings;
+        /** Settings in the order they were first set. This is a deque so elements (and index keys pointing to them) never move. */
+        std::deque<Setting> p_settings;
+
+        /** Settings by command name */
+        std::unordered_map<std::string_view, Setting *> p_settings_index;
 
         /** Saving is enabled */
         bool p_saving = false;
+
+        /** Settings changed since the last save */
+        bool p_dirty = false;
+
+        /** When the first unsaved change was made */
+        std::chrono::steady_clock::time_point p_dirty_since;
+
+        /** When the last unsaved change was made */
+        std::chrono::steady_clock::time_point p_changed_at;
+
+        /**
+         * Write the config file into a string
+         * @return contents of the config file
+         */
+        std::string serialize() const;
     };
+
+    /**
+     * Save any config with unsaved changes now. This is called when the process exits.
+     */
+    void flush_config();
 }
 
 #endif
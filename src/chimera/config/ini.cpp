@@ -1,223 +1,373 @@
 // SPDX-License-Identifier: GPL-3.0-only
 
+#include <climits>
+#include <cstdio>
+#include <cstring>
 #include <fstream>
-#include <windows.h>
-#include <iostream>
 #include <istream>
 #include "ini.hpp"
-#include "../command/command.hpp"
-#include "../chimera.hpp"
-#include <cstring>
 
 namespace Chimera {
-    const char *Ini::get_value(const char *key) const noexcept {
-        for(auto &i : this->p_values) {
-            if(i.first == key) {
-                return i.second.data();
-            }
-        }
-        return nullptr;
-    }
+    enum IniCached : std::uint8_t {
+        INI_CACHED_BOOL = 1 << 0,
+        INI_CACHED_FLOAT = 1 << 1,
+        INI_CACHED_LONG = 1 << 2,
+        INI_CACHED_SIZE = 1 << 3
+    };
 
-    std::optional<bool> Ini::get_value_bool(const char *key) const noexcept {
-        auto *v = this->get_value(key);
-        if(!v) {
-            return std::nullopt;
-        }
-        return STR_TO_BOOL(v);
-    }
+    // Marks an empty slot in the hash table
+    #define INI_EMPTY_SLOT 0xFFFFFFFF
 
-    std::optional<double> Ini::get_value_float(const char *key) const noexcept {
-        auto *v = this->get_value(key);
-        if(!v) {
-            return std::nullopt;
-        }
-        try {
-            return std::stod(v);
-        }
-        catch(std::exception &) {
-            char error[512];
-            std::snprintf(error, sizeof(error), "%s (=> %s) is not a valid real number", key, v);
-            MessageBox(nullptr, error, "Can't read INI value", MB_ICONERROR | MB_OK);
-            std::terminate();
+    // Smallest hash table size; this must be a power of two
+    #define INI_MINIMUM_TABLE_SIZE 64
+
+    // FNV-1a
+    static constexpr std::uint32_t FNV_OFFSET_BASIS = 0x811C9DC5;
+    static constexpr std::uint32_t FNV_PRIME = 0x01000193;
+
+    static std::uint32_t hash_bytes(std::uint32_t hash, const char *data, std::size_t length) noexcept {
+        for(std::size_t i = 0; i < length; i++) {
+            hash = (hash ^ static_cast<std::uint8_t>(data[i])) * FNV_PRIME;
         }
+        return hash;
     }
 
-    std::optional<long> Ini::get_value_long(const char *key) const noexcept {
-        auto *v = this->get_value(key);
-        if(!v) {
-            return std::nullopt;
-        }
-        try {
-            return std::stol(v);
-        }
-        catch(std::exception &) {
-            char error[512];
-            std::snprintf(error, sizeof(error), "%s (=> %s) is not a valid integer or is out of range (%li - %li)", key, v, LONG_MIN, LONG_MAX);
-            MessageBox(nullptr, error, "Can't read INI value", MB_ICONERROR | MB_OK);
-            std::terminate();
+    // Hash group.key without putting it together first
+    static std::uint32_t hash_key(const char *group, std::size_t group_length, const char *key, std::size_t key_length) noexcept {
+        std::uint32_t hash = FNV_OFFSET_BASIS;
+        if(group_length) {
+            hash = hash_bytes(hash, group, group_length);
+            hash = hash_bytes(hash, ".", 1);
         }
+        return hash_bytes(hash, key, key_length);
     }
 
-    std::optional<unsigned long long> Ini::get_value_size(const char *key) const noexcept {
-        auto *v = this->get_value(key);
-        if(!v) {
-            return std::nullopt;
-        }
-        try {
-            return std::stoull(v);
-        }
-        catch(std::exception &) {
-            char error[512];
-            std::snprintf(error, sizeof(error), "%s (=> %s) is not a valid integer or is out of range (0 - %llu)", key, v, ULONG_LONG_MAX);
-            MessageBox(nullptr, error, "Can't read INI value", MB_ICONERROR | MB_OK);
-            std::terminate();
+    const Ini::Entry *Ini::find_entry(const char *key) const noexcept {
+        if(this->p_table.empty()) {
+            return nullptr;
         }
-    }
 
-    void Ini::set_value(const char *key, const char *value) noexcept {
-        for(auto &i : this->p_values) {
-            if(i.first == key) {
-                i.second = value;
-                break;
+        std::size_t key_length = std::strlen(key);
+        auto hash = hash_key(nullptr, 0, key, key_length);
+        std::size_t mask = this->p_table.size() - 1;
+
+        for(std::size_t slot = hash & mask;; slot = (slot + 1) & mask) {
+            auto index = this->p_table[slot];
+            if(index == INI_EMPTY_SLOT) {
+                return nullptr;
             }
-        }
-        this->p_values.emplace_back(key, value);
-    }
 
-    void Ini::set_value(std::pair<std::string, std::string> key_value) noexcept {
-        for(auto &i : this->p_values) {
-            if(i.first == key_value.first) {
-                i.second = std::move(key_value.second);
-                break;
+            auto &entry = this->p_entries[index];
+            if(entry.hash != hash) {
+                continue;
             }
-        }
-        this->p_values.emplace_back(key_value);
-    }
 
-    void Ini::delete_value(const char *key) noexcept {
-        for(auto &i : this->p_values) {
-            if(i.first == key) {
-                this->p_values.erase(this->p_values.begin() + (&i - this->p_values.data()));
-                break;
+            // Compare against group.key (or just key)
+            const char *data = this->p_buffer.data();
+            if(entry.group_length) {
+                if(entry.group_length + 1 + entry.key_length != key_length || std::memcmp(data + entry.group_offset, key, entry.group_length) != 0 || key[entry.group_length] != '.' || std::memcmp(data + entry.key_offset, key + entry.group_length + 1, entry.key_length) != 0) {
+                    continue;
+                }
             }
+            else if(entry.key_length != key_length || std::memcmp(data + entry.key_offset, key, key_length) != 0) {
+                continue;
+            }
+
+            return &entry;
         }
     }
 
-    // Returns false on error, a key/value pair, or true to do nothing
-    static std::variant<std::pair<std::string, std::string>, bool> digest_line(const char *data, const char **new_offset, std::string &current_group, std::size_t line_number) {
-        // Determine how big the line is
-        std::size_t line_length = 0;
-        bool non_whitespace = false;
-        std::size_t equals_offset = 0;
-        std::size_t right_square_bracket_offset = 0;
-        while(data[line_length] && data[line_length] != '\r' && data[line_length] != '\n') {
-            if(!non_whitespace && data[line_length] != ' ' && data[line_length] != '\t') {
-                non_whitespace = true;
-            }
-            if(!equals_offset && data[line_length] == '=') {
-                equals_offset = line_length;
+    void Ini::insert_index(std::uint32_t index) {
+        // Keep the table at most half full so probes stay short
+        if((this->p_entries.size()) * 2 > this->p_table.size()) {
+            std::size_t new_size = this->p_table.empty() ? INI_MINIMUM_TABLE_SIZE : this->p_table.size() * 2;
+            while(this->p_entries.size() * 2 > new_size) {
+                new_size *= 2;
             }
-            if(!right_square_bracket_offset && data[line_length] == ']') {
-                right_square_bracket_offset = line_length;
+            this->p_table.assign(new_size, INI_EMPTY_SLOT);
+
+            // Re-add everything before this entry; this one is added below
+            std::size_t mask = new_size - 1;
+            for(std::uint32_t i = 0; i < index; i++) {
+                std::size_t slot = this->p_entries[i].hash & mask;
+                while(this->p_table[slot] != INI_EMPTY_SLOT) {
+                    slot = (slot + 1) & mask;
+                }
+                this->p_table[slot] = i;
             }
-            line_length++;
         }
 
-        // Set new_offset, making sure it doesn't start on a line break
-        if(new_offset) {
-            *new_offset = data + line_length;
-            while(**new_offset == '\r' || **new_offset == '\n') {
-                (*new_offset)++;
+        std::size_t mask = this->p_table.size() - 1;
+        std::size_t slot = this->p_entries[index].hash & mask;
+        while(this->p_table[slot] != INI_EMPTY_SLOT) {
+            slot = (slot + 1) & mask;
+        }
+        this->p_table[slot] = index;
+    }
+
+    void Ini::add_entry(const Entry &entry) {
+        const char *data = this->p_buffer.data();
+
+        // Replace the value if it's already set. The last value in the file wins.
+        if(!this->p_table.empty()) {
+            // Either one may have been set with the group in the key, so compare the full keys one character at a time
+            auto full_key_length = [](const Entry &e) -> std::size_t {
+                return e.group_length ? e.group_length + 1 + e.key_length : e.key_length;
+            };
+            auto full_key_at = [&data](const Entry &e, std::size_t i) -> char {
+                if(e.group_length) {
+                    if(i < e.group_length) {
+                        return data[e.group_offset + i];
+                    }
+                    else if(i == e.group_length) {
+                        return '.';
+                    }
+                    return data[e.key_offset + i - e.group_length - 1];
+                }
+                return data[e.key_offset + i];
+            };
+
+            std::size_t length = full_key_length(entry);
+            std::size_t mask = this->p_table.size() - 1;
+            for(std::size_t slot = entry.hash & mask; this->p_table[slot] != INI_EMPTY_SLOT; slot = (slot + 1) & mask) {
+                auto &existing = this->p_entries[this->p_table[slot]];
+                if(existing.hash != entry.hash || full_key_length(existing) != length) {
+                    continue;
+                }
+
+                bool match = true;
+                for(std::size_t i = 0; i < length && match; i++) {
+                    match = full_key_at(entry, i) == full_key_at(existing, i);
+                }
+                if(!match) {
+                    continue;
+                }
+
+                existing.value_offset = entry.value_offset;
+                existing.deleted = false;
+                existing.cached = 0;
+                return;
             }
         }
 
-        // If there's nothing here, bail
-        if(!non_whitespace) {
-            return true;
+        auto index = static_cast<std::uint32_t>(this->p_entries.size());
+        auto &new_entry = this->p_entries.emplace_back(entry);
+        new_entry.deleted = false;
+        new_entry.cached = 0;
+        this->insert_index(index);
+    }
+
+    const char *Ini::get_value(const char *key) const noexcept {
+        auto *entry = this->find_entry(key);
+        if(!entry || entry->deleted) {
+            return nullptr;
         }
+        return this->p_buffer.data() + entry->value_offset;
+    }
 
-        // If we are starting on a comma, bail
-        if(*data == ';') {
-            return true;
+    std::optional<bool> Ini::get_value_bool(const char *key) const noexcept {
+        auto *entry = this->find_entry(key);
+        if(!entry || entry->deleted) {
+            return std::nullopt;
+        }
+        if(!(entry->cached & INI_CACHED_BOOL)) {
+            // Same as STR_TO_BOOL, but without pulling in the command header
+            auto *v = this->p_buffer.data() + entry->value_offset;
+            entry->cached_bool = std::strcmp(v, "1") == 0 || std::strcmp(v, "true") == 0;
+            entry->cached |= INI_CACHED_BOOL;
         }
+        return entry->cached_bool;
+    }
 
-        auto show_error = [&line_number, &data]() {
-            // We can't feasibly continue from this without causing undefined behavior. Abort the process after showing an error message.
-            char error[1024];
-            std::snprintf(error, sizeof(error), "chimera.ini error (line #%zu):\n\n%s\n\nThis line could not be parsed. The game must close now.\n", line_number, data);
-            if(get_chimera().feature_present("server")) {
-                std::cerr << error;
+    std::optional<double> Ini::get_value_float(const char *key) const noexcept {
+        auto *entry = this->find_entry(key);
+        if(!entry || entry->deleted) {
+            return std::nullopt;
+        }
+        if(!(entry->cached & INI_CACHED_FLOAT)) {
+            auto *v = this->p_buffer.data() + entry->value_offset;
+            try {
+                entry->cached_float = std::stod(v);
             }
-            else {
-                MessageBox(NULL, error, "Chimera configuration error", MB_ICONERROR | MB_OK);
+            catch(std::exception &) {
+                ini_invalid_value(key, v, "a valid real number");
             }
-            ExitProcess(136);
-        };
+            entry->cached |= INI_CACHED_FLOAT;
+        }
+        return entry->cached_float;
+    }
 
-        // Check if we're in a group
-        if(*data == '[') {
-            if(right_square_bracket_offset == 0) {
-                show_error();
-                return false;
+    std::optional<long> Ini::get_value_long(const char *key) const noexcept {
+        auto *entry = this->find_entry(key);
+        if(!entry || entry->deleted) {
+            return std::nullopt;
+        }
+        if(!(entry->cached & INI_CACHED_LONG)) {
+            auto *v = this->p_buffer.data() + entry->value_offset;
+            try {
+                entry->cached_long = std::stol(v);
             }
-            else {
-                current_group = std::string(data + 1, right_square_bracket_offset - 1);
-                return true;
+            catch(std::exception &) {
+                char expected[128];
+                std::snprintf(expected, sizeof(expected), "a valid integer or is out of range (%li - %li)", LONG_MIN, LONG_MAX);
+                ini_invalid_value(key, v, expected);
             }
+            entry->cached |= INI_CACHED_LONG;
         }
+        return entry->cached_long;
+    }
 
-        // Check if we have a key value
-        if(equals_offset) {
-            std::string key;
-            if(current_group.size() == 0) {
-                key = std::string(data, equals_offset);
+    std::optional<unsigned long long> Ini::get_value_size(const char *key) const noexcept {
+        auto *entry = this->find_entry(key);
+        if(!entry || entry->deleted) {
+            return std::nullopt;
+        }
+        if(!(entry->cached & INI_CACHED_SIZE)) {
+            auto *v = this->p_buffer.data() + entry->value_offset;
+            try {
+                entry->cached_size = std::stoull(v);
             }
-            else {
-                key = current_group + "." + std::string(data, equals_offset);
+            catch(std::exception &) {
+                char expected[128];
+                std::snprintf(expected, sizeof(expected), "a valid integer or is out of range (0 - %llu)", ULLONG_MAX);
+                ini_invalid_value(key, v, expected);
             }
-            return std::pair(key, std::string(data + equals_offset + 1, line_length - equals_offset - 1));
+            entry->cached |= INI_CACHED_SIZE;
         }
+        return entry->cached_size;
+    }
+
+    void Ini::set_value(const char *key, const char *value) noexcept {
+        // Append key\0value\0 to the buffer. Anything it replaces stays in the buffer, but values are rarely set after loading.
+        std::size_t key_length = std::strlen(key);
+        std::size_t value_length = std::strlen(value);
 
-        show_error();
-        return false;
+        Entry entry = {};
+        entry.key_offset = static_cast<std::uint32_t>(this->p_buffer.size());
+        entry.key_length = static_cast<std::uint32_t>(key_length);
+        entry.value_offset = static_cast<std::uint32_t>(entry.key_offset + key_length + 1);
+        entry.hash = hash_key(nullptr, 0, key, key_length);
+
+        this->p_buffer.insert(this->p_buffer.end(), key, key + key_length + 1);
+        this->p_buffer.insert(this->p_buffer.end(), value, value + value_length + 1);
+        this->add_entry(entry);
     }
 
-    Ini::Ini(const char *path) {
-        std::ifstream stream(path);
-        this->load_from_stream(stream);
+    void Ini::set_value(std::pair<std::string, std::string> key_value) noexcept {
+        this->set_value(key_value.first.c_str(), key_value.second.c_str());
+    }
+
+    void Ini::delete_value(const char *key) noexcept {
+        auto *entry = this->find_entry(key);
+        if(entry) {
+            // Entries are never removed from the table since that would break probing, so just mark it as deleted
+            this->p_entries[entry - this->p_entries.data()].deleted = true;
+        }
     }
 
-    Ini::Ini(std::istream &stream) {
-        this->load_from_stream(stream);
+    bool Ini::load(const char *path, IniError &error) {
+        std::ifstream stream(path);
+        return this->load(stream, error);
     }
 
-    void Ini::load_from_stream(std::istream &stream) {
-        std::string group;
-        std::string line;
-        std::size_t no = 0;
+    bool Ini::load(std::istream &stream, IniError &error) {
+        this->p_buffer.clear();
+        this->p_entries.clear();
+        this->p_table.clear();
 
         if(!stream.good()) {
-            static const char *failed_to_open_error = "chimera.ini could not be opened.\n\nMake sure it exists and you have permission to it.\n\nThe game must close now.\n";
-            if(get_chimera().feature_present("server")) {
-                std::cerr << failed_to_open_error;
+            error = {};
+            return false;
+        }
+
+        // Read the whole thing in one go. Lines are parsed in place, so this is the only copy of the file we make.
+        char chunk[4096];
+        while(stream.read(chunk, sizeof(chunk)) || stream.gcount() > 0) {
+            this->p_buffer.insert(this->p_buffer.end(), chunk, chunk + stream.gcount());
+        }
+        this->p_buffer.push_back(0);
+
+        return this->load_from_buffer(error);
+    }
+
+    bool Ini::load_from_buffer(IniError &error) {
+        char *data = this->p_buffer.data();
+        std::size_t end = this->p_buffer.size() - 1;
+        std::size_t offset = 0;
+        std::size_t line_number = 0;
+
+        // Group offset and length (no group if the length is 0)
+        std::uint32_t group_offset = 0;
+        std::uint32_t group_length = 0;
+
+        while(offset < end) {
+            char *line = data + offset;
+            line_number++;
+
+            // Determine how big the line is
+            std::size_t line_length = 0;
+            bool non_whitespace = false;
+            std::size_t equals_offset = 0;
+            std::size_t right_square_bracket_offset = 0;
+            while(line[line_length] && line[line_length] != '\r' && line[line_length] != '\n') {
+                if(!non_whitespace && line[line_length] != ' ' && line[line_length] != '\t') {
+                    non_whitespace = true;
+                }
+                if(!equals_offset && line[line_length] == '=') {
+                    equals_offset = line_length;
+                }
+                if(!right_square_bracket_offset && line[line_length] == ']') {
+                    right_square_bracket_offset = line_length;
+                }
+                line_length++;
             }
-            else {
-                MessageBox(NULL, failed_to_open_error, "Chimera configuration error", MB_ICONERROR | MB_OK);
+
+            // Move to the next line. \r\n counts as one line break. Then terminate this line so the value can be used as-is.
+            offset += line_length;
+            if(offset < end) {
+                offset++;
+                if(line[line_length] == '\r' && offset < end && data[offset] == '\n') {
+                    offset++;
+                }
             }
-            ExitProcess(136);
-        }
+            line[line_length] = 0;
 
-        while(std::getline(stream, line)) {
-            auto result = digest_line(line.data(), nullptr, group, ++no);
-            if(result.index() == 0) {
-                this->set_value(std::move(std::get<0>(result)));
+            // If there's nothing here or we are starting on a semicolon, skip it
+            if(!non_whitespace || *line == ';') {
+                continue;
             }
-            else if(std::get<1>(result) == false) {
-                this->p_values.clear();
-                ExitProcess(136);
-                return;
+
+            // Check if we're in a group
+            if(*line == '[') {
+                if(right_square_bracket_offset != 0) {
+                    group_offset = static_cast<std::uint32_t>(line + 1 - data);
+                    group_length = static_cast<std::uint32_t>(right_square_bracket_offset - 1);
+                    continue;
+                }
+            }
+
+            // Check if we have a key value
+            else if(equals_offset) {
+                Entry entry = {};
+                entry.group_offset = group_offset;
+                entry.group_length = group_length;
+                entry.key_offset = static_cast<std::uint32_t>(line - data);
+                entry.key_length = static_cast<std::uint32_t>(equals_offset);
+                entry.value_offset = static_cast<std::uint32_t>(entry.key_offset + equals_offset + 1);
+                entry.hash = hash_key(data + group_offset, group_length, line, equals_offset);
+                this->add_entry(entry);
+                continue;
             }
+
+            // We can't feasibly continue from this without causing undefined behavior, so give up and let the caller deal with it
+            error.line_number = line_number;
+            error.line = line;
+            this->p_buffer.clear();
+            this->p_entries.clear();
+            this->p_table.clear();
+            return false;
         }
+
+        return true;
     }
 }
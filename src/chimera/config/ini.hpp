@@ -1,6 +1,6 @@
 // SPDX-License-Identifier: GPL-3.0-only
 
-#include <variant>
+#include <cstdint>
 #include <string>
 #include <vector>
 #include <utility>
@@ -8,6 +8,25 @@
 #include <optional>
 
 namespace Chimera {
+    /**
+     * Why an Ini could not be loaded
+     */
+    struct IniError {
+        /** Line that could not be parsed, or 0 if nothing could be read */
+        std::size_t line_number = 0;
+
+        /** Contents of the line that could not be parsed */
+        std::string line;
+    };
+
+    /**
+     * Called when a value is read as a type it can't be converted to. This is defined by whatever uses Ini, and it must not return.
+     * @param key      name of the value
+     * @param value    the value
+     * @param expected what the value was expected to be
+     */
+    [[noreturn]] void ini_invalid_value(const char *key, const char *value, const char *expected) noexcept;
+
     class Ini {
     public:
         /**
@@ -66,16 +85,20 @@ namespace Chimera {
         void delete_value(const char *key) noexcept;
 
         /**
-         * Initialize an Ini from a path
-         * @param path path to initialize from
+         * Load from a path, replacing anything already loaded
+         * @param  path  path to load from
+         * @param  error set to why it could not be loaded if it could not be
+         * @return       true if loaded, false if not
          */
-        Ini(const char *path);
+        bool load(const char *path, IniError &error);
 
         /**
-         * Initialize an Ini from a stream
-         * @param data data to initialize from
+         * Load from a stream, replacing anything already loaded
+         * @param  stream stream to load from
+         * @param  error  set to why it could not be loaded if it could not be
+         * @return        true if loaded, false if not
          */
-        Ini(std::istream &stream);
+        bool load(std::istream &stream, IniError &error);
 
         /**
          * Initialize an empty Ini.
@@ -95,13 +118,65 @@ namespace Chimera {
         Ini(Ini &&move) = default;
 
     private:
-        /** Values of the Ini */
-        std::vector<std::pair<std::string, std::string>> p_values;
+        struct Entry {
+            /** Offset and length of the group name in the buffer (the key is group.key, or just key if there is no group) */
+            std::uint32_t group_offset;
+            std::uint32_t group_length;
+
+            /** Offset and length of the key in the buffer */
+            std::uint32_t key_offset;
+            std::uint32_t key_length;
+
+            /** Offset of the null-terminated value in the buffer */
+            std::uint32_t value_offset;
+
+            /** Hash of the full key */
+            std::uint32_t hash;
+
+            /** Whether or not the value was deleted */
+            bool deleted;
+
+            /** Typed values that have been parsed so far (IniCached flags) */
+            mutable std::uint8_t cached;
+            mutable bool cached_bool;
+            mutable long cached_long;
+            mutable double cached_float;
+            mutable unsigned long long cached_size;
+        };
+
+        /** Everything that was read from the file plus anything set afterwards. Keys and values point into this. */
+        std::vector<char> p_buffer;
+
+        /** Entries in the order they were first set */
+        std::vector<Entry> p_entries;
+
+        /** Open addressing hash table of indices into p_entries; the size is always a power of two */
+        std::vector<std::uint32_t> p_table;
+
+        /**
+         * Find an entry by its full key
+         * @param  key    full key
+         * @return        pointer to the entry or nullptr if not found (deleted entries are returned, too)
+         */
+        const Entry *find_entry(const char *key) const noexcept;
+
+        /**
+         * Add a new entry or replace the value of an existing one
+         * @param entry entry to add; cached values are ignored
+         */
+        void add_entry(const Entry &entry);
+
+        /**
+         * Add an index to the hash table, growing the table if needed
+         * @param index index of the entry
+         */
+        void insert_index(std::uint32_t index);
 
         /**
-         * Load from the stream
-         * @param stream stream to load from
+         * Parse the buffer
+         * @param  error set to why it could not be parsed if it could not be
+         * @return       true if parsed, false if not
          */
-        void load_from_stream(std::istream &stream);
+        bool load_from_buffer(IniError &error);
     };
 }
@@ -21,6 +21,8 @@
 #include <fstream>
 #include <deque>
 #include <chrono>
+#include <cctype>
+#include <tuple>
 
 namespace Chimera {
     static std::string rcon_password;
@@ -28,7 +30,7 @@ namespace Chimera {
     static void read_command();
     static char *console_text = NULL;
 
-    extern std::vector<Event<CommandEventFunction>> command_events;
+    extern EventList<CommandEventFunction> command_events;
 
     struct CommandEntry {
         std::uint32_t return_type; // 4 = server stuff
@@ -60,7 +62,9 @@ namespace Chimera {
     static std::uint32_t old_entry_count;
 
     static std::vector<CommandEntry *> new_entries_list;
-    static std::vector<std::unique_ptr<CommandEntry>> new_entries_added;
+
+    // One entry for each Chimera command, in the same order as get_commands_by_name()
+    static std::vector<CommandEntry> chimera_command_entries;
 
     void script_command_dump_command(int, const char **) noexcept {
         char path[MAX_PATH];
@@ -147,25 +151,56 @@ namespace Chimera {
         }
     }
 
+    // Get the lowercase command name being typed, if that's all that's in the console
+    static bool tab_completion_prefix(char *prefix, std::size_t prefix_size) noexcept {
+        std::size_t length = 0;
+        for(const char *c = console_text; *c; c++) {
+            if(!std::isalnum(static_cast<unsigned char>(*c)) && *c != '_') {
+                return false;
+            }
+            if(length + 1 == prefix_size) {
+                return false;
+            }
+            prefix[length++] = static_cast<char>(std::tolower(static_cast<unsigned char>(*c)));
+        }
+        prefix[length] = 0;
+        return true;
+    }
+
     static void on_tab_completion_start() noexcept {
-        auto &chimera_commands = get_chimera().get_commands();
+        auto &chimera = get_chimera();
+        auto &commands = chimera.get_commands_by_name();
+
+        // Our entries never change, so only make them once
+        if(chimera_command_entries.size() != commands.size()) {
+            chimera_command_entries.clear();
+            chimera_command_entries.reserve(commands.size());
+            for(auto *command : commands) {
+                auto &new_command = chimera_command_entries.emplace_back();
+                new_command.return_type = 4;
+                new_command.name = command->name();
+                new_command.help_text = "see README.md";
+                new_command.help_parameters = nullptr;
+                new_command.more_stuff = 0x15;
+            }
+        }
 
         old_entry_count = *entry_count;
         old_entries = *entries;
 
-        new_entries_list = std::vector<CommandEntry *>(old_entries, old_entries + old_entry_count);
-        for(auto &command : chimera_commands) {
-            if(!get_chimera().feature_present(command.feature())) {
-                continue;
-            }
+        // Halo only completes to names that start with what was typed, so skip everything else
+        std::size_t first = 0;
+        std::size_t last = commands.size();
+        char prefix[64];
+        if(tab_completion_prefix(prefix, sizeof(prefix))) {
+            std::tie(first, last) = chimera.find_commands_with_prefix(prefix);
+        }
 
-            auto &new_command = new_entries_added.emplace_back(std::make_unique<CommandEntry>());
-            new_command->return_type = 4;
-            new_command->name = command.name();
-            new_command->help_text = "see README.md";
-            new_command->help_parameters = nullptr;
-            new_command->more_stuff = 0x15;
-            new_entries_list.emplace_back(new_command.get());
+        new_entries_list.assign(old_entries, old_entries + old_entry_count);
+        for(std::size_t i = first; i < last; i++) {
+            if(chimera.feature_present(commands[i]->feature())) {
+                new_entries_list.emplace_back(&chimera_command_entries[i]);
+            }
         }
 
         overwrite(entry_count, static_cast<std::uint32_t>(new_entries_list.size()));
@@ -177,7 +212,6 @@ namespace Chimera {
         overwrite(entries, old_entries);
 
         new_entries_list.clear();
-        new_entries_added.clear();
     }
 
     void initialize_console_hook() {
@@ -321,15 +321,15 @@ namespace Chimera {
         // Handle chat input
         if(chat_input_open) {
             char buffer_to_show[INPUT_BUFFER_SIZE * 2] = {};
-            const char *channel_name;
+            LocalizationID channel_name;
             if(chat_input_channel == 0) {
-                channel_name = "chimera_custom_chat_to_all";
+                channel_name = LOCALIZATION_ID("chimera_custom_chat_to_all");
             }
             else if(chat_input_channel == 1) {
-                channel_name = "chimera_custom_chat_to_team";
+                channel_name = LOCALIZATION_ID("chimera_custom_chat_to_team");
             }
             else {
-                channel_name = "chimera_custom_chat_to_vehicle";
+                channel_name = LOCALIZATION_ID("chimera_custom_chat_to_vehicle");
             }
 
             // Define the font for chat input
@@ -340,7 +340,7 @@ namespace Chimera {
             }
 
             // Copy this over, first
-            std::snprintf(buffer_to_show, sizeof(buffer_to_show), "%s - ", localize(channel_name));
+            std::snprintf(buffer_to_show, sizeof(buffer_to_show), "%s - ", localize_id(channel_name));
             auto x_offset_text_buffer = text_pixel_length(buffer_to_show, chat_input_font);
             apply_text_quake_colors(buffer_to_show, chat_input_x, adjusted_y, chat_input_w, line_height, chat_input_color, chat_input_font, chat_input_anchor);
 
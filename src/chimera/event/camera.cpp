@@ -8,48 +8,32 @@
 namespace Chimera {
     static void enable_camera_hook();
 
-    static std::vector<Event<EventFunction>> precamera_events;
+    static EventList<EventFunction> precamera_events("precamera");
 
     void add_precamera_event(const EventFunction function, EventPriority priority) {
-        // Remove if exists
-        remove_precamera_event(function);
-
         // Enable camera hook if not enabled
         enable_camera_hook();
 
         // Add the event
-        precamera_events.emplace_back(Event<EventFunction> { function, priority });
+        precamera_events.add(function, priority);
     }
 
     void remove_precamera_event(const EventFunction function) {
-        for(std::size_t i = 0; i < precamera_events.size(); i++) {
-            if(precamera_events[i].function == function) {
-                precamera_events.erase(precamera_events.begin() + i);
-                return;
-            }
-        }
+        precamera_events.remove(function);
     }
 
-    static std::vector<Event<EventFunction>> camera_events;
+    static EventList<EventFunction> camera_events("camera");
 
     void add_camera_event(const EventFunction function, EventPriority priority) {
-        // Remove if exists
-        remove_camera_event(function);
-
         // Enable camera hook if not enabled
         enable_camera_hook();
 
         // Add the event
-        camera_events.emplace_back(Event<EventFunction> { function, priority });
+        camera_events.add(function, priority);
     }
 
     void remove_camera_event(const EventFunction function) {
-        for(std::size_t i = 0; i < camera_events.size(); i++) {
-            if(camera_events[i].function == function) {
-                camera_events.erase(camera_events.begin() + i);
-                return;
-            }
-        }
+        camera_events.remove(function);
     }
 
     static void on_precamera() {
@@ -13,26 +13,18 @@ extern "C" {
 namespace Chimera {
     static void enable_connect_hook();
 
-    static std::vector<Event<ConnectEventFunction>> preconnect_events;
+    static EventList<ConnectEventFunction> preconnect_events("preconnect");
 
     void add_preconnect_event(const ConnectEventFunction function, EventPriority priority) {
-        // Remove if exists
-        remove_preconnect_event(function);
-
         // Enable camera hook if not enabled
         enable_connect_hook();
 
         // Add the event
-        preconnect_events.emplace_back(Event<ConnectEventFunction> { function, priority });
+        preconnect_events.add(function, priority);
     }
 
     void remove_preconnect_event(const ConnectEventFunction function) {
-        for(std::size_t i = 0; i < preconnect_events.size(); i++) {
-            if(preconnect_events[i].function == function) {
-                preconnect_events.erase(preconnect_events.begin() + i);
-                return;
-            }
-        }
+        preconnect_events.remove(function);
     }
 
     extern "C" bool on_preconnect(std::uint32_t &ip, std::uint16_t &port, char16_t *password) {
@@ -6,7 +6,7 @@
 #include "../signature/signature.hpp"
 
 namespace Chimera {
-    static std::vector<Event<EndSceneEventFunction>> end_scene_events;
+    static EventList<EndSceneEventFunction> end_scene_events("d3d9_end_scene");
 
     static void enable_d3d9_end_scene_hook();
 
@@ -15,23 +15,15 @@ namespace Chimera {
     }
 
     void add_d3d9_end_scene_event(const EndSceneEventFunction function, EventPriority priority) {
-        // Remove if exists
-        remove_d3d9_end_scene_event(function);
-
         // Enable hook if necessary
         enable_d3d9_end_scene_hook();
 
         // Add the event
-        end_scene_events.emplace_back(Event<EndSceneEventFunction> { function, priority });
+        end_scene_events.add(function, priority);
     }
 
     void remove_d3d9_end_scene_event(const EndSceneEventFunction function) {
-        for(std::size_t i = 0; i < end_scene_events.size(); i++) {
-            if(end_scene_events[i].function == function) {
-                end_scene_events.erase(end_scene_events.begin() + i);
-                return;
-            }
-        }
+        end_scene_events.remove(function);
     }
 
     extern "C" void do_d3d9_end_scene_event(LPDIRECT3DDEVICE9 device) {
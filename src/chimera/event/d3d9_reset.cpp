@@ -6,7 +6,7 @@
 #include "../signature/signature.hpp"
 
 namespace Chimera {
-    static std::vector<Event<ResetEventFunction>> reset_events;
+    static EventList<ResetEventFunction> reset_events("d3d9_reset");
 
     static void enable_d3d9_reset_hook();
 
@@ -15,23 +15,15 @@ namespace Chimera {
     }
 
     void add_d3d9_reset_event(const ResetEventFunction function, EventPriority priority) {
-        // Remove if exists
-        remove_d3d9_reset_event(function);
-
         // Enable hook if necessary
         enable_d3d9_reset_hook();
 
         // Add the event
-        reset_events.emplace_back(Event<ResetEventFunction> { function, priority });
+        reset_events.add(function, priority);
     }
 
     void remove_d3d9_reset_event(const ResetEventFunction function) {
-        for(std::size_t i = 0; i < reset_events.size(); i++) {
-            if(reset_events[i].function == function) {
-                reset_events.erase(reset_events.begin() + i);
-                return;
-            }
-        }
+        reset_events.remove(function);
     }
 
     extern "C" void do_d3d9_reset_event(LPDIRECT3DDEVICE9 device, D3DPRESENT_PARAMETERS *present) {
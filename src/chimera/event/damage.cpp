@@ -7,7 +7,7 @@
 #include "../halo_data/damage.hpp"
 
 namespace Chimera {
-    static std::vector<Event<DamageEventFunction>> damage_events;
+    static EventList<DamageEventFunction> damage_events("damage");
 
     static void enable_damage_hook();
 
@@ -26,23 +26,15 @@ namespace Chimera {
     }
 
     void add_damage_event(const DamageEventFunction function, EventPriority priority) {
-        // Remove if exists
-        remove_damage_event(function);
-
         // Enable hook if necessary
         enable_damage_hook();
 
         // Add the event
-        damage_events.emplace_back(Event<DamageEventFunction> { function, priority });
+        damage_events.add(function, priority);
     }
 
     void remove_damage_event(const DamageEventFunction function) {
-        for(std::size_t i = 0; i < damage_events.size(); i++) {
-            if(damage_events[i].function == function) {
-                damage_events.erase(damage_events.begin() + i);
-                return;
-            }
-        }
+        damage_events.remove(function);
     }
 
     extern "C" bool do_damage_event(ObjectID *object, DamageObjectStructThing *damage_thing) {
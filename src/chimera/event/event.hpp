@@ -3,6 +3,9 @@
 #ifndef CHIMERA_EVENT_HPP
 #define CHIMERA_EVENT_HPP
 
+#include <chrono>
+#include <cstddef>
+#include <memory>
 #include <vector>
 
 namespace Chimera {
@@ -38,46 +41,176 @@ namespace Chimera {
     /** This is a function typename that has no arguments and returns nothing. */
     using EventFunction = void (*)();
 
+    /**
+     * A list of events sorted into priority buckets. Calling the events does not copy or allocate anything; instead, adding or removing an
+     * event builds a new snapshot, and anything currently calling the old snapshot keeps its own reference to it. This allows events to
+     * be added/removed while they are being called.
+     */
+    template<typename T> class EventList {
+    public:
+        /**
+         * Instantiate an event list
+         * @param name name of the event, used by the event profiler
+         */
+        constexpr explicit EventList(const char *name) noexcept : p_name(name) {}
+
+        /**
+         * Get the name of the event
+         * @return name of the event
+         */
+        const char *name() const noexcept {
+            return this->p_name;
+        }
+
+        /** This is an immutable copy of the events. The buckets are laid out one after another from EVENT_PRIORITY_BEFORE to EVENT_PRIORITY_FINAL. */
+        struct Snapshot {
+            /** These are the events in the order they are called. */
+            std::vector<Event<T>> events;
+
+            /** This is the index of the end of each priority's bucket in events. */
+            std::size_t bucket_end[EVENT_PRIORITY_FINAL + 1] = {};
+        };
+
+        /**
+         * Add an event to the end of its priority's bucket. If the function was already added, it is removed first.
+         * @param function function to add
+         * @param priority priority of the function
+         */
+        void add(T function, EventPriority priority) {
+            auto snapshot = std::make_shared<Snapshot>(this->without(function));
+            std::size_t insert_at = snapshot->bucket_end[priority];
+            snapshot->events.insert(snapshot->events.begin() + insert_at, Event<T> { function, priority });
+            for(std::size_t p = priority; p <= EVENT_PRIORITY_FINAL; p++) {
+                snapshot->bucket_end[p]++;
+            }
+            this->p_snapshot = std::move(snapshot);
+        }
+
+        /**
+         * Remove an event if it was added
+         * @param function function to remove
+         */
+        void remove(T function) {
+            if(this->contains(function)) {
+                this->p_snapshot = std::make_shared<Snapshot>(this->without(function));
+            }
+        }
+
+        /**
+         * Check if a function was added
+         * @param  function function to check
+         * @return          true if the function was added
+         */
+        bool contains(T function) const noexcept {
+            if(this->p_snapshot) {
+                for(const auto &event : this->p_snapshot->events) {
+                    if(event.function == function) {
+                        return true;
+                    }
+                }
+            }
+            return false;
+        }
+
+        /**
+         * Get the current snapshot. Hold onto the returned pointer while calling the events.
+         * @return snapshot, or nullptr if no events were ever added
+         */
+        std::shared_ptr<const Snapshot> snapshot() const noexcept {
+            return this->p_snapshot;
+        }
+
+    private:
+        /** This is the name of the event. */
+        const char *p_name;
+
+        /** This is the current snapshot. It is replaced, not modified, when events are added or removed. */
+        std::shared_ptr<const Snapshot> p_snapshot;
+
+        /**
+         * Copy the current snapshot without the given function
+         * @param  function function to leave out
+         * @return          copy of the snapshot
+         */
+        Snapshot without(T function) const {
+            Snapshot copy;
+            if(!this->p_snapshot) {
+                return copy;
+            }
+            copy.events.reserve(this->p_snapshot->events.size() + 1);
+            std::size_t i = 0;
+            for(std::size_t p = EVENT_PRIORITY_BEFORE; p <= EVENT_PRIORITY_FINAL; p++) {
+                for(; i < this->p_snapshot->bucket_end[p]; i++) {
+                    const auto &event = this->p_snapshot->events[i];
+                    if(event.function != function) {
+                        copy.events.push_back(event);
+                    }
+                }
+                copy.bucket_end[p] = copy.events.size();
+            }
+            return copy;
+        }
+    };
+
+    /** This is set when the event profiler is recording. Events are only timed while this is set. */
+    extern bool event_profiler_enabled;
+
+    /**
+     * Record a call to an event for the event profiler
+     * @param event_name name of the event
+     * @param function   function that was called
+     * @param priority   priority of the function
+     * @param start      when the function was called
+     */
+    void record_event_call(const char *event_name, const void *function, EventPriority priority, std::chrono::steady_clock::time_point start) noexcept;
+
     /**
      * Call events in order.
-     * @param events These are the events being used. A copy is made, allowing events to be added/removed when needed.
+     * @param events These are the events being used. Events can be added/removed while they are being called.
      * @param args   These are the arguments to pass to each events' function.
      */
-    template<typename T, typename ... Args> static inline void call_in_order(std::vector<Event<T>> events, Args&& ... args) {
-        auto call_events = [&](const std::vector<Event<T>> &events, EventPriority priority) {
-            for(const auto &event : events) {
-                if(event.priority == priority) {
-                    event.function(std::forward<Args>(args) ...);
-                }
+    template<typename T, typename ... Args> static inline void call_in_order(const EventList<T> &events, Args&& ... args) {
+        auto snapshot = events.snapshot();
+        if(!snapshot) {
+            return;
+        }
+        if(event_profiler_enabled) {
+            for(const auto &event : snapshot->events) {
+                auto start = std::chrono::steady_clock::now();
+                event.function(std::forward<Args>(args) ...);
+                record_event_call(events.name(), reinterpret_cast<const void *>(event.function), event.priority, start);
             }
-        };
-        call_events(events, EVENT_PRIORITY_BEFORE);
-        call_events(events, EVENT_PRIORITY_DEFAULT);
-        call_events(events, EVENT_PRIORITY_AFTER);
-        call_events(events, EVENT_PRIORITY_FINAL);
+            return;
+        }
+        for(const auto &event : snapshot->events) {
+            event.function(std::forward<Args>(args) ...);
+        }
     }
 
     /**
      * Call events in order but the event can be denied by any function, preventing further events from firing.
-     * @param events These are the events being used. A copy is made, allowing events to be added/removed when needed.
+     * @param events These are the events being used. Events can be added/removed while they are being called.
      * @param allow  This is a reference to a boolean to use which may be set to false when denied. If it is already false, no events will be fired.
      * @param args   These are the arguments to pass to each events' function.
      */
-    template<typename T, typename ... Args> static inline void call_in_order_allow(std::vector<Event<T>> events, bool &allow, Args&& ... args) {
-        auto call_events = [&](const std::vector<Event<T>> &events, bool &allow, EventPriority priority) {
-            for(const auto &event : events) {
-                if(!allow) {
-                    break;
-                }
-                if(event.priority == priority) {
-                    allow = event.function(std::forward<Args>(args) ...);
-                }
+    template<typename T, typename ... Args> static inline void call_in_order_allow(const EventList<T> &events, bool &allow, Args&& ... args) {
+        auto snapshot = events.snapshot();
+        if(!snapshot) {
+            return;
+        }
+        for(const auto &event : snapshot->events) {
+            if(!allow) {
+                break;
             }
-        };
-        call_events(events, allow, EVENT_PRIORITY_BEFORE);
-        call_events(events, allow, EVENT_PRIORITY_DEFAULT);
-        call_events(events, allow, EVENT_PRIORITY_AFTER);
-        call_events(events, allow, EVENT_PRIORITY_FINAL);
+            if(event_profiler_enabled) {
+                auto start = std::chrono::steady_clock::now();
+                allow = event.function(std::forward<Args>(args) ...);
+                record_event_call(events.name(), reinterpret_cast<const void *>(event.function), event.priority, start);
+            }
+            else {
+                allow = event.function(std::forward<Args>(args) ...);
+            }
+        }
     }
 }
 
@@ -0,0 +1,92 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include <algorithm>
+#include <map>
+#include <utility>
+
+#include "event_profile.hpp"
+
+namespace Chimera {
+    bool event_profiler_enabled = false;
+
+    static std::vector<EventListenerProfile> profiles;
+    static std::map<std::pair<const char *, const void *>, std::size_t> profile_indices;
+
+    // Latencies under 16 ns get their own bucket. Past that, each power of two is split into 8 buckets, so any percentile is within 12.5%.
+    #define LINEAR_BUCKETS 16
+    #define SUB_BUCKET_BITS 3
+
+    static std::size_t histogram_bucket(std::uint64_t ns) noexcept {
+        if(ns < LINEAR_BUCKETS) {
+            return ns;
+        }
+        std::size_t exponent = 63;
+        while(!(ns & (static_cast<std::uint64_t>(1) << exponent))) {
+            exponent--;
+        }
+        std::size_t sub_bucket = (ns >> (exponent - SUB_BUCKET_BITS)) & ((1 << SUB_BUCKET_BITS) - 1);
+        std::size_t bucket = LINEAR_BUCKETS + ((exponent - 4) << SUB_BUCKET_BITS) + sub_bucket;
+        return std::min<std::size_t>(bucket, EVENT_PROFILE_HISTOGRAM_BUCKETS - 1);
+    }
+
+    static std::uint64_t histogram_bucket_ns(std::size_t bucket) noexcept {
+        if(bucket < LINEAR_BUCKETS) {
+            return bucket;
+        }
+        std::size_t exponent = ((bucket - LINEAR_BUCKETS) >> SUB_BUCKET_BITS) + 4;
+        std::size_t sub_bucket = (bucket - LINEAR_BUCKETS) & ((1 << SUB_BUCKET_BITS) - 1);
+        return (static_cast<std::uint64_t>(1) << exponent) + (static_cast<std::uint64_t>(sub_bucket) << (exponent - SUB_BUCKET_BITS));
+    }
+
+    std::uint64_t EventListenerProfile::percentile_ns(double percentile) const noexcept {
+        if(this->calls == 0) {
+            return 0;
+        }
+
+        // Find the bucket containing the nth call
+        auto nth = static_cast<std::uint64_t>(percentile / 100.0 * static_cast<double>(this->calls - 1)) + 1;
+        std::uint64_t seen = 0;
+        for(std::size_t b = 0; b < EVENT_PROFILE_HISTOGRAM_BUCKETS; b++) {
+            seen += this->histogram[b];
+            if(seen >= nth) {
+                return std::min(histogram_bucket_ns(b), this->max_ns);
+            }
+        }
+        return this->max_ns;
+    }
+
+    void record_event_call(const char *event_name, const void *function, EventPriority priority, std::chrono::steady_clock::time_point start) noexcept {
+        auto ns = static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+
+        // Find the profile, adding it if needed
+        auto key = std::make_pair(event_name, function);
+        auto index = profile_indices.find(key);
+        if(index == profile_indices.end()) {
+            EventListenerProfile profile = {};
+            profile.event_name = event_name;
+            profile.function = function;
+            index = profile_indices.emplace(key, profiles.size()).first;
+            profiles.emplace_back(profile);
+        }
+        auto &profile = profiles[index->second];
+
+        profile.priority = priority;
+        profile.calls++;
+        profile.total_ns += ns;
+        profile.max_ns = std::max(profile.max_ns, ns);
+        profile.histogram[histogram_bucket(ns)]++;
+    }
+
+    void set_event_profiler_enabled(bool enabled) noexcept {
+        event_profiler_enabled = enabled;
+    }
+
+    const std::vector<EventListenerProfile> &get_event_profiles() noexcept {
+        return profiles;
+    }
+
+    void reset_event_profiles() noexcept {
+        profiles.clear();
+        profile_indices.clear();
+    }
+}
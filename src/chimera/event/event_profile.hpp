@@ -0,0 +1,66 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#ifndef CHIMERA_EVENT_PROFILE_HPP
+#define CHIMERA_EVENT_PROFILE_HPP
+
+#include <cstdint>
+#include <vector>
+
+#include "event.hpp"
+
+namespace Chimera {
+    /** Number of buckets in each event listener's latency histogram */
+    #define EVENT_PROFILE_HISTOGRAM_BUCKETS 320
+
+    /**
+     * Timing information for a single function added to an event
+     */
+    struct EventListenerProfile {
+        /** Name of the event */
+        const char *event_name;
+
+        /** Function that was called */
+        const void *function;
+
+        /** Priority the function was last called with */
+        EventPriority priority;
+
+        /** Number of times the function was called */
+        std::uint64_t calls;
+
+        /** Total time spent in the function in nanoseconds */
+        std::uint64_t total_ns;
+
+        /** Longest time spent in a single call in nanoseconds */
+        std::uint64_t max_ns;
+
+        /** Number of calls in each latency bucket */
+        std::uint32_t histogram[EVENT_PROFILE_HISTOGRAM_BUCKETS];
+
+        /**
+         * Estimate a latency percentile from the histogram
+         * @param  percentile percentile from 0 to 100
+         * @return            latency in nanoseconds
+         */
+        std::uint64_t percentile_ns(double percentile) const noexcept;
+    };
+
+    /**
+     * Start or stop recording event timings. Existing timings are kept.
+     * @param enabled true to record
+     */
+    void set_event_profiler_enabled(bool enabled) noexcept;
+
+    /**
+     * Get the timings recorded so far
+     * @return timings, in the order the functions were first called
+     */
+    const std::vector<EventListenerProfile> &get_event_profiles() noexcept;
+
+    /**
+     * Discard all recorded timings
+     */
+    void reset_event_profiles() noexcept;
+}
+
+#endif
@@ -9,48 +9,32 @@
 namespace Chimera {
     static void enable_frame_hook();
 
-    static std::vector<Event<EventFunction>> preframe_events;
+    static EventList<EventFunction> preframe_events("preframe");
 
     void add_preframe_event(const EventFunction function, EventPriority priority) {
-        // Remove if exists
-        remove_preframe_event(function);
-
         // Enable frame hook if not enabled
         enable_frame_hook();
 
         // Add the event
-        preframe_events.emplace_back(Event<EventFunction> { function, priority });
+        preframe_events.add(function, priority);
     }
 
     void remove_preframe_event(const EventFunction function) {
-        for(std::size_t i = 0; i < preframe_events.size(); i++) {
-            if(preframe_events[i].function == function) {
-                preframe_events.erase(preframe_events.begin() + i);
-                return;
-            }
-        }
+        preframe_events.remove(function);
     }
 
-    static std::vector<Event<EventFunction>> frame_events;
+    static EventList<EventFunction> frame_events("frame");
 
     void add_frame_event(const EventFunction function, EventPriority priority) {
-        // Remove if exists
-        remove_frame_event(function);
-
         // Enable frame hook if not enabled
         enable_frame_hook();
 
         // Add the event
-        frame_events.emplace_back(Event<EventFunction> { function, priority });
+        frame_events.add(function, priority);
     }
 
     void remove_frame_event(const EventFunction function) {
-        for(std::size_t i = 0; i < frame_events.size(); i++) {
-            if(frame_events[i].function == function) {
-                frame_events.erase(frame_events.begin() + i);
-                return;
-            }
-        }
+        frame_events.remove(function);
     }
 
     static void on_preframe() {
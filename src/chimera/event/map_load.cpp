@@ -10,26 +10,18 @@
 namespace Chimera {
     static void enable_map_load_hook();
 
-    static std::vector<Event<EventFunction>> map_load_events;
+    static EventList<EventFunction> map_load_events("map_load");
 
     void add_map_load_event(const EventFunction function, EventPriority priority) {
-        // Remove if exists
-        remove_map_load_event(function);
-
         // Enable frame hook if not enabled
         enable_map_load_hook();
 
         // Add the event
-        map_load_events.emplace_back(Event<EventFunction> { function, priority });
+        map_load_events.add(function, priority);
     }
 
     void remove_map_load_event(const EventFunction function) {
-        for(std::size_t i = 0; i < map_load_events.size(); i++) {
-            if(map_load_events[i].function == function) {
-                map_load_events.erase(map_load_events.begin() + i);
-                return;
-            }
-        }
+        map_load_events.remove(function);
     }
 
     static void on_map_load() {
@@ -10,48 +10,32 @@
 namespace Chimera {
     static void enable_tick_hook();
 
-    static std::vector<Event<EventFunction>> pretick_events;
+    static EventList<EventFunction> pretick_events("pretick");
 
     void add_pretick_event(const EventFunction function, EventPriority priority) {
-        // Remove if exists
-        remove_pretick_event(function);
-
         // Enable tick hook if not enabled
         enable_tick_hook();
 
         // Add the event
-        pretick_events.emplace_back(Event<EventFunction> { function, priority });
+        pretick_events.add(function, priority);
     }
 
     void remove_pretick_event(const EventFunction function) {
-        for(std::size_t i = 0; i < pretick_events.size(); i++) {
-            if(pretick_events[i].function == function) {
-                pretick_events.erase(pretick_events.begin() + i);
-                return;
-            }
-        }
+        pretick_events.remove(function);
     }
 
-    static std::vector<Event<EventFunction>> tick_events;
+    static EventList<EventFunction> tick_events("tick");
 
     void add_tick_event(const EventFunction function, EventPriority priority) {
-        // Remove if exists
-        remove_tick_event(function);
-
         // Enable tick hook if not enabled
         enable_tick_hook();
 
         // Add the event
-        tick_events.emplace_back(Event<EventFunction> { function, priority });
+        tick_events.add(function, priority);
     }
 
     void remove_tick_event(const EventFunction function) {
-        for(std::size_t i = 0; i < tick_events.size(); i++) {
-            if(tick_events[i].function == function) {
-                tick_events.erase(tick_events.begin() + i);
-                return;
-            }
-        }
+        tick_events.remove(function);
     }
 
     static void on_pretick() {
@@ -5,6 +5,7 @@
 #include "../signature/signature.hpp"
 #include "../chimera.hpp"
 #include "../output/output.hpp"
+#include "../localization/localization.hpp"
 
 #include <cstdint>
 #include <memory>
@@ -69,49 +70,46 @@ namespace Chimera {
 
         auto &draw_distance_sig = get_chimera().get_signature("draw_distance_sig");
 
+        // Queue everything up so each page only gets unprotected once
+        PatchTransaction patch;
+
         // Chimera allocated a new BSP polygon array. We need to point to those.
-        overwrite(bsp_poly_1_sig.data() + 1, bsp_polies.get());
-        overwrite(bsp_poly_2_sig.data() + 1, bsp_polies.get());
-        overwrite(bsp_poly_3_sig.data() + 1, bsp_polies.get());
-        overwrite(bsp_poly_4_sig.data() + 1, bsp_polies.get());
-        overwrite(bsp_poly_5_sig.data() + 1, bsp_polies.get());
-        overwrite(bsp_poly_6_sig.data() + 1, bsp_polies.get());
-        overwrite(bsp_poly_7_sig.data() + 1, bsp_polies.get());
-        overwrite(bsp_poly_8_sig.data() + 1, bsp_polies.get());
-        overwrite(bsp_poly_9_sig.data() + 1, bsp_polies.get());
-        overwrite(bsp_poly_10_sig.data() + 1, bsp_polies.get());
-        overwrite(bsp_poly_11_sig.data() + 1, bsp_polies.get());
-        overwrite(bsp_poly_12_sig.data() + 1, bsp_polies.get());
-        overwrite(bsp_poly_13_sig.data() + 1, bsp_polies.get());
+        patch.overwrite(bsp_poly_1_sig.data() + 1, bsp_polies.get());
+        patch.overwrite(bsp_poly_2_sig.data() + 1, bsp_polies.get());
+        patch.overwrite(bsp_poly_3_sig.data() + 1, bsp_polies.get());
+        patch.overwrite(bsp_poly_4_sig.data() + 1, bsp_polies.get());
+        patch.overwrite(bsp_poly_5_sig.data() + 1, bsp_polies.get());
+        patch.overwrite(bsp_poly_6_sig.data() + 1, bsp_polies.get());
+        patch.overwrite(bsp_poly_7_sig.data() + 1, bsp_polies.get());
+        patch.overwrite(bsp_poly_8_sig.data() + 1, bsp_polies.get());
+        patch.overwrite(bsp_poly_9_sig.data() + 1, bsp_polies.get());
+        patch.overwrite(bsp_poly_10_sig.data() + 1, bsp_polies.get());
+        patch.overwrite(bsp_poly_11_sig.data() + 1, bsp_polies.get());
+        patch.overwrite(bsp_poly_12_sig.data() + 1, bsp_polies.get());
+        patch.overwrite(bsp_poly_13_sig.data() + 1, bsp_polies.get());
 
         // What I'm doing is making the polygon count a 32-bit integer
         extend_limits_polies_count = *reinterpret_cast<std::uint32_t **>(bsp_poly_count_sig.data() + 3);
-        overwrite(bsp_poly_count_sig.data(), static_cast<std::uint8_t>(0xFF));
-        overwrite(bsp_poly_count_sig.data() + 1, static_cast<std::uint8_t>(0x05));
-        overwrite(bsp_poly_count_sig.data() + 2, extend_limits_polies_count);
-        overwrite(bsp_poly_count_sig.data() + 6, static_cast<std::uint8_t>(0x90));
+        patch.overwrite(bsp_poly_count_sig.data(), static_cast<std::uint8_t>(0xFF));
+        patch.overwrite(bsp_poly_count_sig.data() + 1, static_cast<std::uint8_t>(0x05));
+        patch.overwrite(bsp_poly_count_sig.data() + 2, extend_limits_polies_count);
+        patch.overwrite(bsp_poly_count_sig.data() + 6, static_cast<std::uint8_t>(0x90));
 
         if(get_chimera().feature_present("client_bsp_poly_demo")) { //005076AD
             auto &bsp_poly_count_demo_sig = get_chimera().get_signature("bsp_poly_demo_sig");
-            overwrite(bsp_poly_count_demo_sig.data() + 1, bsp_polies.get());
+            patch.overwrite(bsp_poly_count_demo_sig.data() + 1, bsp_polies.get());
         }
 
         SigByte nop_bsp_limit[9] = { 0x90, 0x90, 0x90, 0x90, 0x90, 0x90, 0x90, 0x90, 0x90 };
-        write_code_s(bsp_poly_limit_1_sig.data(), nop_bsp_limit);
-        write_code_s(bsp_poly_limit_2_sig.data(), nop_bsp_limit);
-        write_code_s(bsp_poly_limit_3_sig.data(), nop_bsp_limit);
-        static Hook bsp_limit_1_hook;
-        static Hook bsp_limit_2_hook;
-        static Hook bsp_limit_3_hook;
-        write_function_override(bsp_poly_limit_1_sig.data(), bsp_limit_1_hook, reinterpret_cast<const void *>(extend_limits_cmp_1), &extend_limits_count_1);
-        write_function_override(bsp_poly_limit_2_sig.data(), bsp_limit_2_hook, reinterpret_cast<const void *>(extend_limits_cmp_2), &extend_limits_count_2);
-        write_function_override(bsp_poly_limit_3_sig.data(), bsp_limit_3_hook, reinterpret_cast<const void *>(extend_limits_cmp_3), &extend_limits_count_3);
+        patch.write_code(bsp_poly_limit_1_sig.data(), nop_bsp_limit);
+        patch.write_code(bsp_poly_limit_2_sig.data(), nop_bsp_limit);
+        patch.write_code(bsp_poly_limit_3_sig.data(), nop_bsp_limit);
 
         SigByte nop_movsx[3] = {0x90, 0x90, 0x90};
-        write_code_s(bsp_poly_movsx_sig.data(), nop_movsx);
+        patch.write_code(bsp_poly_movsx_sig.data(), nop_movsx);
 
         SigByte new_movsx[] =  { -1, -1, -1, 0x85, 0xFF, 0x90, -1, -1, -1, -1, -1, -1, -1, 0x8B, 0xD7, 0x90 };
-        write_code_s(bsp_poly_movsx_2_sig.data(), new_movsx);
+        patch.write_code(bsp_poly_movsx_2_sig.data(), new_movsx);
 
         bsp_render_1 = reinterpret_cast<const void *>(bsp_poly_bsp_render_calls_sig.data() + 5 + *reinterpret_cast<std::uintptr_t *>(bsp_poly_bsp_render_calls_sig.data() + 1));
         bsp_render_2 = reinterpret_cast<const void *>(bsp_poly_bsp_render_calls_sig.data() + 10 + *reinterpret_cast<std::uintptr_t *>(bsp_poly_bsp_render_calls_sig.data() + 6));
@@ -129,15 +127,29 @@ namespace Chimera {
         //overwrite(bsp_poly_limit_3_sig.data() + 0x7, static_cast<std::uint16_t>(BSP_POLY_LIMIT));
 
         // Bump up the visible object limit
-        overwrite(visible_object_list_1_sig.data() + 3, visible_objects.get());
-        overwrite(visible_object_list_2_sig.data() + 1, static_cast<std::uint32_t>(VISIBLE_OBJECT_LIMIT));
-        overwrite(visible_object_list_2_sig.data() + 5 + 1, visible_objects.get());
-        overwrite(visible_object_list_3_sig.data() + 3, visible_objects.get());
-        overwrite(visible_object_ptr_sig.data() + 3, visible_objects.get());
-        overwrite(visible_object_limit_1_sig.data() + 7, static_cast<std::uint16_t>(VISIBLE_OBJECT_LIMIT));
-        overwrite(visible_object_limit_2_sig.data() + 1, static_cast<std::uint32_t>(VISIBLE_OBJECT_LIMIT));
-
-        overwrite(draw_distance_sig.data() + 1, &MAXIMUM_DRAW_DISTANCE);
+        patch.overwrite(visible_object_list_1_sig.data() + 3, visible_objects.get());
+        patch.overwrite(visible_object_list_2_sig.data() + 1, static_cast<std::uint32_t>(VISIBLE_OBJECT_LIMIT));
+        patch.overwrite(visible_object_list_2_sig.data() + 5 + 1, visible_objects.get());
+        patch.overwrite(visible_object_list_3_sig.data() + 3, visible_objects.get());
+        patch.overwrite(visible_object_ptr_sig.data() + 3, visible_objects.get());
+        patch.overwrite(visible_object_limit_1_sig.data() + 7, static_cast<std::uint16_t>(VISIBLE_OBJECT_LIMIT));
+        patch.overwrite(visible_object_limit_2_sig.data() + 1, static_cast<std::uint32_t>(VISIBLE_OBJECT_LIMIT));
+
+        patch.overwrite(draw_distance_sig.data() + 1, &MAXIMUM_DRAW_DISTANCE);
+
+        // Write it all. The limit hooks read the NOPs we just wrote, so they have to go after this, and they can't go in at all if the
+        // NOPs didn't.
+        if(!patch.commit()) {
+            console_error(localize("chimera_error_patch_failed"), "extend_limits");
+            return;
+        }
+
+        static Hook bsp_limit_1_hook;
+        static Hook bsp_limit_2_hook;
+        static Hook bsp_limit_3_hook;
+        write_function_override(bsp_poly_limit_1_sig.data(), bsp_limit_1_hook, reinterpret_cast<const void *>(extend_limits_cmp_1), &extend_limits_count_1);
+        write_function_override(bsp_poly_limit_2_sig.data(), bsp_limit_2_hook, reinterpret_cast<const void *>(extend_limits_cmp_2), &extend_limits_count_2);
+        write_function_override(bsp_poly_limit_3_sig.data(), bsp_limit_3_hook, reinterpret_cast<const void *>(extend_limits_cmp_3), &extend_limits_count_3);
     }
 
     // Basically we're looping through all of the BSP polygons
@@ -9,6 +9,7 @@
 #include "../../halo_data/pause.hpp"
 #include "../../event/camera.hpp"
 #include "../../event/frame.hpp"
+#include "../../event/map_load.hpp"
 #include "../../event/tick.hpp"
 #include "../../halo_data/game_engine.hpp"
 #include "../../output/output.hpp"
@@ -73,6 +74,12 @@ namespace Chimera {
         }
     }
 
+    static void on_map_load() noexcept {
+        // Nothing from the last map can be interpolated, and the new map may have different limits.
+        interpolate_object_clear();
+        interpolate_particle_clear();
+    }
+
     static void on_frame() noexcept {
         if(game_paused()) {
             return;
@@ -92,6 +99,7 @@ namespace Chimera {
         add_tick_event(on_tick);
         add_preframe_event(on_preframe);
         add_frame_event(on_frame);
+        add_map_load_event(on_map_load);
         add_precamera_event(interpolate_camera_before);
         add_camera_event(interpolate_camera_after);
         write_jmp_call(fp_interp_ptr, fp_interp_hook, reinterpret_cast<const void *>(interpolate_fp_before), reinterpret_cast<const void *>(interpolate_fp_after));
@@ -103,6 +111,7 @@ namespace Chimera {
         remove_tick_event(on_tick);
         remove_preframe_event(on_preframe);
         remove_frame_event(on_frame);
+        remove_map_load_event(on_map_load);
         remove_precamera_event(interpolate_camera_before);
         remove_camera_event(interpolate_camera_after);
         interpolation_enabled = false;
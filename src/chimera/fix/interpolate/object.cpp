@@ -1,8 +1,11 @@
 // SPDX-License-Identifier: GPL-3.0-only
 
+#include <vector>
+
 #include "../../signature/signature.hpp"
 #include "../../halo_data/object.hpp"
-#include "../../math_trig/math_trig.hpp"
+#include "../../halo_data/object_index.hpp"
+#include "../../job/job.hpp"
 #include "../../chimera.hpp"
 
 #include "interpolate.hpp"
@@ -10,135 +13,60 @@
 #include "object.hpp"
 
 namespace Chimera {
-    #define OBJECT_BUFFER_SIZE 2048
-    struct InterpolatedObject {
-        /** Interpolate this object. */
-        bool interpolate = false;
-
-        /** This object was interpolated and needs to be uninterpolated. This is so we don't need to do so many checks twice. */
-        bool interpolated_this_frame = false;
-
-        /** This is the number of objects parented to this object. */
-        std::size_t children_count = 0;
-
-        /** These are the children that parent this object. */
-        std::size_t children[OBJECT_BUFFER_SIZE];
-
-        /** Tag ID of the object. */
-        TagID tag_id;
-
-        /** This is the position of the object's center. */
-        Point3D center;
-
-        /** This is the number of nodes this object has. */
-        std::size_t node_count;
-
-        /** These are the model nodes used by the object. */
-        ModelNode nodes[MAX_NODES];
-    };
+    static ObjectInterpolator interpolator;
 
-    // This is the object data to interpolate.
-    static InterpolatedObject object_buffers[2][OBJECT_BUFFER_SIZE] = {};
+    // These are the objects copied on the last tick. This is kept around so the next tick doesn't need to allocate anything.
+    static std::vector<InterpolatorObject> objects_to_copy;
 
-    // These are pointers to each buffer. These swap every tick.
-    static auto *current_tick = object_buffers[0];
-    static auto *previous_tick = object_buffers[1];
+    // If there are at least this many objects to interpolate, split them up between threads, this many objects at a time.
+    #define PARALLEL_OBJECT_THRESHOLD 128
+    #define PARALLEL_OBJECT_CHUNK_SIZE 32
 
     // If true, a tick has passed and it's time to re-copy the FP data.
     static bool tick_passed = false;
 
     static void copy_objects() noexcept;
-    static void interpolate_object(std::size_t);
+
+    // Find an object that was queued. The node count isn't needed since it was checked when the object was copied.
+    static bool find_object(std::size_t index, InterpolatorObject &object) {
+        auto *dynamic_object = ObjectTable::get_object_table().get_dynamic_object(index);
+        if(!dynamic_object) {
+            return false;
+        }
+        object.index = index;
+        object.tag_id = dynamic_object->tag_id;
+        object.biped = dynamic_object->type == ObjectType::OBJECT_TYPE_BIPED;
+        object.center = &dynamic_object->center_position;
+        object.nodes = dynamic_object->nodes();
+        object.node_count = 0;
+        return true;
+    }
 
     void interpolate_object_before() noexcept {
-        // Check if a tick has passed. If so, swap buffers and copy new objects.
+        // Check if a tick has passed. If so, copy new objects.
         if(tick_passed) {
-            if(current_tick == object_buffers[0]) {
-                current_tick = object_buffers[1];
-                previous_tick = object_buffers[0];
-            }
-            else {
-                current_tick = object_buffers[0];
-                previous_tick = object_buffers[1];
-            }
-
             copy_objects();
             tick_passed = false;
         }
 
         static auto **visible_object_count = reinterpret_cast<std::uint32_t **>(get_chimera().get_signature("visible_object_count_sig").data() + 3);
         static auto **visible_object_array = reinterpret_cast<ObjectID **>(get_chimera().get_signature("visible_object_ptr_sig").data() + 3);
-        auto current_count = **visible_object_count;
 
-        for(std::size_t i = 0; i < current_count; i++) {
-            interpolate_object((*visible_object_array)[i].index.index);
-        }
-    }
+        // Find everything we need to interpolate first.
+        auto &object_index = get_object_index();
+        interpolator.queue(*visible_object_array, **visible_object_count, object_index.children_start.data(), object_index.children.data(), find_object);
 
-    static void interpolate_object(std::size_t index) {
+        // Then interpolate it all, using other threads if there's enough to do.
         extern float interpolation_tick_progress;
-
-        // Don't interpolate out-of-bounds indices
-        if(index >= OBJECT_BUFFER_SIZE) {
-            return;
-        }
-
-        auto &current_tick_object = current_tick[index];
-        auto &previous_tick_object = previous_tick[index];
-
-        // Skip objects we can't interpolate or were already interpolated.
-        if(!current_tick_object.interpolate || !previous_tick_object.interpolate || current_tick_object.interpolated_this_frame || previous_tick_object.interpolated_this_frame) {
-            return;
-        }
-
-        auto *object = ObjectTable::get_object_table().get_dynamic_object(index);
-
-        // If for some reason the object ID is invalid, skip that too.
-        if(!object) {
-            return;
-        }
-
-        // Skip if the tags do not match
-        auto &tag_id = object->tag_id;
-        if(tag_id != current_tick_object.tag_id || previous_tick_object.tag_id != tag_id) {
-            return;
-        }
-
-        // Skip if the node counts don't match
-        if(previous_tick_object.node_count != current_tick_object.node_count) {
-            return;
-        }
-
-        // Set this flag so we don't need to do all these checks again when rolling things back.
-        current_tick_object.interpolated_this_frame = true;
-
-        // Search for all objects that parent this object.
-        for(std::size_t i = 0; i < current_tick_object.children_count; i++) {
-            interpolate_object(current_tick_object.children[i]);
+        auto interpolate_objects = [](std::size_t first, std::size_t last) {
+            interpolator.interpolate(first, last, interpolation_tick_progress);
+        };
+        auto count = interpolator.queued_count();
+        if(count < PARALLEL_OBJECT_THRESHOLD) {
+            interpolate_objects(0, count);
         }
-
-        // Interpolate the center thingymajigabobit.
-        interpolate_point(previous_tick_object.center, current_tick_object.center, object->center_position, interpolation_tick_progress);
-
-        auto *nodes = object->nodes();
-
-        for(std::size_t n = 0; n < current_tick_object.node_count; n++) {
-            auto &node = nodes[n];
-            auto &node_current = current_tick_object.nodes[n];
-            auto &node_before = previous_tick_object.nodes[n];
-
-            // Interpolate position
-            interpolate_point(node_before.position, node_current.position, node.position, interpolation_tick_progress);
-
-            // Interpolate scale
-            node.scale = node_before.scale + (node_current.scale - node_before.scale) * interpolation_tick_progress;
-
-            // Interpolate it all!
-            Quaternion orientation_current = node_current.rotation;
-            Quaternion orientation_before = node_before.rotation;
-            Quaternion orientation_interpolated;
-            interpolate_quat(orientation_before, orientation_current, orientation_interpolated, interpolation_tick_progress);
-            node.rotation = orientation_interpolated;
+        else {
+            run_parallel(count, PARALLEL_OBJECT_CHUNK_SIZE, interpolate_objects);
         }
     }
 
@@ -147,17 +75,16 @@ namespace Chimera {
         // Get the object table
         auto &object_table = ObjectTable::get_object_table();
 
-        // Go through all objects.
-        auto max_size = object_table.current_size;
-        for(std::size_t i = 0; i < OBJECT_BUFFER_SIZE; i++) {
-            auto &current_tick_object = current_tick[i];
-            current_tick_object.interpolated_this_frame = false;
-
-            // Set this to false so if it doesn't exist or we can't interpolate it for some reason, we don't have to worry about it.
-            current_tick_object.interpolate = false;
+        // Make sure there's room for every object. Interpolation may have been turned on after the map was loaded.
+        if(interpolator.max_objects() != object_table.max_elements) {
+            interpolate_object_clear();
+        }
 
-            // See if the object exists.
-            auto *object = object_table.get_dynamic_object(i);
+        // Go through all objects.
+        objects_to_copy.clear();
+        for(auto &object_id : get_object_index().objects) {
+            // See if the object still exists.
+            auto *object = object_table.get_dynamic_object(object_id);
             if(!object) {
                 continue;
             }
@@ -175,83 +102,41 @@ namespace Chimera {
             }
 
             // Get the number of model nodes.
-            current_tick_object.tag_id = object->tag_id;
-            auto *object_tag = get_tag(current_tick_object.tag_id.index.index);
-            if(!object_tag) {
+            auto &tag_id = object->tag_id;
+            if(!get_tag(tag_id.index.index)) {
                 continue;
             }
 
-            // Get the model tag to get the node count
-            if(object->type == ObjectType::OBJECT_TYPE_PROJECTILE) {
-                current_tick_object.node_count = 1;
-            }
-            else {
-                const auto &model_tag_id = *reinterpret_cast<const TagID *>(object_tag->data + 0x28 + 0xC);
-                auto *model_tag = get_tag(model_tag_id);
-                if(!model_tag) {
-                    current_tick_object.node_count = 0;
-                }
-                else {
-                    current_tick_object.node_count = *reinterpret_cast<std::uint32_t *>(model_tag->data + 0xB8);
-                }
-            }
-
-            // Copy nodes from Halo's data
-            std::copy(nodes, nodes + current_tick_object.node_count, current_tick_object.nodes);
-            current_tick_object.center = object->center_position;
-
-            // Bipeds get a max speed of 2.5 per tick before they aren't interpolated. Other objects get 7.5 world units.
-            static const float MAX_INTERPOLATION_DISTANCES[] = { 7.5*7.5, 2.5*2.5 };
-
-            // Let's check if the distance between the two points is too great (such as if the object was teleported).
-            current_tick_object.interpolate = distance_squared(current_tick_object.center, previous_tick[i].center) < MAX_INTERPOLATION_DISTANCES[object->type == OBJECT_TYPE_BIPED];
-
-            // Get any children of this object
-            current_tick_object.children_count = 0;
-            if(current_tick_object.interpolate) {
-                for(std::size_t o = 0; o < max_size && o < OBJECT_BUFFER_SIZE; o++) {
-                    auto *object = object_table.get_dynamic_object(o);
-                    if(object && object->parent.index.index == i) {
-                        current_tick_object.children[current_tick_object.children_count++] = o;
-                    }
-                }
-            }
+            objects_to_copy.push_back(InterpolatorObject { object_id.index.index, tag_id, object->type == ObjectType::OBJECT_TYPE_BIPED, &object->center_position, nodes, object->node_count() });
         }
+
+        // Copy nodes from Halo's data
+        interpolator.copy(objects_to_copy.data(), objects_to_copy.size());
     }
 
     void interpolate_object_after() noexcept {
-        auto &object_table = ObjectTable::get_object_table();
-        auto max_objects = object_table.current_size;
-        for(std::size_t i = 0; i < max_objects && i < OBJECT_BUFFER_SIZE; i++) {
-            auto &current_tick_object = current_tick[i];
-
-            // Skip if we didn't interpolate this frame.
-            if(!current_tick_object.interpolated_this_frame) {
-                continue;
-            }
-
-            // Unset so we can interpolate again next frame
-            current_tick_object.interpolated_this_frame = false;
-
-            auto *object = object_table.get_dynamic_object(i);
-
-            // This shouldn't ever happen but just in case it does...
-            if(!object) {
-                continue;
-            }
-
-            object->center_position = current_tick_object.center;
-            std::copy(current_tick_object.nodes, current_tick_object.nodes + current_tick_object.node_count, object->nodes());
+        // Put back everything we interpolated.
+        auto restore_objects = [](std::size_t first, std::size_t last) {
+            interpolator.restore(first, last);
+        };
+        auto count = interpolator.queued_count();
+        if(count < PARALLEL_OBJECT_THRESHOLD) {
+            restore_objects(0, count);
+        }
+        else {
+            run_parallel(count, PARALLEL_OBJECT_CHUNK_SIZE, restore_objects);
         }
+
+        // Unset so we can interpolate again next frame
+        interpolator.finish_frame();
     }
 
     void interpolate_object_clear() noexcept {
-        for(std::size_t i = 0; i < OBJECT_BUFFER_SIZE; i++) {
-            current_tick[i].interpolate = false;
-            previous_tick[i].interpolate = false;
-            current_tick[i].interpolated_this_frame = false;
-            previous_tick[i].interpolated_this_frame = false;
-        }
+        interpolator.clear(ObjectTable::get_object_table().max_elements);
+    }
+
+    const InterpolateObjectStatistics &interpolate_object_statistics() noexcept {
+        return interpolator.statistics();
     }
 
     void interpolate_object_on_tick() noexcept {
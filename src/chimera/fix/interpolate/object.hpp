@@ -3,6 +3,8 @@
 #ifndef CHIMERA_INTERPOLATE_OBJECT_HPP
 #define CHIMERA_INTERPOLATE_OBJECT_HPP
 
+#include "object_interpolator.hpp"
+
 namespace Chimera {
     /**
      * Interpolate objects.
@@ -15,7 +17,7 @@ namespace Chimera {
     void interpolate_object_after() noexcept;
 
     /**
-     * Clear the buffers. This should be done if changing the interpolation setting.
+     * Clear the buffers and size them for the object table. This should be done when a map is loaded.
      */
     void interpolate_object_clear() noexcept;
 
@@ -23,6 +25,12 @@ namespace Chimera {
      * Set the tick flag, swapping buffers for the next tick.
      */
     void interpolate_object_on_tick() noexcept;
+
+    /**
+     * Get counts of what object interpolation did on the last tick and frame.
+     * @return statistics
+     */
+    const InterpolateObjectStatistics &interpolate_object_statistics() noexcept;
 }
 
 #endif
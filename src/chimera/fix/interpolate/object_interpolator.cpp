@@ -0,0 +1,249 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include <algorithm>
+#include <cstring>
+
+#include "object_interpolator.hpp"
+
+namespace Chimera {
+    // This is returned by Buffer::find() if the object wasn't copied.
+    #define OBJECT_NOT_COPIED static_cast<std::size_t>(-1)
+
+    /**
+     * Find an object
+     * @param  index object table index; this must be less than the size of the object table
+     * @return       position of the object or OBJECT_NOT_COPIED if it wasn't copied
+     */
+    std::size_t ObjectInterpolator::Buffer::find(std::size_t index) const noexcept {
+        std::size_t position = this->position[index];
+        if(position < this->size() && this->object_index[position] == index) {
+            return position;
+        }
+        return OBJECT_NOT_COPIED;
+    }
+
+    /**
+     * Add an object
+     * @param index       object table index
+     * @param tag_id      tag ID of the object
+     * @param center      center of the object
+     * @param nodes       nodes of the object
+     * @param node_count  number of nodes to copy
+     * @param interpolate whether to interpolate the object
+     * @param rotations   if the object hasn't changed since the last tick, these are its node rotations from the last tick; otherwise
+     *                    this is nullptr, and the rotations are converted from the nodes
+     */
+    void ObjectInterpolator::Buffer::add(std::size_t index, const TagID &tag_id, const Point3D &center, const ModelNode *nodes, std::size_t node_count, bool interpolate, const Quaternion *rotations) {
+        this->position[index] = this->size();
+        this->object_index.push_back(index);
+        this->interpolate.push_back(interpolate);
+        this->interpolated_this_frame.push_back(false);
+        this->unchanged.push_back(rotations != nullptr);
+        this->tag_id.push_back(tag_id);
+        this->center.push_back(center);
+        this->nodes.insert(this->nodes.end(), nodes, nodes + node_count);
+        if(rotations) {
+            this->node_rotations.insert(this->node_rotations.end(), rotations, rotations + node_count);
+        }
+        else {
+            for(std::size_t n = 0; n < node_count; n++) {
+                this->node_rotations.emplace_back(nodes[n].rotation);
+            }
+        }
+        this->first_node.push_back(this->nodes.size());
+    }
+
+    /**
+     * Remove all objects. This keeps the memory allocated so the next tick doesn't need to allocate anything.
+     */
+    void ObjectInterpolator::Buffer::clear() noexcept {
+        this->object_index.clear();
+        this->interpolate.clear();
+        this->interpolated_this_frame.clear();
+        this->unchanged.clear();
+        this->tag_id.clear();
+        this->center.clear();
+        this->first_node.resize(1);
+        this->nodes.clear();
+        this->node_rotations.clear();
+    }
+
+    /**
+     * Remove all objects and make room for a different number of objects.
+     * @param max_objects maximum number of objects
+     */
+    void ObjectInterpolator::Buffer::resize(std::size_t max_objects) {
+        this->clear();
+        this->position.assign(max_objects, 0);
+    }
+
+    void ObjectInterpolator::clear(std::size_t max_objects) {
+        this->p_max_objects = max_objects;
+        this->p_current_tick->resize(max_objects);
+        this->p_previous_tick->resize(max_objects);
+        this->p_frame_objects.clear();
+    }
+
+    void ObjectInterpolator::copy(const InterpolatorObject *objects, std::size_t count) {
+        // Swap buffers and start over. If we don't copy an object for some reason, we can't interpolate it.
+        std::swap(this->p_current_tick, this->p_previous_tick);
+        auto &current_tick = *this->p_current_tick;
+        auto &previous_tick = *this->p_previous_tick;
+        current_tick.clear();
+        this->p_statistics.copied = 0;
+        this->p_statistics.unchanged = 0;
+
+        // Bipeds get a max speed of 2.5 per tick before they aren't interpolated. Other objects get 7.5 world units.
+        static const float MAX_INTERPOLATION_DISTANCES[] = { 7.5*7.5, 2.5*2.5 };
+
+        for(std::size_t o = 0; o < count; o++) {
+            auto &object = objects[o];
+            auto i = object.index;
+            auto &center = *object.center;
+            auto *nodes = object.nodes;
+            auto node_count = object.node_count;
+
+            // Let's check if the distance between the two points is too great (such as if the object was teleported). If we didn't copy
+            // it last tick, there's nothing to interpolate from.
+            auto previous = previous_tick.find(i);
+            bool interpolate = previous != OBJECT_NOT_COPIED && distance_squared(center, previous_tick.center[previous]) < MAX_INTERPOLATION_DISTANCES[object.biped];
+
+            // Check if anything moved since the last tick. Stationary objects such as scenery, parked vehicles, and dropped weapons
+            // don't need to be interpolated, and we can reuse their rotations rather than converting them again.
+            const Quaternion *unchanged_rotations = nullptr;
+            if(interpolate && previous_tick.tag_id[previous] == object.tag_id && previous_tick.node_count(previous) == node_count) {
+                auto first_node = previous_tick.first_node[previous];
+                if(std::memcmp(&previous_tick.center[previous], &center, sizeof(center)) == 0 && std::memcmp(previous_tick.nodes.data() + first_node, nodes, sizeof(*nodes) * node_count) == 0) {
+                    unchanged_rotations = previous_tick.node_rotations.data() + first_node;
+                    this->p_statistics.unchanged++;
+                }
+            }
+
+            current_tick.add(i, object.tag_id, center, nodes, node_count, interpolate, unchanged_rotations);
+            this->p_statistics.copied++;
+        }
+    }
+
+    void ObjectInterpolator::queue(const ObjectID *visible, std::size_t visible_count, const std::uint16_t *children_start, const std::uint16_t *children, InterpolatorFindObject find_object) {
+        this->p_frame_objects.clear();
+        this->p_statistics.skipped = 0;
+        for(std::size_t i = 0; i < visible_count; i++) {
+            this->queue_object(visible[i].index.index, children_start, children, find_object);
+        }
+        this->p_statistics.interpolated = this->p_frame_objects.size();
+    }
+
+    void ObjectInterpolator::queue_object(std::size_t index, const std::uint16_t *children_start, const std::uint16_t *children, InterpolatorFindObject find_object) {
+        // Don't interpolate out-of-bounds indices
+        if(index >= this->p_max_objects) {
+            return;
+        }
+
+        // Skip objects we can't interpolate or were already interpolated.
+        auto &current_tick = *this->p_current_tick;
+        auto &previous_tick = *this->p_previous_tick;
+        auto current = current_tick.find(index);
+        if(current == OBJECT_NOT_COPIED || !current_tick.interpolate[current] || current_tick.interpolated_this_frame[current]) {
+            return;
+        }
+        auto previous = previous_tick.find(index);
+        if(previous == OBJECT_NOT_COPIED || !previous_tick.interpolate[previous]) {
+            return;
+        }
+
+        // If for some reason the object ID is invalid, skip that too.
+        InterpolatorObject object;
+        if(!find_object(index, object)) {
+            return;
+        }
+
+        // Skip if the tags do not match
+        auto &tag_id = object.tag_id;
+        if(tag_id != current_tick.tag_id[current] || previous_tick.tag_id[previous] != tag_id) {
+            return;
+        }
+
+        // Skip if the node counts don't match
+        auto node_count = current_tick.node_count(current);
+        if(previous_tick.node_count(previous) != node_count) {
+            return;
+        }
+
+        // Set this flag so we don't queue it again if it comes up twice.
+        current_tick.interpolated_this_frame[current] = true;
+
+        // Interpolate all objects parented to this object.
+        for(std::size_t i = children_start[index]; i < children_start[index + 1]; i++) {
+            this->queue_object(children[i], children_start, children, find_object);
+        }
+
+        // If it hasn't moved, it's already where it would be interpolated to.
+        if(current_tick.unchanged[current]) {
+            this->p_statistics.skipped++;
+            return;
+        }
+
+        this->p_frame_objects.push_back(FrameObject { object.center, object.nodes, static_cast<std::uint16_t>(current), static_cast<std::uint16_t>(previous) });
+    }
+
+    void ObjectInterpolator::interpolate(std::size_t first, std::size_t last, float progress) noexcept {
+        auto &current_tick = *this->p_current_tick;
+        auto &previous_tick = *this->p_previous_tick;
+
+        for(std::size_t i = first; i < last; i++) {
+            auto &frame_object = this->p_frame_objects[i];
+            auto current = frame_object.current;
+            auto previous = frame_object.previous;
+            auto node_count = current_tick.node_count(current);
+
+            // Interpolate the center thingymajigabobit.
+            interpolate_point(previous_tick.center[previous], current_tick.center[current], *frame_object.center, progress);
+
+            auto *nodes = frame_object.nodes;
+            const auto *nodes_current = current_tick.nodes.data() + current_tick.first_node[current];
+            const auto *nodes_before = previous_tick.nodes.data() + previous_tick.first_node[previous];
+            const auto *rotations_current = current_tick.node_rotations.data() + current_tick.first_node[current];
+            const auto *rotations_before = previous_tick.node_rotations.data() + previous_tick.first_node[previous];
+
+            // Interpolate the rotations a batch at a time. Any that are too far apart to interpolate are left as is.
+            for(std::size_t batch = 0; batch < node_count; batch += MAX_NODES) {
+                std::size_t batch_count = std::min<std::size_t>(node_count - batch, MAX_NODES);
+                Quaternion rotations_interpolated[MAX_NODES];
+                interpolate_quats(rotations_before + batch, rotations_current + batch, rotations_interpolated, batch_count, progress);
+
+                for(std::size_t n = 0; n < batch_count; n++) {
+                    auto &node = nodes[batch + n];
+                    auto &node_current = nodes_current[batch + n];
+                    auto &node_before = nodes_before[batch + n];
+
+                    // Interpolate position
+                    interpolate_point(node_before.position, node_current.position, node.position, progress);
+
+                    // Interpolate scale
+                    node.scale = node_before.scale + (node_current.scale - node_before.scale) * progress;
+
+                    // Interpolate it all!
+                    node.rotation = rotations_interpolated[n];
+                }
+            }
+        }
+    }
+
+    void ObjectInterpolator::restore(std::size_t first, std::size_t last) noexcept {
+        auto &buffer = *this->p_current_tick;
+        for(std::size_t i = first; i < last; i++) {
+            auto &frame_object = this->p_frame_objects[i];
+            auto current = frame_object.current;
+            *frame_object.center = buffer.center[current];
+            std::copy(buffer.nodes.data() + buffer.first_node[current], buffer.nodes.data() + buffer.first_node[current + 1], frame_object.nodes);
+        }
+    }
+
+    void ObjectInterpolator::finish_frame() noexcept {
+        this->p_frame_objects.clear();
+
+        // Unset so we can interpolate again next frame
+        auto &interpolated_this_frame = this->p_current_tick->interpolated_this_frame;
+        std::fill(interpolated_this_frame.begin(), interpolated_this_frame.end(), false);
+    }
+}
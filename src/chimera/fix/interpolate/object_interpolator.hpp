@@ -0,0 +1,229 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#ifndef CHIMERA_OBJECT_INTERPOLATOR_HPP
+#define CHIMERA_OBJECT_INTERPOLATOR_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "../../halo_data/model_node.hpp"
+#include "../../halo_data/type.hpp"
+#include "../../math_trig/math_trig.hpp"
+
+namespace Chimera {
+    /**
+     * Counts of what object interpolation did
+     */
+    struct InterpolateObjectStatistics {
+        /** Number of objects copied on the last tick */
+        std::size_t copied;
+
+        /** Number of objects copied on the last tick that hadn't moved since the tick before */
+        std::size_t unchanged;
+
+        /** Number of objects interpolated on the last frame */
+        std::size_t interpolated;
+
+        /** Number of objects skipped on the last frame because they hadn't moved */
+        std::size_t skipped;
+    };
+
+    /**
+     * An object as object interpolation sees it. The center and nodes point to wherever the object actually is, and interpolating an
+     * object writes to them.
+     */
+    struct InterpolatorObject {
+        /** Object table index */
+        std::size_t index;
+
+        /** Tag ID of the object */
+        TagID tag_id;
+
+        /** Bipeds can't move as far in one tick before they stop being interpolated */
+        bool biped;
+
+        /** Center of the object */
+        Point3D *center;
+
+        /** Nodes of the object */
+        ModelNode *nodes;
+
+        /** Number of nodes */
+        std::size_t node_count;
+    };
+
+    /**
+     * Find an object by its index.
+     * @param  index  object table index
+     * @param  object object to write to; only the tag ID, center, and nodes are used, since the rest was checked when it was copied
+     * @return        true if the object exists
+     */
+    using InterpolatorFindObject = bool (*)(std::size_t index, InterpolatorObject &object);
+
+    /**
+     * Object interpolation without anything that depends on where the objects come from. Each tick, the objects are copied; each frame,
+     * objects are queued, interpolated, and then restored before the next tick.
+     */
+    class ObjectInterpolator {
+    public:
+        /**
+         * Forget everything copied and make room for a different number of objects.
+         * @param max_objects maximum number of objects (the size of the object table)
+         */
+        void clear(std::size_t max_objects);
+
+        /**
+         * Get the maximum number of objects
+         * @return maximum number of objects
+         */
+        std::size_t max_objects() const noexcept {
+            return this->p_max_objects;
+        }
+
+        /**
+         * Start a new tick, copying the objects that can be interpolated. An object is only interpolated if it was close enough to where
+         * it was on the tick before on both this tick and the last one, so anything not copied isn't interpolated again for two ticks.
+         * @param objects objects to copy in index order; indices must be less than max_objects()
+         * @param count   number of objects
+         */
+        void copy(const InterpolatorObject *objects, std::size_t count);
+
+        /**
+         * Find the objects to interpolate this frame. Children of each object are interpolated along with it.
+         * @param visible        IDs of visible objects
+         * @param visible_count  number of visible objects
+         * @param children_start the children of the object at index p are children[children_start[p]] through
+         *                       children[children_start[p + 1] - 1]; this has max_objects() + 1 elements
+         * @param children       children of each object
+         * @param find_object    function to get objects by index
+         */
+        void queue(const ObjectID *visible, std::size_t visible_count, const std::uint16_t *children_start, const std::uint16_t *children, InterpolatorFindObject find_object);
+
+        /**
+         * Get the number of objects queued this frame
+         * @return number of objects queued
+         */
+        std::size_t queued_count() const noexcept {
+            return this->p_frame_objects.size();
+        }
+
+        /**
+         * Interpolate queued objects first through last - 1. Each object only touches its own memory, so different ranges can be
+         * interpolated at the same time.
+         * @param first    first queued object
+         * @param last     one past the last queued object
+         * @param progress progress since the last tick (0.0 - 1.0)
+         */
+        void interpolate(std::size_t first, std::size_t last, float progress) noexcept;
+
+        /**
+         * Put queued objects first through last - 1 back where they were on the last tick. Like interpolate(), different ranges can be
+         * restored at the same time.
+         * @param first first queued object
+         * @param last  one past the last queued object
+         */
+        void restore(std::size_t first, std::size_t last) noexcept;
+
+        /**
+         * Finish the frame so objects can be queued again next frame. Restore everything that was interpolated first.
+         */
+        void finish_frame() noexcept;
+
+        /**
+         * Get counts of what was done on the last tick and frame
+         * @return statistics
+         */
+        const InterpolateObjectStatistics &statistics() const noexcept {
+            return this->p_statistics;
+        }
+
+    private:
+        /**
+         * This is the object data for one tick. Only objects that were copied are stored, and they are stored as parallel arrays so
+         * copying and checking objects only touches what's needed. Nodes are stored back-to-back, so each object only takes as many as it
+         * has.
+         */
+        struct Buffer {
+            /** This is the position of each object in the arrays below. It is only valid if object_index agrees, so it never needs clearing. */
+            std::vector<std::uint16_t> position;
+
+            /** These are the object table indices of the objects. */
+            std::vector<std::uint16_t> object_index;
+
+            /** Interpolate this object. */
+            std::vector<std::uint8_t> interpolate;
+
+            /** This object was interpolated and needs to be uninterpolated. This is so we don't need to do so many checks twice. */
+            std::vector<std::uint8_t> interpolated_this_frame;
+
+            /** This object hasn't moved since the last tick, so there is nothing to interpolate. */
+            std::vector<std::uint8_t> unchanged;
+
+            /** Tag ID of the object. */
+            std::vector<TagID> tag_id;
+
+            /** This is the position of the object's center. */
+            std::vector<Point3D> center;
+
+            /** This is the first node of each object in nodes. There is one more element than objects, so an object's nodes end where the next one's start. */
+            std::vector<std::uint32_t> first_node = { 0 };
+
+            /** These are the model nodes used by the objects. */
+            std::vector<ModelNode> nodes;
+
+            /** These are the rotations of each node as quaternions. These are converted once per tick rather than every frame. */
+            std::vector<Quaternion> node_rotations;
+
+            std::size_t size() const noexcept {
+                return this->object_index.size();
+            }
+
+            std::size_t find(std::size_t index) const noexcept;
+
+            std::size_t node_count(std::size_t position) const noexcept {
+                return this->first_node[position + 1] - this->first_node[position];
+            }
+
+            void add(std::size_t index, const TagID &tag_id, const Point3D &center, const ModelNode *nodes, std::size_t node_count, bool interpolate, const Quaternion *rotations);
+            void clear() noexcept;
+            void resize(std::size_t max_objects);
+        };
+
+        /** This is an object being interpolated this frame. */
+        struct FrameObject {
+            /** Where the object is */
+            Point3D *center;
+            ModelNode *nodes;
+
+            /** Position of the object in each buffer */
+            std::uint16_t current;
+            std::uint16_t previous;
+        };
+
+        /** Object data for the last two ticks. These swap every tick. */
+        Buffer p_buffers[2];
+        Buffer *p_current_tick = p_buffers + 0;
+        Buffer *p_previous_tick = p_buffers + 1;
+
+        /** Maximum number of objects */
+        std::size_t p_max_objects = 0;
+
+        /** Objects being interpolated this frame */
+        std::vector<FrameObject> p_frame_objects;
+
+        /** Counts of what we did on the last tick and frame */
+        InterpolateObjectStatistics p_statistics = {};
+
+        /**
+         * Queue an object and its children
+         * @param index          object table index
+         * @param children_start see queue()
+         * @param children       see queue()
+         * @param find_object    see queue()
+         */
+        void queue_object(std::size_t index, const std::uint16_t *children_start, const std::uint16_t *children, InterpolatorFindObject find_object);
+    };
+}
+
+#endif
@@ -15,7 +15,7 @@ namespace Chimera {
     void interpolate_particle_after() noexcept;
 
     /**
-     * Clear the buffers. This should be done if changing the interpolation setting.
+     * Clear the buffers and size them for the particle table. This should be done when a map is loaded.
      */
     void interpolate_particle_clear() noexcept;
 
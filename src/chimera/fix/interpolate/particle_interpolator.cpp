@@ -0,0 +1,97 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include <algorithm>
+
+#include "particle_interpolator.hpp"
+
+namespace Chimera {
+    // Get the position of a particle in a table with the given stride.
+    static Point3D &particle_position(Point3D *positions, std::size_t stride, std::size_t index) noexcept {
+        return *reinterpret_cast<Point3D *>(reinterpret_cast<std::uint8_t *>(positions) + index * stride);
+    }
+
+    void ParticleInterpolator::clear(std::size_t max_particles) {
+        this->p_max_particles = max_particles;
+        for(auto &snapshot : this->p_snapshots) {
+            snapshot.count = 0;
+            snapshot.x.assign(max_particles, 0.0F);
+            snapshot.y.assign(max_particles, 0.0F);
+            snapshot.z.assign(max_particles, 0.0F);
+            snapshot.interpolate.assign((max_particles + MASK_BITS - 1) / MASK_BITS, 0);
+        }
+        this->p_current_tick = this->p_snapshots + 0;
+        this->p_previous_tick = this->p_snapshots + 1;
+    }
+
+    std::size_t ParticleInterpolator::begin_tick(std::size_t count) noexcept {
+        std::swap(this->p_current_tick, this->p_previous_tick);
+
+        // Copy only the particles that fit.
+        count = std::min(count, this->p_max_particles);
+        auto &snapshot = *this->p_current_tick;
+        snapshot.count = count;
+        std::fill_n(snapshot.interpolate.begin(), (count + MASK_BITS - 1) / MASK_BITS, 0);
+        return count;
+    }
+
+    std::size_t ParticleInterpolator::interpolated_count(std::size_t table_size) const noexcept {
+        return std::min<std::size_t>({ this->p_current_tick->count, this->p_previous_tick->count, table_size });
+    }
+
+    std::uint32_t ParticleInterpolator::interpolated_mask(std::size_t first, std::size_t count) const noexcept {
+        auto word = first / MASK_BITS;
+        auto mask = this->p_current_tick->interpolate[word] & this->p_previous_tick->interpolate[word];
+
+        // The last group may go past the end of either snapshot.
+        if(count - first < MASK_BITS) {
+            mask &= (1U << (count - first)) - 1;
+        }
+
+        return mask;
+    }
+
+    void ParticleInterpolator::interpolate(Point3D *positions, std::size_t stride, std::size_t table_size, float progress) const noexcept {
+        auto &current_tick = *this->p_current_tick;
+        auto &previous_tick = *this->p_previous_tick;
+        auto count = this->interpolated_count(table_size);
+
+        // Go through each group of particles, skipping groups where nothing can be interpolated.
+        for(std::size_t first = 0; first < count; first += MASK_BITS) {
+            auto mask = this->interpolated_mask(first, count);
+            if(!mask) {
+                continue;
+            }
+
+            // Interpolate the whole group at once, then write back only the particles that can be interpolated.
+            auto group_size = std::min<std::size_t>(MASK_BITS, count - first);
+            float x[MASK_BITS], y[MASK_BITS], z[MASK_BITS];
+            interpolate_floats(previous_tick.x.data() + first, current_tick.x.data() + first, x, group_size, progress);
+            interpolate_floats(previous_tick.y.data() + first, current_tick.y.data() + first, y, group_size, progress);
+            interpolate_floats(previous_tick.z.data() + first, current_tick.z.data() + first, z, group_size, progress);
+
+            for(; mask; mask &= mask - 1) {
+                auto i = static_cast<std::size_t>(__builtin_ctz(mask));
+                auto &position = particle_position(positions, stride, first + i);
+                position.x = x[i];
+                position.y = y[i];
+                position.z = z[i];
+            }
+        }
+    }
+
+    void ParticleInterpolator::restore(Point3D *positions, std::size_t stride, std::size_t table_size) const noexcept {
+        auto &current_tick = *this->p_current_tick;
+        auto count = this->interpolated_count(table_size);
+
+        // Restore each position.
+        for(std::size_t first = 0; first < count; first += MASK_BITS) {
+            for(auto mask = this->interpolated_mask(first, count); mask; mask &= mask - 1) {
+                auto i = first + static_cast<std::size_t>(__builtin_ctz(mask));
+                auto &position = particle_position(positions, stride, i);
+                position.x = current_tick.x[i];
+                position.y = current_tick.y[i];
+                position.z = current_tick.z[i];
+            }
+        }
+    }
+}
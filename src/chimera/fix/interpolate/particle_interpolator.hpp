@@ -0,0 +1,114 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#ifndef CHIMERA_PARTICLE_INTERPOLATOR_HPP
+#define CHIMERA_PARTICLE_INTERPOLATOR_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "../../math_trig/math_trig.hpp"
+
+namespace Chimera {
+    /**
+     * Particle interpolation without anything that depends on where the particles come from. Particle positions are passed as a pointer to
+     * the first particle's position and the distance in bytes between each particle, so this works on a table of larger structs.
+     */
+    class ParticleInterpolator {
+    public:
+        /**
+         * Forget everything copied and make room for a different number of particles.
+         * @param max_particles maximum number of particles (the size of the particle table)
+         */
+        void clear(std::size_t max_particles);
+
+        /**
+         * Get the maximum number of particles
+         * @return maximum number of particles
+         */
+        std::size_t max_particles() const noexcept {
+            return this->p_max_particles;
+        }
+
+        /**
+         * Start a new tick. Particles 0 through count - 1 should then be copied with copy().
+         * @param  count number of particles in the table
+         * @return       number of particles to copy
+         */
+        std::size_t begin_tick(std::size_t count) noexcept;
+
+        /**
+         * Copy a particle. This must be called for every particle before the count returned by begin_tick().
+         * @param index       particle index
+         * @param position    position of the particle
+         * @param interpolate whether to interpolate the particle
+         */
+        void copy(std::size_t index, const Point3D &position, bool interpolate) noexcept {
+            auto &snapshot = *this->p_current_tick;
+            snapshot.x[index] = position.x;
+            snapshot.y[index] = position.y;
+            snapshot.z[index] = position.z;
+            if(interpolate) {
+                snapshot.interpolate[index / MASK_BITS] |= 1U << (index % MASK_BITS);
+            }
+        }
+
+        /**
+         * Interpolate every particle that can be interpolated.
+         * @param positions  position of the first particle
+         * @param stride     distance in bytes between each particle's position
+         * @param table_size number of particles in the table now
+         * @param progress   progress since the last tick (0.0 - 1.0)
+         */
+        void interpolate(Point3D *positions, std::size_t stride, std::size_t table_size, float progress) const noexcept;
+
+        /**
+         * Put every interpolated particle back where it was on the last tick.
+         * @param positions  position of the first particle
+         * @param stride     distance in bytes between each particle's position
+         * @param table_size number of particles in the table now
+         */
+        void restore(Point3D *positions, std::size_t stride, std::size_t table_size) const noexcept;
+
+    private:
+        /** Number of particles in each word of the interpolate mask */
+        static constexpr std::size_t MASK_BITS = 32;
+
+        /**
+         * Particles are stored as arrays of coordinates so they can be interpolated with SIMD. Bit i of interpolate is set if particle i can
+         * be interpolated. Only the first count particles were copied; anything past that is garbage.
+         */
+        struct Snapshot {
+            std::size_t count = 0;
+            std::vector<float> x;
+            std::vector<float> y;
+            std::vector<float> z;
+            std::vector<std::uint32_t> interpolate;
+        };
+
+        /** Particle data for the last two ticks. These swap every tick. */
+        Snapshot p_snapshots[2];
+        Snapshot *p_current_tick = p_snapshots + 0;
+        Snapshot *p_previous_tick = p_snapshots + 1;
+
+        /** Maximum number of particles */
+        std::size_t p_max_particles = 0;
+
+        /**
+         * Get the number of particles that are in both snapshots and still in the table.
+         * @param  table_size number of particles in the table now
+         * @return            number of particles
+         */
+        std::size_t interpolated_count(std::size_t table_size) const noexcept;
+
+        /**
+         * Get which particles in the group starting at first can be interpolated.
+         * @param  first first particle of the group
+         * @param  count number of particles that can be interpolated
+         * @return       bit i is set if first + i can be interpolated
+         */
+        std::uint32_t interpolated_mask(std::size_t first, std::size_t count) const noexcept;
+    };
+}
+
+#endif
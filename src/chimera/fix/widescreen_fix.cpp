@@ -11,6 +11,7 @@
 #include "../signature/hook.hpp"
 #include "../event/tick.hpp"
 #include "../output/output.hpp"
+#include "../localization/localization.hpp"
 #include "../halo_data/hud_fonts.hpp"
 
 #include "../halo_data/tag.hpp"
@@ -591,7 +592,9 @@ namespace Chimera {
         widescreen_width_480p = aspect_ratio * 480.0f;
 
         if(*console_width != static_cast<std::int32_t>(widescreen_width_480p)) {
-            overwrite(scope_width, widescreen_width_480p);
+            // Queue everything up so each page only gets unprotected once
+            PatchTransaction patch;
+            patch.overwrite(scope_width, widescreen_width_480p);
 
             // Calculate mouse cursor bounds
             std::int32_t mouse_increase = (static_cast<std::int32_t>(widescreen_width_480p) - 640) / 2;
@@ -600,35 +603,44 @@ namespace Chimera {
             *widescreen_mouse_x = widescreen_mouse_left_bounds;
 
             float half_width_inverted = 2.0 / (aspect_ratio * 480.0f);
-            overwrite(hud_element_scaling, half_width_inverted);
-            overwrite(text_scaling, half_width_inverted);
-            overwrite(motion_sensor_scaling, half_width_inverted);
+            patch.overwrite(hud_element_scaling, half_width_inverted);
+            patch.overwrite(text_scaling, half_width_inverted);
+            patch.overwrite(motion_sensor_scaling, half_width_inverted);
 
-            overwrite(console_width, static_cast<std::int32_t>(widescreen_width_480p));
-            overwrite(text_max_x, static_cast<std::uint32_t>(widescreen_width_480p));
+            patch.overwrite(console_width, static_cast<std::int32_t>(widescreen_width_480p));
+            patch.overwrite(text_max_x, static_cast<std::uint32_t>(widescreen_width_480p));
 
             if(f1 && !hud_text_mod_initialized()) {
-                overwrite(f1_server_ip_x2, static_cast<std::uint16_t>(widescreen_width_480p - 5));
-                overwrite(f1_server_name_x2, static_cast<std::uint16_t>(widescreen_width_480p - 5));
+                patch.overwrite(f1_server_ip_x2, static_cast<std::uint16_t>(widescreen_width_480p - 5));
+                patch.overwrite(f1_server_name_x2, static_cast<std::uint16_t>(widescreen_width_480p - 5));
             }
 
             if(ce) {
-                overwrite(f2_motd_x, static_cast<std::int16_t>(widescreen_width_480p - 640.0f + 625));
-                overwrite(f2_heading_x, static_cast<std::int16_t>((widescreen_width_480p - 640.0f) / 2 + 630));
-                overwrite(f2_motd_body_x1, static_cast<std::int16_t>((widescreen_width_480p - 640.0f) / 2 + 105));
-                overwrite(f2_motd_body_x2, static_cast<std::int16_t>((widescreen_width_480p - 640.0f) / 2 + 625));
-                overwrite(f2_rules_1_x1, static_cast<std::int16_t>((widescreen_width_480p - 640.0f) / 2 + 330));
-                overwrite(f2_rules_1_x2, static_cast<std::int16_t>((widescreen_width_480p - 640.0f) / 2 + 630));
-                overwrite(f2_rules_2_x1, static_cast<std::int16_t>((widescreen_width_480p - 640.0f) / 2 + 10));
-                overwrite(f2_rules_2_x2, static_cast<std::int16_t>((widescreen_width_480p - 640.0f) / 2 + 310));
-                overwrite(f2_rules_3_x1, static_cast<std::int16_t>((widescreen_width_480p - 640.0f) / 2 + 330));
-                overwrite(f2_rules_3_x2, static_cast<std::int16_t>((widescreen_width_480p - 640.0f) / 2 + 630));
-                overwrite(f2_rules_4_x1, static_cast<std::int16_t>((widescreen_width_480p - 640.0f) / 2 + 310));
-                overwrite(f2_rules_4_x2, static_cast<std::int16_t>((widescreen_width_480p - 640.0f) / 2 + 450));
-                overwrite(f2_rules_4_left_x, static_cast<std::uint32_t>((widescreen_width_480p - 640.0f) / 2 + 10));
+                patch.overwrite(f2_motd_x, static_cast<std::int16_t>(widescreen_width_480p - 640.0f + 625));
+                patch.overwrite(f2_heading_x, static_cast<std::int16_t>((widescreen_width_480p - 640.0f) / 2 + 630));
+                patch.overwrite(f2_motd_body_x1, static_cast<std::int16_t>((widescreen_width_480p - 640.0f) / 2 + 105));
+                patch.overwrite(f2_motd_body_x2, static_cast<std::int16_t>((widescreen_width_480p - 640.0f) / 2 + 625));
+                patch.overwrite(f2_rules_1_x1, static_cast<std::int16_t>((widescreen_width_480p - 640.0f) / 2 + 330));
+                patch.overwrite(f2_rules_1_x2, static_cast<std::int16_t>((widescreen_width_480p - 640.0f) / 2 + 630));
+                patch.overwrite(f2_rules_2_x1, static_cast<std::int16_t>((widescreen_width_480p - 640.0f) / 2 + 10));
+                patch.overwrite(f2_rules_2_x2, static_cast<std::int16_t>((widescreen_width_480p - 640.0f) / 2 + 310));
+                patch.overwrite(f2_rules_3_x1, static_cast<std::int16_t>((widescreen_width_480p - 640.0f) / 2 + 330));
+                patch.overwrite(f2_rules_3_x2, static_cast<std::int16_t>((widescreen_width_480p - 640.0f) / 2 + 630));
+                patch.overwrite(f2_rules_4_x1, static_cast<std::int16_t>((widescreen_width_480p - 640.0f) / 2 + 310));
+                patch.overwrite(f2_rules_4_x2, static_cast<std::int16_t>((widescreen_width_480p - 640.0f) / 2 + 450));
+                patch.overwrite(f2_rules_4_left_x, static_cast<std::uint32_t>((widescreen_width_480p - 640.0f) / 2 + 10));
+            }
+            patch.overwrite(loading_screen_text_x2, static_cast<std::int16_t>(widescreen_width_480p));
+            patch.overwrite(console_output_width, static_cast<std::int32_t>(widescreen_width_480p));
+            if(!patch.commit()) {
+                // Only say so once since this is tried again every tick
+                static bool reported = false;
+                if(!reported) {
+                    console_error(localize("chimera_error_patch_failed"), "widescreen_fix");
+                    reported = true;
+                }
+                return;
             }
-            overwrite(loading_screen_text_x2, static_cast<std::int16_t>(widescreen_width_480p));
-            overwrite(console_output_width, static_cast<std::int32_t>(widescreen_width_480p));
 
             tabs[0] = static_cast<std::int16_t>(0.25f * widescreen_width_480p);
             tabs[1] = static_cast<std::int16_t>(0.50f * widescreen_width_480p);
@@ -0,0 +1,26 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#ifndef CHIMERA_MODEL_NODE_HPP
+#define CHIMERA_MODEL_NODE_HPP
+
+#include "../math_trig/math_trig.hpp"
+
+namespace Chimera {
+    /** A model node is a part of a model which can have its own position, rotation, and scale. */
+    struct ModelNode {
+        /** Scale of this part of the model */
+        float scale;
+
+        /** Rotation of the model node */
+        RotationMatrix rotation;
+
+        /** Position of the model node relative to the world */
+        Point3D position;
+    };
+    static_assert(sizeof(ModelNode) == 0x34);
+
+    /** As of Halo 1.10, 64 nodes is the maximum count. */
+    #define MAX_NODES 64
+}
+
+#endif
@@ -30,6 +30,25 @@ namespace Chimera {
         }
     }
 
+    std::size_t BaseDynamicObject::node_count() noexcept {
+        // Projectiles only have one node
+        if(this->type == ObjectType::OBJECT_TYPE_PROJECTILE) {
+            return 1;
+        }
+
+        // Get the model tag to get the node count
+        auto *object_tag = get_tag(this->tag_id.index.index);
+        if(!object_tag) {
+            return 0;
+        }
+        const auto &model_tag_id = *reinterpret_cast<const TagID *>(object_tag->data + 0x28 + 0xC);
+        auto *model_tag = get_tag(model_tag_id);
+        if(!model_tag) {
+            return 0;
+        }
+        return *reinterpret_cast<std::uint32_t *>(model_tag->data + 0xB8);
+    }
+
     extern "C" {
         void delete_object_asm(std::uint32_t whole_id);
         void *delete_object_fn = nullptr;
@@ -7,6 +7,7 @@
 #include <cstdint>
 
 #include "../math_trig/math_trig.hpp"
+#include "model_node.hpp"
 #include "pad.hpp"
 #include "table.hpp"
 #include "tag.hpp"
@@ -110,21 +111,6 @@ namespace Chimera {
         OBJECT_TYPE_SOUND_SCENERY
     };
 
-    /** A model node is a part of a model which can have its own position, rotation, and scale. */
-    struct ModelNode {
-        /** Scale of this part of the model */
-        float scale;
-
-        /** Rotation of the model node */
-        RotationMatrix rotation;
-
-        /** Position of the model node relative to the world */
-        Point3D position;
-    };
-
-    /** As of Halo 1.10, 64 nodes is the maximum count. */
-    #define MAX_NODES 64
-
     /**
      * These are objects that are present in an instance of Halo rather than in tag data and have parameters such as location and health.
      */
@@ -329,6 +315,12 @@ namespace Chimera {
 
             return reinterpret_cast<ModelNode *>(reinterpret_cast<std::byte *>(this) + model_node_offset[this->type]);
         }
+
+        /**
+         * Get the number of model nodes the object has according to its tags.
+         * @return the number of model nodes or 0 if the object has no model
+         */
+        std::size_t node_count() noexcept;
     };
     static_assert(sizeof(BaseDynamicObject) == 0x1F4);
 
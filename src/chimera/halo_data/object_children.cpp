@@ -0,0 +1,32 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include "object_children.hpp"
+
+namespace Chimera {
+    void build_object_children(const ObjectID *objects, const std::uint16_t *parents, std::size_t count, std::size_t max_objects, std::vector<std::uint16_t> &children_start, std::vector<std::uint16_t> &children) {
+        // Count the children of each object.
+        children_start.assign(max_objects + 1, 0);
+        for(std::size_t i = 0; i < count; i++) {
+            if(parents[i] < max_objects) {
+                children_start[parents[i]]++;
+            }
+        }
+
+        // Turn the counts into where each object's children end.
+        for(std::size_t i = 1; i < max_objects; i++) {
+            children_start[i] += children_start[i - 1];
+        }
+        std::size_t child_count = max_objects ? children_start[max_objects - 1] : 0;
+        children_start[max_objects] = child_count;
+
+        // Place each child from the back, moving each end back to the start. Going through the objects backwards keeps the children in
+        // index order.
+        children.resize(child_count);
+        for(std::size_t i = count; i > 0; i--) {
+            auto parent = parents[i - 1];
+            if(parent < max_objects) {
+                children[--children_start[parent]] = objects[i - 1].index.index;
+            }
+        }
+    }
+}
@@ -0,0 +1,26 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#ifndef CHIMERA_OBJECT_CHILDREN_HPP
+#define CHIMERA_OBJECT_CHILDREN_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "type.hpp"
+
+namespace Chimera {
+    /**
+     * Lay out the children of each object by parent in one pass, so finding an object's children doesn't mean going through the whole
+     * object table. The children of the object at index p are children[children_start[p]] through children[children_start[p + 1] - 1].
+     * @param objects        IDs of the objects in index order
+     * @param parents        parent index of each object; anything max_objects or higher (such as the index of a null ID) has no parent
+     * @param count          number of objects
+     * @param max_objects    maximum number of objects (the size of the object table)
+     * @param children_start set to where each object's children start; this gets max_objects + 1 elements
+     * @param children       set to the children of each object in index order
+     */
+    void build_object_children(const ObjectID *objects, const std::uint16_t *parents, std::size_t count, std::size_t max_objects, std::vector<std::uint16_t> &children_start, std::vector<std::uint16_t> &children);
+}
+
+#endif
@@ -0,0 +1,88 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include <algorithm>
+
+#include "../event/map_load.hpp"
+#include "../event/tick.hpp"
+
+#include "object_children.hpp"
+#include "object_index.hpp"
+
+namespace Chimera {
+    static ObjectIndex object_index;
+
+    // This is the tick the index was last built on, if it's valid.
+    static std::int32_t object_index_tick = 0;
+    static bool object_index_valid = false;
+
+    // This is the parent index of each object in object_index.objects.
+    static std::vector<std::uint16_t> parents;
+
+    // This is the parent index of objects without a parent. It's past the end of any object table.
+    #define NULL_PARENT 0xFFFF
+
+    static void invalidate_object_index() noexcept {
+        object_index_valid = false;
+    }
+
+    static void build_object_index() noexcept {
+        auto &object_table = ObjectTable::get_object_table();
+        std::size_t max_size = object_table.max_elements;
+        std::size_t object_count = std::min<std::size_t>(object_table.current_size, max_size);
+
+        object_index.objects.clear();
+        for(auto &objects : object_index.objects_by_type) {
+            objects.clear();
+        }
+        object_index.unparented_weapons.clear();
+        parents.clear();
+
+        // Go through all objects, sorting them and noting the parent of each one.
+        for(std::size_t i = 0; i < object_count; i++) {
+            auto &element = object_table.first_element[i];
+            auto *object = element.object;
+            if(!object) {
+                continue;
+            }
+
+            ObjectID object_id;
+            object_id.index.index = static_cast<std::uint16_t>(i);
+            object_id.index.id = element.id;
+            object_index.objects.push_back(object_id);
+
+            if(object->type < OBJECT_TYPE_COUNT) {
+                object_index.objects_by_type[object->type].push_back(object_id);
+            }
+
+            if(object->parent.is_null()) {
+                parents.push_back(NULL_PARENT);
+                if(object->type == ObjectType::OBJECT_TYPE_WEAPON) {
+                    object_index.unparented_weapons.push_back(object_id);
+                }
+            }
+            else {
+                parents.push_back(object->parent.index.index);
+            }
+        }
+
+        build_object_children(object_index.objects.data(), parents.data(), parents.size(), max_size, object_index.children_start, object_index.children);
+    }
+
+    const ObjectIndex &get_object_index() noexcept {
+        // Objects from the last map are gone once a new one loads, and the tick count starts over, so don't trust the index after that.
+        static bool map_load_event_added = false;
+        if(!map_load_event_added) {
+            add_map_load_event(invalidate_object_index, EventPriority::EVENT_PRIORITY_BEFORE);
+            map_load_event_added = true;
+        }
+
+        auto tick = get_tick_count();
+        if(!object_index_valid || object_index_tick != tick) {
+            build_object_index();
+            object_index_tick = tick;
+            object_index_valid = true;
+        }
+
+        return object_index;
+    }
+}
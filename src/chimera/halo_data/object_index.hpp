@@ -0,0 +1,46 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#ifndef CHIMERA_OBJECT_INDEX_HPP
+#define CHIMERA_OBJECT_INDEX_HPP
+
+#include <cstdint>
+#include <vector>
+
+#include "object.hpp"
+
+namespace Chimera {
+    /** This is the number of object types in ObjectType. */
+    #define OBJECT_TYPE_COUNT (ObjectType::OBJECT_TYPE_SOUND_SCENERY + 1)
+
+    /**
+     * Objects in the object table sorted into the groups features look for. This is built from one pass over the object table the first
+     * time it is requested each tick, so features that run every tick or frame don't each walk the whole table. Objects created or
+     * deleted since it was built (such as by a command) won't be reflected until the next tick, so always look up objects by their IDs.
+     */
+    struct ObjectIndex {
+        /** These are the IDs of every object in the table in index order. */
+        std::vector<ObjectID> objects;
+
+        /** These are the IDs of every object of each type in index order. */
+        std::vector<ObjectID> objects_by_type[OBJECT_TYPE_COUNT];
+
+        /** These are the IDs of every weapon that isn't being held in index order. */
+        std::vector<ObjectID> unparented_weapons;
+
+        /**
+         * These are the indices of the children of each object. The children of the object at index p are
+         * children[children_start[p]] through children[children_start[p + 1] - 1] in index order. children_start has one more element
+         * than the object table's maximum size.
+         */
+        std::vector<std::uint16_t> children_start;
+        std::vector<std::uint16_t> children;
+    };
+
+    /**
+     * Get the object index for the current tick, building it if it hasn't been built this tick.
+     * @return the object index
+     */
+    const ObjectIndex &get_object_index() noexcept;
+}
+
+#endif
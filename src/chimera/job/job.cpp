@@ -0,0 +1,131 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include <algorithm>
+#include <atomic>
+#include <float.h>
+
+#include "../event/frame.hpp"
+#include "job.hpp"
+
+namespace Chimera {
+    // Halo only uses one thread, but leave a core for everything else running on the system. Jobs are mostly disk and network I/O, so
+    // there is no point in having more than a few threads.
+    #define MAX_JOB_THREADS 4
+
+    static CompletionQueue game_thread_queue;
+
+    static void on_preframe() noexcept {
+        game_thread_queue.run();
+    }
+
+    static JobPool &get_job_pool() {
+        // This is never deleted. Worker threads may already be gone by the time static destructors are run when the process exits.
+        static JobPool *pool = nullptr;
+        if(!pool) {
+            std::size_t threads = std::thread::hardware_concurrency();
+            threads = std::clamp<std::size_t>(threads > 1 ? threads - 1 : 1, 1, MAX_JOB_THREADS);
+            pool = new JobPool(threads);
+            add_preframe_event(on_preframe, EventPriority::EVENT_PRIORITY_BEFORE);
+        }
+        return *pool;
+    }
+
+    void queue_job(JobFunction job, JobFunction completion) {
+        get_job_pool().submit([job = std::move(job), completion = std::move(completion)]() {
+            job();
+            if(completion) {
+                game_thread_queue.post(completion);
+            }
+        });
+    }
+
+    void finish_jobs() noexcept {
+        get_job_pool().wait_idle();
+        game_thread_queue.run();
+    }
+
+    // x87 and SSE settings that affect results
+    #define PARALLEL_FLOAT_CONTROL (_MCW_PC | _MCW_RC | _MCW_DN | _MCW_EM)
+
+    struct ParallelWork {
+        /** Function to call; only valid while chunks remain */
+        const ParallelFunction *function;
+
+        /** Number of items and items per chunk */
+        std::size_t count;
+        std::size_t chunk_size;
+        std::size_t chunk_count;
+
+        /** Floating point settings of the calling thread */
+        unsigned int float_control;
+
+        /** Next chunk to take */
+        std::atomic<std::size_t> next_chunk = 0;
+
+        /** Chunks that have not finished yet */
+        std::mutex mutex;
+        std::condition_variable done;
+        std::size_t remaining;
+
+        /**
+         * Handle chunks until there are none left to take
+         */
+        void run() {
+            std::size_t finished = 0;
+            std::size_t chunk;
+            while((chunk = this->next_chunk.fetch_add(1, std::memory_order_relaxed)) < this->chunk_count) {
+                std::size_t first = chunk * this->chunk_size;
+                (*this->function)(first, std::min(first + this->chunk_size, this->count));
+                finished++;
+            }
+            if(finished) {
+                std::scoped_lock lock(this->mutex);
+                this->remaining -= finished;
+                if(this->remaining == 0) {
+                    this->done.notify_all();
+                }
+            }
+        }
+    };
+
+    void run_parallel(std::size_t count, std::size_t chunk_size, const ParallelFunction &function) {
+        if(count == 0) {
+            return;
+        }
+        if(chunk_size == 0) {
+            chunk_size = 1;
+        }
+
+        // Don't bother with other threads if there's only one chunk.
+        std::size_t chunk_count = (count + chunk_size - 1) / chunk_size;
+        if(chunk_count == 1) {
+            function(0, count);
+            return;
+        }
+
+        // Jobs can start after everything is done, so they need to share ownership. They won't touch the function once no chunks remain.
+        auto work = std::make_shared<ParallelWork>();
+        work->function = &function;
+        work->count = count;
+        work->chunk_size = chunk_size;
+        work->chunk_count = chunk_count;
+        work->remaining = chunk_count;
+        work->float_control = _control87(0, 0);
+
+        auto &pool = get_job_pool();
+        std::size_t helpers = std::min(pool.thread_count(), chunk_count - 1);
+        for(std::size_t i = 0; i < helpers; i++) {
+            pool.submit([work]() {
+                auto float_control = _control87(0, 0);
+                _control87(work->float_control, PARALLEL_FLOAT_CONTROL);
+                work->run();
+                _control87(float_control, PARALLEL_FLOAT_CONTROL);
+            });
+        }
+
+        work->run();
+
+        std::unique_lock lock(work->mutex);
+        work->done.wait(lock, [&work]() { return work->remaining == 0; });
+    }
+}
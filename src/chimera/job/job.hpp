@@ -0,0 +1,36 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#ifndef CHIMERA_JOB_HPP
+#define CHIMERA_JOB_HPP
+
+#include "job_pool.hpp"
+
+namespace Chimera {
+    /**
+     * Run a job on a worker thread so it doesn't hold up the game. This must be called from the game thread.
+     * @param job        job to run on a worker thread; this must not touch Halo's memory
+     * @param completion function to run on the game thread before the frame after the job has finished, if any
+     */
+    void queue_job(JobFunction job, JobFunction completion = nullptr);
+
+    /**
+     * Block until every queued job has finished and then run any completions. This must be called from the game thread.
+     */
+    void finish_jobs() noexcept;
+
+    /** This is a function that handles items first through last - 1 of some work. */
+    using ParallelFunction = std::function<void (std::size_t first, std::size_t last)>;
+
+    /**
+     * Split work into chunks and handle them on the worker threads and the calling thread at the same time, returning once every chunk is
+     * done. The calling thread takes chunks too, so this never waits for unrelated jobs to finish, and chunks run with the calling
+     * thread's floating point settings, so the results don't depend on which thread handled which chunk. This must be called from the
+     * game thread.
+     * @param count      number of items
+     * @param chunk_size number of items per chunk
+     * @param function   function to handle each chunk
+     */
+    void run_parallel(std::size_t count, std::size_t chunk_size, const ParallelFunction &function);
+}
+
+#endif
@@ -0,0 +1,123 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include "job_pool.hpp"
+
+namespace Chimera {
+    JobPool::JobPool(std::size_t thread_count) {
+        if(thread_count == 0) {
+            thread_count = 1;
+        }
+        for(std::size_t i = 0; i < thread_count; i++) {
+            this->p_queues.emplace_back(std::make_unique<WorkerQueue>());
+        }
+        for(std::size_t i = 0; i < thread_count; i++) {
+            this->p_threads.emplace_back(&JobPool::worker, this, i);
+        }
+    }
+
+    JobPool::~JobPool() {
+        {
+            std::scoped_lock lock(this->p_mutex);
+            this->p_stopping = true;
+        }
+        this->p_work_available.notify_all();
+        for(auto &thread : this->p_threads) {
+            thread.join();
+        }
+    }
+
+    void JobPool::submit(JobFunction job) {
+        {
+            // Queue it and count it under the same lock. Workers take jobs without this lock but need it to uncount them, so a job can't
+            // be uncounted before it's counted.
+            std::scoped_lock lock(this->p_mutex);
+            auto &queue = *this->p_queues[this->p_next_queue++ % this->p_queues.size()];
+            {
+                std::scoped_lock queue_lock(queue.mutex);
+                queue.jobs.emplace_back(std::move(job));
+            }
+            this->p_pending++;
+            this->p_queued++;
+        }
+        this->p_work_available.notify_one();
+    }
+
+    void JobPool::wait_idle() {
+        std::unique_lock lock(this->p_mutex);
+        this->p_idle.wait(lock, [this]() { return this->p_pending == 0; });
+    }
+
+    bool JobPool::take(std::size_t index, JobFunction &job) {
+        std::size_t queue_count = this->p_queues.size();
+        for(std::size_t i = 0; i < queue_count; i++) {
+            auto &queue = *this->p_queues[(index + i) % queue_count];
+            std::scoped_lock lock(queue.mutex);
+            if(queue.jobs.empty()) {
+                continue;
+            }
+
+            // Our own queue is first in, first out. Steal from the other end so we don't fight its owner.
+            if(i == 0) {
+                job = std::move(queue.jobs.front());
+                queue.jobs.pop_front();
+            }
+            else {
+                job = std::move(queue.jobs.back());
+                queue.jobs.pop_back();
+            }
+            return true;
+        }
+        return false;
+    }
+
+    void JobPool::worker(std::size_t index) {
+        while(true) {
+            JobFunction job;
+            if(this->take(index, job)) {
+                {
+                    std::scoped_lock lock(this->p_mutex);
+                    this->p_queued--;
+                }
+
+                job();
+                job = nullptr;
+
+                std::scoped_lock lock(this->p_mutex);
+                if(--this->p_pending == 0) {
+                    this->p_idle.notify_all();
+                }
+                continue;
+            }
+
+            // Nothing to take? Wait for something to be queued.
+            std::unique_lock lock(this->p_mutex);
+            this->p_work_available.wait(lock, [this]() { return this->p_queued > 0 || this->p_stopping; });
+            if(this->p_queued == 0 && this->p_stopping) {
+                return;
+            }
+        }
+    }
+
+    void CompletionQueue::post(JobFunction function) {
+        std::scoped_lock lock(this->p_mutex);
+        this->p_functions.emplace_back(std::move(function));
+    }
+
+    std::size_t CompletionQueue::run() {
+        {
+            std::scoped_lock lock(this->p_mutex);
+            if(this->p_functions.empty()) {
+                return 0;
+            }
+            std::swap(this->p_functions, this->p_running);
+        }
+
+        // Run them without holding the lock so they can post more functions
+        std::size_t count = this->p_running.size();
+        for(auto &function : this->p_running) {
+            function();
+        }
+        this->p_running.clear();
+        return count;
+    }
+}
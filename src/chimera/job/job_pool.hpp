@@ -0,0 +1,128 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#ifndef CHIMERA_JOB_POOL_HPP
+#define CHIMERA_JOB_POOL_HPP
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Chimera {
+    /** This is a function that can be run on another thread. */
+    using JobFunction = std::function<void ()>;
+
+    /**
+     * A job pool runs jobs on worker threads. Each worker has its own queue, and idle workers steal jobs from the other queues. This does
+     * not depend on Halo, so it can be used and tested on its own.
+     */
+    class JobPool {
+    public:
+        /**
+         * Start the worker threads
+         * @param thread_count number of worker threads; at least one is always started
+         */
+        explicit JobPool(std::size_t thread_count);
+
+        /**
+         * Finish any queued jobs and stop the worker threads
+         */
+        ~JobPool();
+
+        JobPool(const JobPool &) = delete;
+        JobPool &operator=(const JobPool &) = delete;
+
+        /**
+         * Queue a job. This can be called from any thread, including from a job.
+         * @param job job to run
+         */
+        void submit(JobFunction job);
+
+        /**
+         * Block until every queued job has finished. This must not be called from a job.
+         */
+        void wait_idle();
+
+        /**
+         * Get the number of worker threads
+         * @return number of worker threads
+         */
+        std::size_t thread_count() const noexcept {
+            return this->p_threads.size();
+        }
+
+    private:
+        struct WorkerQueue {
+            std::mutex mutex;
+            std::deque<JobFunction> jobs;
+        };
+
+        /** Each worker's queue; workers take from the front of their own queue and steal from the back of others' */
+        std::vector<std::unique_ptr<WorkerQueue>> p_queues;
+
+        /** Worker threads */
+        std::vector<std::thread> p_threads;
+
+        /** Guards the counters below. When a queue's mutex is needed too, this is locked first. */
+        std::mutex p_mutex;
+        std::condition_variable p_work_available;
+        std::condition_variable p_idle;
+
+        /** Jobs sitting in a queue */
+        std::size_t p_queued = 0;
+
+        /** Jobs sitting in a queue or running */
+        std::size_t p_pending = 0;
+
+        /** Queue the next job goes into */
+        std::size_t p_next_queue = 0;
+
+        /** Set when the workers should exit once the queues are empty */
+        bool p_stopping = false;
+
+        /**
+         * Take a job, trying the given worker's queue first
+         * @param  index index of the worker
+         * @param  job   job to write to
+         * @return       true if a job was taken
+         */
+        bool take(std::size_t index, JobFunction &job);
+
+        /**
+         * Run jobs until stopped
+         * @param index index of the worker
+         */
+        void worker(std::size_t index);
+    };
+
+    /**
+     * A completion queue holds functions posted from any thread so they can be run later on one specific thread.
+     */
+    class CompletionQueue {
+    public:
+        /**
+         * Post a function. This can be called from any thread.
+         * @param function function to run
+         */
+        void post(JobFunction function);
+
+        /**
+         * Run every function posted so far on the calling thread
+         * @return number of functions that were run
+         */
+        std::size_t run();
+
+    private:
+        std::mutex p_mutex;
+        std::vector<JobFunction> p_functions;
+
+        /** Functions being run; kept around so the allocation can be reused */
+        std::vector<JobFunction> p_running;
+    };
+}
+
+#endif
@@ -4,14 +4,21 @@
 #define CHIMERA_LOCALIZATION_HPP
 
 #include "../chimera.hpp"
+#include "localization_id.hpp"
 
 namespace Chimera {
     /**
      * Get the localized form of the string
-     * @param  string string to get
-     * @return        localized form or the string, itself, if not found
+     * @param  id       ID of the string to get
+     * @param  language language to get it in
+     * @return          localized form or the key, itself, if it isn't translated
      */
-    const char *localize(const char *string, Language = get_chimera().get_language()) noexcept;
+    const char *localize_id(LocalizationID id, Language language = get_chimera().get_language()) noexcept;
+
+    /**
+     * Get the localized form of the string. The key must be a string literal and is resolved at compile time.
+     */
+    #define localize(key) ::Chimera::localize_id(LOCALIZATION_ID(key))
 }
 
 #endif
@@ -0,0 +1,66 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#ifndef CHIMERA_LOCALIZATION_ID_HPP
+#define CHIMERA_LOCALIZATION_ID_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#include <localization_keys.hpp>
+
+namespace Chimera {
+    /** Index of a localization key in LOCALIZATION_KEYS */
+    using LocalizationID = std::uint16_t;
+
+    /**
+     * This is intentionally not constexpr (or defined). If it's reached while resolving a key at compile time, the key does not exist.
+     */
+    void localization_key_not_found() noexcept;
+
+    /**
+     * Compare two strings like std::strcmp, but at compile time
+     */
+    constexpr int localization_key_compare(const char *a, const char *b) noexcept {
+        while(*a && *a == *b) {
+            a++;
+            b++;
+        }
+        return static_cast<unsigned char>(*a) - static_cast<unsigned char>(*b);
+    }
+
+    /**
+     * Find the ID of a localization key. Use LOCALIZATION_ID() so this is resolved at compile time.
+     * @param  key key to look up
+     * @return     ID of the key
+     */
+    constexpr LocalizationID localization_id(const char *key) noexcept {
+        std::size_t begin = 0;
+        std::size_t count = LOCALIZATION_KEY_COUNT;
+
+        // Binary search; the keys are sorted
+        while(begin < count) {
+            std::size_t middle = (count + begin) / 2;
+            int r = localization_key_compare(key, LOCALIZATION_KEYS[middle]);
+            if(r == 0) {
+                return static_cast<LocalizationID>(middle);
+            }
+            else if(r > 0) {
+                begin = middle + 1;
+            }
+            else {
+                count = middle;
+            }
+        }
+
+        localization_key_not_found();
+        return 0;
+    }
+
+    /**
+     * Get the ID of a localization key at compile time. A key that doesn't exist is a build error.
+     */
+    #define LOCALIZATION_ID(key) (std::integral_constant<::Chimera::LocalizationID, ::Chimera::localization_id(key)>::value)
+}
+
+#endif
@@ -9,8 +9,8 @@ if __name__ == '__main__':
     def eprint(message):
         print(message, file=sys.stderr)
 
-    if len(sys.argv) != 3:
-        eprint("Syntax: {} <localization-dir> <output>".format(sys.argv[0]))
+    if len(sys.argv) != 4:
+        eprint("Syntax: {} <localization-dir> <strings-output> <keys-output>".format(sys.argv[0]))
         sys.exit(1)
 
     loc_dir = sys.argv[1]
@@ -100,14 +100,24 @@ if __name__ == '__main__':
                     data.append("")
         merged_localization[key] = data
 
-    # Make the output file
+    # Make the strings file; each language gets its own table indexed by key ID. Missing strings fall back to the key.
     with open(sys.argv[2], "w") as output:
-        output.write("namespace Chimera {\n    static const char *LOCALIZATION_DATA[][CHIMERA_LANGUAGE_COUNT + 1] = {\n")
-        for key in key_list:
+        output.write("namespace Chimera {\n    static const char *LOCALIZATION_DATA[CHIMERA_LANGUAGE_COUNT][LOCALIZATION_KEY_COUNT] = {\n")
+        for loc in range(len(localization)):
             output.write("        {\n")
-            output.write("            \"{}\",\n".format(key))
-            for loc in merged_localization[key]:
-                output.write("            \"{}\",\n".format(loc))
+            for key in key_list:
+                value = merged_localization[key][loc]
+                output.write("            \"{}\",\n".format(value if len(value) > 0 else key))
             output.write("        },\n")
         output.write("    };\n}\n")
         output.flush()
+
+    # Make the keys file; a key's ID is its index in the sorted list
+    with open(sys.argv[3], "w") as output:
+        output.write("namespace Chimera {\n")
+        output.write("    #define LOCALIZATION_KEY_COUNT {}\n\n".format(len(key_list)))
+        output.write("    inline constexpr const char *LOCALIZATION_KEYS[LOCALIZATION_KEY_COUNT] = {\n")
+        for key in key_list:
+            output.write("        \"{}\",\n".format(key))
+        output.write("    };\n}\n")
+        output.flush()
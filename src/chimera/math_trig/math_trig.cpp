@@ -1,6 +1,8 @@
 // SPDX-License-Identifier: GPL-3.0-only
 
+#include <algorithm>
 #include <cmath>
+#include <emmintrin.h>
 
 #include "math_trig.hpp"
 
@@ -154,12 +156,198 @@ namespace Chimera {
         out.z = z0*r1 + z1*r0;
     }
 
+    // Polynomial slerp from David Eberly's "A Fast and Accurate Algorithm for Computing SLERP". sin(t * theta) / sin(theta) is evaluated
+    // as t * (1 + b1 * (1 + b2 * (... (1 + bn)))) where bi = (ui * t^2 - vi) * (cos(theta) - 1). Only cos(theta) changes per quaternion,
+    // so the (ui * t^2 - vi) terms are computed once per call. The paper uses eight terms, but that is only accurate to about 2e-5. With
+    // twelve terms and mu fitted for twelve terms, the weights are within 7.2e-7 of sin(t * theta) / sin(theta) for any angle that
+    // interpolate_quat() would interpolate.
+    #define SLERP_TERMS 12
+
+    static void slerp_coefficients(float t, float *coefficients) noexcept {
+        static constexpr float MU = 1.89371192134617F;
+        float t2 = t * t;
+        for(std::size_t i = 1; i < SLERP_TERMS; i++) {
+            coefficients[i - 1] = t2 / (i * (2.0F * i + 1.0F)) - i / (2.0F * i + 1.0F);
+        }
+        coefficients[SLERP_TERMS - 1] = MU * t2 / (SLERP_TERMS * (2.0F * SLERP_TERMS + 1.0F)) - MU * SLERP_TERMS / (2.0F * SLERP_TERMS + 1.0F);
+    }
+
+    static float slerp_weight(float t, const float *coefficients, float cos_theta_minus_one) noexcept {
+        float weight = 1.0F;
+        for(std::size_t i = SLERP_TERMS; i > 0; i--) {
+            weight = 1.0F + coefficients[i - 1] * cos_theta_minus_one * weight;
+        }
+        return t * weight;
+    }
+
+    static void interpolate_quats_scalar(const Quaternion *in_before, const Quaternion *in_after, Quaternion *out, std::size_t count, float scale, const float *coefficients_before, const float *coefficients_after) noexcept {
+        for(std::size_t i = 0; i < count; i++) {
+            auto &before = in_before[i];
+            auto after = in_after[i];
+            float cos_half_theta = (before.x*after.x + before.y*after.y) + (before.z*after.z + before.w*after.w);
+            if(cos_half_theta < 0) {
+                after.w *= -1;
+                after.x *= -1;
+                after.y *= -1;
+                after.z *= -1;
+                cos_half_theta *= -1;
+            }
+            if(cos_half_theta < 0.01F) {
+                continue;
+            }
+
+            float r0 = slerp_weight(1.0F - scale, coefficients_before, cos_half_theta - 1.0F);
+            float r1 = slerp_weight(scale, coefficients_after, cos_half_theta - 1.0F);
+            out[i].w = before.w*r0 + after.w*r1;
+            out[i].x = before.x*r0 + after.x*r1;
+            out[i].y = before.y*r0 + after.y*r1;
+            out[i].z = before.z*r0 + after.z*r1;
+        }
+    }
+
+    // Interpolate four quaternions with SSE2
+    __attribute__((target("sse2"), always_inline))
+    static inline void interpolate_four_quats_sse2(const Quaternion *in_before, const Quaternion *in_after, Quaternion *out, float scale, const float *coefficients_before, const float *coefficients_after) noexcept {
+        static_assert(sizeof(Quaternion) == sizeof(__m128));
+        const __m128 one = _mm_set1_ps(1.0F);
+        const __m128 sign_bit = _mm_set1_ps(-0.0F);
+        const __m128 min_cos_half_theta = _mm_set1_ps(0.01F);
+        const __m128 t_after = _mm_set1_ps(scale);
+        const __m128 t_before = _mm_sub_ps(one, t_after);
+
+        // Load four quaternions of each and transpose them so each register holds one component of all four
+        __m128 bx = _mm_loadu_ps(&in_before[0].x);
+        __m128 by = _mm_loadu_ps(&in_before[1].x);
+        __m128 bz = _mm_loadu_ps(&in_before[2].x);
+        __m128 bw = _mm_loadu_ps(&in_before[3].x);
+        _MM_TRANSPOSE4_PS(bx, by, bz, bw);
+        __m128 ax = _mm_loadu_ps(&in_after[0].x);
+        __m128 ay = _mm_loadu_ps(&in_after[1].x);
+        __m128 az = _mm_loadu_ps(&in_after[2].x);
+        __m128 aw = _mm_loadu_ps(&in_after[3].x);
+        _MM_TRANSPOSE4_PS(ax, ay, az, aw);
+
+        // Take the shortest path
+        __m128 cos_half_theta = _mm_add_ps(_mm_add_ps(_mm_mul_ps(bx, ax), _mm_mul_ps(by, ay)), _mm_add_ps(_mm_mul_ps(bz, az), _mm_mul_ps(bw, aw)));
+        __m128 sign = _mm_and_ps(cos_half_theta, sign_bit);
+        ax = _mm_xor_ps(ax, sign);
+        ay = _mm_xor_ps(ay, sign);
+        az = _mm_xor_ps(az, sign);
+        aw = _mm_xor_ps(aw, sign);
+        cos_half_theta = _mm_xor_ps(cos_half_theta, sign);
+        __m128 valid = _mm_cmpge_ps(cos_half_theta, min_cos_half_theta);
+
+        // Evaluate both weights
+        __m128 cos_theta_minus_one = _mm_sub_ps(cos_half_theta, one);
+        __m128 r0 = one;
+        __m128 r1 = one;
+        for(std::size_t c = SLERP_TERMS; c > 0; c--) {
+            r0 = _mm_add_ps(one, _mm_mul_ps(_mm_mul_ps(_mm_set1_ps(coefficients_before[c - 1]), cos_theta_minus_one), r0));
+            r1 = _mm_add_ps(one, _mm_mul_ps(_mm_mul_ps(_mm_set1_ps(coefficients_after[c - 1]), cos_theta_minus_one), r1));
+        }
+        r0 = _mm_mul_ps(t_before, r0);
+        r1 = _mm_mul_ps(t_after, r1);
+
+        __m128 ox = _mm_add_ps(_mm_mul_ps(bx, r0), _mm_mul_ps(ax, r1));
+        __m128 oy = _mm_add_ps(_mm_mul_ps(by, r0), _mm_mul_ps(ay, r1));
+        __m128 oz = _mm_add_ps(_mm_mul_ps(bz, r0), _mm_mul_ps(az, r1));
+        __m128 ow = _mm_add_ps(_mm_mul_ps(bw, r0), _mm_mul_ps(aw, r1));
+
+        // Keep whatever was in the output for quaternions that are too far apart
+        __m128 px = _mm_loadu_ps(&out[0].x);
+        __m128 py = _mm_loadu_ps(&out[1].x);
+        __m128 pz = _mm_loadu_ps(&out[2].x);
+        __m128 pw = _mm_loadu_ps(&out[3].x);
+        _MM_TRANSPOSE4_PS(px, py, pz, pw);
+        ox = _mm_or_ps(_mm_and_ps(valid, ox), _mm_andnot_ps(valid, px));
+        oy = _mm_or_ps(_mm_and_ps(valid, oy), _mm_andnot_ps(valid, py));
+        oz = _mm_or_ps(_mm_and_ps(valid, oz), _mm_andnot_ps(valid, pz));
+        ow = _mm_or_ps(_mm_and_ps(valid, ow), _mm_andnot_ps(valid, pw));
+
+        _MM_TRANSPOSE4_PS(ox, oy, oz, ow);
+        _mm_storeu_ps(&out[0].x, ox);
+        _mm_storeu_ps(&out[1].x, oy);
+        _mm_storeu_ps(&out[2].x, oz);
+        _mm_storeu_ps(&out[3].x, ow);
+    }
+
+    // Halo doesn't need SSE2, so only use it if the CPU has it. Halo's threads don't keep the stack 16-byte aligned, so realign it here.
+    __attribute__((target("sse2"), force_align_arg_pointer))
+    static void interpolate_quats_sse2(const Quaternion *in_before, const Quaternion *in_after, Quaternion *out, std::size_t count, float scale, const float *coefficients_before, const float *coefficients_after) noexcept {
+        std::size_t i;
+        for(i = 0; i + 4 <= count; i += 4) {
+            interpolate_four_quats_sse2(in_before + i, in_after + i, out + i, scale, coefficients_before, coefficients_after);
+        }
+
+        // Pad out any leftovers and do them the same way. The scalar path may use x87 on 32-bit builds, which rounds differently, so this
+        // keeps a quaternion's result from depending on where it is in the array.
+        std::size_t leftover = count - i;
+        if(leftover) {
+            Quaternion before[4], after[4], output[4];
+            std::copy(in_before + i, in_before + count, before);
+            std::copy(in_after + i, in_after + count, after);
+            std::copy(out + i, out + count, output);
+            interpolate_four_quats_sse2(before, after, output, scale, coefficients_before, coefficients_after);
+            std::copy(output, output + leftover, out + i);
+        }
+    }
+
+    void interpolate_quats(const Quaternion *in_before, const Quaternion *in_after, Quaternion *out, std::size_t count, float scale) noexcept {
+        float coefficients_before[SLERP_TERMS];
+        float coefficients_after[SLERP_TERMS];
+        slerp_coefficients(1.0F - scale, coefficients_before);
+        slerp_coefficients(scale, coefficients_after);
+
+        static const bool sse2 = (__builtin_cpu_init(), __builtin_cpu_supports("sse2"));
+        if(sse2) {
+            interpolate_quats_sse2(in_before, in_after, out, count, scale, coefficients_before, coefficients_after);
+        }
+        else {
+            interpolate_quats_scalar(in_before, in_after, out, count, scale, coefficients_before, coefficients_after);
+        }
+    }
+
     void interpolate_point(const Point3D &before, const Point3D &after, Point3D &output, float scale) noexcept {
         output.x = before.x + (after.x - before.x) * scale;
         output.y = before.y + (after.y - before.y) * scale;
         output.z = before.z + (after.z - before.z) * scale;
     }
 
+    static void interpolate_floats_scalar(const float *before, const float *after, float *output, std::size_t count, float scale) noexcept {
+        for(std::size_t i = 0; i < count; i++) {
+            output[i] = before[i] + (after[i] - before[i]) * scale;
+        }
+    }
+
+    __attribute__((target("sse2"), force_align_arg_pointer))
+    static void interpolate_floats_sse2(const float *before, const float *after, float *output, std::size_t count, float scale) noexcept {
+        const __m128 t = _mm_set1_ps(scale);
+
+        std::size_t i;
+        for(i = 0; i + 4 <= count; i += 4) {
+            __m128 b = _mm_loadu_ps(before + i);
+            __m128 a = _mm_loadu_ps(after + i);
+            _mm_storeu_ps(output + i, _mm_add_ps(b, _mm_mul_ps(_mm_sub_ps(a, b), t)));
+        }
+
+        // Leftovers use scalar SSE so they round the same way as everything else
+        for(; i < count; i++) {
+            __m128 b = _mm_load_ss(before + i);
+            __m128 a = _mm_load_ss(after + i);
+            _mm_store_ss(output + i, _mm_add_ss(b, _mm_mul_ss(_mm_sub_ss(a, b), t)));
+        }
+    }
+
+    void interpolate_floats(const float *before, const float *after, float *output, std::size_t count, float scale) noexcept {
+        static const bool sse2 = (__builtin_cpu_init(), __builtin_cpu_supports("sse2"));
+        if(sse2) {
+            interpolate_floats_sse2(before, after, output, count, scale);
+        }
+        else {
+            interpolate_floats_scalar(before, after, output, count, scale);
+        }
+    }
+
     float distance_squared(float x1, float y1, float x2, float y2) noexcept {
         float x = x1 - x2;
         float y = y1 - y2;
@@ -3,7 +3,7 @@
 #ifndef MATH_TRIG_HPP
 #define MATH_TRIG_HPP
 
-#include <windows.h>
+#include <cstddef>
 
 #define HALO_PI 3.1415926535897932384626433832795028841971693993751058209749445923078164062862089986280348253421170679
 #define DEGREES_TO_RADIANS(deg) (deg / 180.0 * HALO_PI)
@@ -107,6 +107,20 @@ namespace Chimera {
      */
     void interpolate_quat(const Quaternion &in_before, const Quaternion &in_after, Quaternion &out, float progress) noexcept;
 
+    /**
+     * Interpolate many quaternions at once. This uses a polynomial approximation of slerp that is accurate to within 1e-6 radians,
+     * processing four quaternions at a time with SSE2 if the CPU supports it. The results are unit quaternions with the same rotation as
+     * interpolate_quat(), though interpolate_quat() doesn't normalize its output. As with interpolate_quat(), if two quaternions are too
+     * far apart to interpolate, that output is left unchanged. With SSE2, each result is the same no matter where it is in the array or how
+     * many are interpolated at once. Without SSE2, x87 is used, which may round differently.
+     * @param in_before This is the quaternions to interpolate from.
+     * @param in_after  This is the quaternions to interpolate to.
+     * @param out       This is the quaternions to overwrite.
+     * @param count     This is the number of quaternions to interpolate.
+     * @param progress  This is how far in between each quaternion (0.0 - 1.0) to create an interpolated quaternion.
+     */
+    void interpolate_quats(const Quaternion *in_before, const Quaternion *in_after, Quaternion *out, std::size_t count, float progress) noexcept;
+
     /**
      * Interpolate a 3D point.
      * @param in_before This is the 3D point to interpolate from.
@@ -116,6 +130,17 @@ namespace Chimera {
      */
     void interpolate_point(const Point3D &before, const Point3D &after, Point3D &output, float scale) noexcept;
 
+    /**
+     * Linearly interpolate many floats at once, four at a time with SSE2 if the CPU supports it. As with interpolate_quats(), results only
+     * depend on whether or not SSE2 is used.
+     * @param before   This is the floats to interpolate from.
+     * @param after    This is the floats to interpolate to.
+     * @param output   This is the floats to overwrite. This may be the same as before or after.
+     * @param count    This is the number of floats to interpolate.
+     * @param progress This is how far in between each float (0.0 - 1.0) to create an interpolated float.
+     */
+    void interpolate_floats(const float *before, const float *after, float *output, std::size_t count, float progress) noexcept;
+
     /**
      * Calculate the distance between two 2D points without taking square roots. If the square root isn't necessary, then this is faster.
      * @param  x1 This is the X coordinate of the first point.
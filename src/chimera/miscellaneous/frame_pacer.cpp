@@ -0,0 +1,88 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include <algorithm>
+#include <cmath>
+
+#include "frame_pacer.hpp"
+
+namespace Chimera {
+    typedef std::chrono::duration<double, std::milli> milliseconds_double;
+
+    void FramePacer::start(clock::duration interval, clock::time_point now) noexcept {
+        this->p_interval = interval;
+        this->p_next_frame = now;
+        this->p_has_last_frame = false;
+        this->p_window_start = now;
+        this->p_window_frames = 0;
+        this->p_window_late_frames = 0;
+        this->p_window_sum_ms = 0.0;
+        this->p_window_sum_squared_ms = 0.0;
+        this->p_window_max_deviation_ms = 0.0;
+        this->p_statistics = {};
+        this->p_statistics.sleep_overshoot_ms = milliseconds_double(this->p_sleep_overshoot).count();
+    }
+
+    FramePacer::clock::duration FramePacer::sleep_duration(clock::time_point now) const noexcept {
+        auto wake_up = this->p_next_frame - spin_time - this->p_sleep_overshoot;
+        return wake_up > now ? wake_up - now : clock::duration::zero();
+    }
+
+    void FramePacer::record_sleep(clock::duration requested, clock::duration actual) noexcept {
+        auto overshoot = std::max(actual - requested, clock::duration::zero());
+
+        // Oversleeping is worse than spinning a bit longer, so jump up to any worse overshoot right away but only come down slowly
+        if(overshoot > this->p_sleep_overshoot) {
+            this->p_sleep_overshoot = overshoot;
+        }
+        else {
+            this->p_sleep_overshoot -= (this->p_sleep_overshoot - overshoot) / 16;
+        }
+
+        // Don't let a single huge stall (e.g. alt-tabbing) turn into never sleeping
+        this->p_sleep_overshoot = std::min(this->p_sleep_overshoot, this->p_interval / 2);
+    }
+
+    void FramePacer::frame_started(clock::time_point now) noexcept {
+        // Measure the time between frames
+        if(this->p_has_last_frame) {
+            double frame_ms = milliseconds_double(now - this->p_last_frame).count();
+            double deviation_ms = std::fabs(frame_ms - milliseconds_double(this->p_interval).count());
+            this->p_window_frames++;
+            this->p_window_sum_ms += frame_ms;
+            this->p_window_sum_squared_ms += frame_ms * frame_ms;
+            this->p_window_max_deviation_ms = std::max(this->p_window_max_deviation_ms, deviation_ms);
+        }
+        if(now > this->p_next_frame + spin_time) {
+            this->p_window_late_frames++;
+        }
+        this->p_last_frame = now;
+        this->p_has_last_frame = true;
+
+        // Publish the statistics once the window is over
+        if(now - this->p_window_start >= statistics_window && this->p_window_frames > 0) {
+            double frames = static_cast<double>(this->p_window_frames);
+            double mean = this->p_window_sum_ms / frames;
+            double variance = std::max(this->p_window_sum_squared_ms / frames - mean * mean, 0.0);
+            this->p_statistics.frames = this->p_window_frames;
+            this->p_statistics.late_frames = this->p_window_late_frames;
+            this->p_statistics.mean_ms = mean;
+            this->p_statistics.jitter_ms = std::sqrt(variance);
+            this->p_statistics.max_deviation_ms = this->p_window_max_deviation_ms;
+            this->p_statistics.sleep_overshoot_ms = milliseconds_double(this->p_sleep_overshoot).count();
+
+            this->p_window_start = now;
+            this->p_window_frames = 0;
+            this->p_window_late_frames = 0;
+            this->p_window_sum_ms = 0.0;
+            this->p_window_sum_squared_ms = 0.0;
+            this->p_window_max_deviation_ms = 0.0;
+        }
+
+        // Schedule the next frame. If we fell behind by more than a frame, skip ahead rather than rushing to catch up.
+        this->p_next_frame += this->p_interval;
+        if(this->p_next_frame <= now) {
+            auto behind = now - this->p_next_frame;
+            this->p_next_frame += this->p_interval * (1 + behind / this->p_interval);
+        }
+    }
+}
@@ -0,0 +1,124 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#ifndef CHIMERA_FRAME_PACER_HPP
+#define CHIMERA_FRAME_PACER_HPP
+
+#include <chrono>
+#include <cstdint>
+
+namespace Chimera {
+    /**
+     * A frame pacer decides how long to wait before each frame. Most of the wait is meant to be slept, and only the last bit is meant to be
+     * spun so the frame starts on time. How late sleeping wakes up is measured so the sleep can be cut short by that much. This does not
+     * sleep or spin by itself, so it does not depend on the platform.
+     */
+    class FramePacer {
+    public:
+        typedef std::chrono::steady_clock clock;
+
+        /**
+         * Frame time statistics over the last measurement window
+         */
+        struct Statistics {
+            /** Number of frames measured */
+            std::uint32_t frames = 0;
+
+            /** Number of frames that started later than they should have */
+            std::uint32_t late_frames = 0;
+
+            /** Average time between frames in milliseconds */
+            double mean_ms = 0.0;
+
+            /** Standard deviation of the time between frames in milliseconds */
+            double jitter_ms = 0.0;
+
+            /** Largest difference between the time between frames and the interval in milliseconds */
+            double max_deviation_ms = 0.0;
+
+            /** Current estimate for how late sleeping wakes up in milliseconds */
+            double sleep_overshoot_ms = 0.0;
+        };
+
+        /**
+         * Start pacing frames
+         * @param interval time between frames
+         * @param now      current time; the first frame is due now
+         */
+        void start(clock::duration interval, clock::time_point now) noexcept;
+
+        /**
+         * Get when the next frame is due
+         * @return when the next frame is due
+         */
+        clock::time_point next_frame() const noexcept {
+            return this->p_next_frame;
+        }
+
+        /**
+         * Get how long to sleep before spinning until the next frame
+         * @param  now current time
+         * @return     time to sleep, or zero if it's time to spin
+         */
+        clock::duration sleep_duration(clock::time_point now) const noexcept;
+
+        /**
+         * Record how long a sleep actually took so future sleeps can be cut short by the right amount
+         * @param requested time that was requested
+         * @param actual    time that actually passed
+         */
+        void record_sleep(clock::duration requested, clock::duration actual) noexcept;
+
+        /**
+         * Record that the frame has started and schedule the next one
+         * @param now current time
+         */
+        void frame_started(clock::time_point now) noexcept;
+
+        /**
+         * Get the statistics for the last complete measurement window
+         * @return statistics
+         */
+        const Statistics &statistics() const noexcept {
+            return this->p_statistics;
+        }
+
+    private:
+        /** Time to spin before each frame regardless of how accurate sleeping is */
+        static constexpr clock::duration spin_time = std::chrono::microseconds(250);
+
+        /** How long to measure statistics before publishing them */
+        static constexpr clock::duration statistics_window = std::chrono::milliseconds(500);
+
+        /** Time between frames */
+        clock::duration p_interval = clock::duration::zero();
+
+        /** When the next frame is due */
+        clock::time_point p_next_frame;
+
+        /** When the last frame started, if any */
+        clock::time_point p_last_frame;
+        bool p_has_last_frame = false;
+
+        /** How late sleeping wakes up */
+        clock::duration p_sleep_overshoot = clock::duration::zero();
+
+        /** Statistics being measured */
+        clock::time_point p_window_start;
+        std::uint32_t p_window_frames = 0;
+        std::uint32_t p_window_late_frames = 0;
+        double p_window_sum_ms = 0.0;
+        double p_window_sum_squared_ms = 0.0;
+        double p_window_max_deviation_ms = 0.0;
+
+        /** Statistics for the last complete window */
+        Statistics p_statistics;
+    };
+
+    /**
+     * Get the frame pacer used by chimera_throttle_fps
+     * @return frame pacer, or nullptr if the frame rate is not being throttled
+     */
+    const FramePacer *get_throttle_fps_pacer() noexcept;
+}
+
+#endif
@@ -0,0 +1,105 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include <algorithm>
+
+#include "timing_telemetry.hpp"
+
+namespace Chimera {
+    static_assert((TimingRing::CAPACITY & (TimingRing::CAPACITY - 1)) == 0, "TimingRing::CAPACITY must be a power of two");
+
+    void TimingRing::push(const TimingSample &sample) noexcept {
+        auto head = this->p_head.load(std::memory_order_relaxed);
+        auto &slot = this->p_slots[head & (CAPACITY - 1)];
+        slot.time_ns.store(sample.time_ns, std::memory_order_relaxed);
+        slot.tick_count.store(sample.tick_count, std::memory_order_relaxed);
+        slot.type.store(sample.type, std::memory_order_relaxed);
+        this->p_head.store(head + 1, std::memory_order_release);
+    }
+
+    void TimingRing::copy(std::vector<TimingSample> &samples) const {
+        samples.clear();
+
+        auto head = this->p_head.load(std::memory_order_acquire);
+        auto count = std::min<std::uint64_t>(head, CAPACITY);
+        auto first = head - count;
+        samples.reserve(count);
+        for(auto i = first; i < head; i++) {
+            auto &slot = this->p_slots[i & (CAPACITY - 1)];
+            samples.push_back(TimingSample { slot.time_ns.load(std::memory_order_relaxed), slot.tick_count.load(std::memory_order_relaxed), static_cast<TimingSampleType>(slot.type.load(std::memory_order_relaxed)) });
+        }
+
+        // Anything that was overwritten while we were copying is garbage now, so drop it. The sample at new_head may be half written
+        // too, so count it as well.
+        std::atomic_thread_fence(std::memory_order_acquire);
+        auto new_head = this->p_head.load(std::memory_order_relaxed);
+        if(new_head + 1 - first > CAPACITY) {
+            auto overwritten = std::min<std::uint64_t>(new_head + 1 - first - CAPACITY, samples.size());
+            samples.erase(samples.begin(), samples.begin() + overwritten);
+        }
+    }
+
+    void TimingRing::clear() noexcept {
+        this->p_head.store(0, std::memory_order_release);
+    }
+
+    std::vector<double> frame_times_ms(const std::vector<TimingSample> &samples) {
+        std::vector<double> times;
+        const TimingSample *last = nullptr;
+        for(auto &sample : samples) {
+            if(sample.type != TimingSampleType::TIMING_SAMPLE_PREFRAME) {
+                continue;
+            }
+            if(last) {
+                times.push_back((sample.time_ns - last->time_ns) / 1000000.0);
+            }
+            last = &sample;
+        }
+        return times;
+    }
+
+    TimingStatistics compute_timing_statistics(const std::vector<TimingSample> &samples, double tick_interval_ms) {
+        TimingStatistics statistics;
+
+        // Frames
+        auto times = frame_times_ms(samples);
+        statistics.frames = times.size();
+        if(!times.empty()) {
+            auto percentile = [&times](double p) {
+                std::size_t n = std::min(static_cast<std::size_t>(p / 100.0 * times.size()), times.size() - 1);
+                std::nth_element(times.begin(), times.begin() + n, times.end());
+                return times[n];
+            };
+            statistics.frame_p50_ms = percentile(50.0);
+            statistics.frame_p95_ms = percentile(95.0);
+            statistics.frame_p99_ms = percentile(99.0);
+            statistics.frame_max_ms = *std::max_element(times.begin(), times.end());
+            for(double time : times) {
+                if(time > statistics.frame_p50_ms * 2.0) {
+                    statistics.hitches++;
+                }
+            }
+        }
+
+        // Ticks
+        const TimingSample *first_tick = nullptr;
+        const TimingSample *last_tick = nullptr;
+        for(auto &sample : samples) {
+            if(sample.type != TimingSampleType::TIMING_SAMPLE_PRETICK) {
+                continue;
+            }
+            if(!first_tick) {
+                first_tick = &sample;
+            }
+            last_tick = &sample;
+            statistics.ticks++;
+        }
+        if(statistics.ticks > 1) {
+            double elapsed_ms = (last_tick->time_ns - first_tick->time_ns) / 1000000.0;
+            double intervals = static_cast<double>(statistics.ticks - 1);
+            statistics.tick_mean_ms = elapsed_ms / intervals;
+            statistics.tick_drift_ms = elapsed_ms - intervals * tick_interval_ms;
+        }
+
+        return statistics;
+    }
+}
@@ -0,0 +1,120 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#ifndef CHIMERA_TIMING_TELEMETRY_HPP
+#define CHIMERA_TIMING_TELEMETRY_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Chimera {
+    /**
+     * Boundary that a timing sample was taken at
+     */
+    enum TimingSampleType : std::uint8_t {
+        TIMING_SAMPLE_PREFRAME,
+        TIMING_SAMPLE_FRAME,
+        TIMING_SAMPLE_PRETICK,
+        TIMING_SAMPLE_TICK
+    };
+
+    /**
+     * A timestamped frame or tick boundary
+     */
+    struct TimingSample {
+        /** Time in nanoseconds since an arbitrary point */
+        std::int64_t time_ns;
+
+        /** Halo's tick count at the time */
+        std::int32_t tick_count;
+
+        /** Boundary that was reached */
+        TimingSampleType type;
+    };
+
+    /**
+     * Fixed-size ring of timing samples. One thread may push samples while another reads them without either one taking a lock. Once
+     * the ring is full, the oldest samples are overwritten.
+     */
+    class TimingRing {
+    public:
+        /** Number of samples kept. This must be a power of two. */
+        static constexpr std::size_t CAPACITY = 8192;
+
+        /**
+         * Add a sample. Only one thread may call this.
+         * @param sample sample to add
+         */
+        void push(const TimingSample &sample) noexcept;
+
+        /**
+         * Copy every sample in the ring from oldest to newest. This may be called from any thread.
+         * @param samples vector to write to
+         */
+        void copy(std::vector<TimingSample> &samples) const;
+
+        /**
+         * Discard all samples. Only the thread that pushes samples may call this.
+         */
+        void clear() noexcept;
+
+    private:
+        struct Slot {
+            std::atomic<std::int64_t> time_ns;
+            std::atomic<std::int32_t> tick_count;
+            std::atomic<std::uint8_t> type;
+        };
+
+        /** Samples, indexed by the sample number modulo the capacity */
+        Slot p_slots[CAPACITY] = {};
+
+        /** Number of samples ever pushed since the ring was last cleared */
+        std::atomic<std::uint64_t> p_head = 0;
+    };
+
+    /**
+     * Statistics computed from timing samples
+     */
+    struct TimingStatistics {
+        /** Number of frames measured */
+        std::size_t frames = 0;
+
+        /** Frame time percentiles in milliseconds */
+        double frame_p50_ms = 0.0;
+        double frame_p95_ms = 0.0;
+        double frame_p99_ms = 0.0;
+
+        /** Longest frame in milliseconds */
+        double frame_max_ms = 0.0;
+
+        /** Number of frames that took more than twice the median frame time */
+        std::size_t hitches = 0;
+
+        /** Number of ticks measured */
+        std::size_t ticks = 0;
+
+        /** Average time between ticks in milliseconds */
+        double tick_mean_ms = 0.0;
+
+        /** How far behind (positive) or ahead (negative) ticks ran compared to the expected tick rate in milliseconds */
+        double tick_drift_ms = 0.0;
+    };
+
+    /**
+     * Compute frame and tick statistics
+     * @param  samples          samples from oldest to newest
+     * @param  tick_interval_ms expected time between ticks in milliseconds
+     * @return                  statistics
+     */
+    TimingStatistics compute_timing_statistics(const std::vector<TimingSample> &samples, double tick_interval_ms);
+
+    /**
+     * Get the time between consecutive preframe samples
+     * @param  samples samples from oldest to newest
+     * @return         frame times in milliseconds from oldest to newest
+     */
+    std::vector<double> frame_times_ms(const std::vector<TimingSample> &samples);
+}
+
+#endif
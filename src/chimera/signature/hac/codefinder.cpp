@@ -33,17 +33,27 @@ void CodeFinder::findCode(HANDLE module, const short *signature, size_t size, bo
 		return;
 	}
 
+	BYTE* code = (BYTE*)module + CodeSection->VirtualAddress;
+	BYTE* memory = snapshot ? (BYTE*)snapshot : code;
+
 	if(fastFind) {
-		boyerFind(signature, size, (BYTE*)module + CodeSection->VirtualAddress, CodeSection->SizeOfRawData);
+		boyerFind(signature, size, memory, CodeSection->SizeOfRawData);
 	} else {
 		for(size_t i = 0, j = 0; i < CodeSection->SizeOfRawData - size; i++, j = 0) {
-			while(signature[j] == *(reinterpret_cast<BYTE*>(module) + CodeSection->VirtualAddress + i + j) || signature[j] == -1) {
+			while(signature[j] == *(memory + i + j) || signature[j] == -1) {
 				if(++j == size) {
-					locations.emplace_back(CodeSection->VirtualAddress + i + reinterpret_cast<std::uintptr_t>(module));
+					locations.emplace_back(reinterpret_cast<std::uintptr_t>(memory + i));
 				}
 			}
 		}
 	}
+
+	//Translate anything found in the snapshot back to the module
+	if(snapshot) {
+		for(auto &location : locations) {
+			location = location - reinterpret_cast<std::uintptr_t>(snapshot) + reinterpret_cast<std::uintptr_t>(code);
+		}
+	}
 }
 
 std::vector<std::uintptr_t>::iterator CodeFinder::begin() {
@@ -56,10 +66,11 @@ std::vector<std::uintptr_t>::iterator CodeFinder::end() {
 	return locations.end();
 }
 
-CodeFinder::CodeFinder(HANDLE module, const short* signature, unsigned int signatureLen) {
+CodeFinder::CodeFinder(HANDLE module, const short* signature, unsigned int signatureLen, const BYTE* snapshot) {
 	this->module = module;
 	this->signature = signature;
 	this->length = signatureLen;
+	this->snapshot = snapshot;
 }
 
 std::vector<std::uintptr_t> CodeFinder::find() {
@@ -120,3 +131,36 @@ std::uintptr_t FindCode(HANDLE module, const short* signature, size_t signatureL
 		return (std::uintptr_t) NULL;
 	}
 }
+
+std::uintptr_t FindCode(HANDLE module, const BYTE* snapshot, const short* signature, size_t signatureLen) {
+	CodeFinder finder(module, signature, signatureLen, snapshot);
+	std::vector<std::uintptr_t> locations = finder.find();
+
+	if(!locations.empty()) {
+		return locations[0];
+	} else {
+		return (std::uintptr_t) NULL;
+	}
+}
+
+std::vector<BYTE> CopyCodeSection(HANDLE module, const BYTE** code) {
+	std::vector<BYTE> copy;
+	PIMAGE_DOS_HEADER dosHeader = reinterpret_cast<PIMAGE_DOS_HEADER>(module);
+
+	if(dosHeader->e_magic != IMAGE_DOS_SIGNATURE) {
+		return copy;
+	}
+
+	IMAGE_NT_HEADERS* NtHeader = (IMAGE_NT_HEADERS*)((std::uintptr_t)module+dosHeader->e_lfanew);
+	PIMAGE_SECTION_HEADER Section = (PIMAGE_SECTION_HEADER)( (std::uintptr_t)NtHeader + sizeof(IMAGE_NT_HEADERS));
+
+	for(WORD i = 0; i < NtHeader->FileHeader.NumberOfSections; i++, Section++) {
+		if(Section->Characteristics & IMAGE_SCN_MEM_EXECUTE) {
+			*code = (BYTE*)module + Section->VirtualAddress;
+			copy.insert(copy.end(), *code, *code + Section->SizeOfRawData);
+			break;
+		}
+	}
+
+	return copy;
+}
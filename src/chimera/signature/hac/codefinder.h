@@ -11,6 +11,7 @@ class CodeFinder {
 	HANDLE module;
 	unsigned int length;
 	const short* signature;
+	const BYTE* snapshot;
 	std::vector<std::uintptr_t> locations;
 
 	PIMAGE_SECTION_HEADER GetSection(HANDLE module);
@@ -18,7 +19,7 @@ class CodeFinder {
 	void boyerFind(const short* signature, size_t sigLength, BYTE* memory, size_t memLength);
 
 public:
-	CodeFinder(HANDLE module, const short* signature, unsigned int signatureLen);
+	CodeFinder(HANDLE module, const short* signature, unsigned int signatureLen, const BYTE* snapshot = NULL);
 	std::vector<std::uintptr_t>::iterator begin();
 	std::vector<std::uintptr_t>::iterator end();
 	std::vector<std::uintptr_t> find();
@@ -27,4 +28,10 @@ public:
 //Old interface so I don't have to change all of the hooks, for now
 std::uintptr_t FindCode(HANDLE module, const short* signature, size_t signatureLen);
 
+//Search a copy of the module's code section taken with CopyCodeSection, returning the address in the module
+std::uintptr_t FindCode(HANDLE module, const BYTE* snapshot, const short* signature, size_t signatureLen);
+
+//Copy the module's code section so it can be searched after it has been modified
+std::vector<BYTE> CopyCodeSection(HANDLE module, const BYTE** code);
+
 #endif
@@ -1,496 +1,129 @@
 // SPDX-License-Identifier: GPL-3.0-only
 
 #include <windows.h>
+#include <algorithm>
 #include <iostream>
 #include <cstring>
 #include <string>
 
 #include "signature.hpp"
 #include "hook.hpp"
+#include "instruction.hpp"
 
 namespace Chimera {
-    void Hook::rollback() noexcept {
-        if(this->original_bytes.size() == 0) {
+    // Trampolines are carved out of a few executable pages at a time so they stay together in memory and only need protection set once
+    #define TRAMPOLINE_ARENA_SIZE static_cast<std::size_t>(0x10000)
+    #define TRAMPOLINE_ALIGNMENT static_cast<std::size_t>(16)
+
+    struct TrampolineArena {
+        /** Executable pages */
+        std::byte *data;
+
+        /** Bytes handed out so far */
+        std::size_t used;
+    };
+
+    struct FreeTrampoline {
+        /** Trampoline that is no longer used */
+        std::byte *data;
+
+        /** Size of the trampoline */
+        std::size_t size;
+    };
+
+    static std::vector<TrampolineArena> trampoline_arenas;
+    static std::vector<FreeTrampoline> free_trampolines;
+    static std::vector<const Hook *> active_hooks;
+
+    // Make sure the hook has a trampoline of at least the given size, reusing its current one if it's big enough
+    static void allocate_trampoline(Hook &hook, std::size_t size) {
+        size = (size + TRAMPOLINE_ALIGNMENT - 1) & ~(TRAMPOLINE_ALIGNMENT - 1);
+        if(hook.hook && hook.hook_size >= size) {
             return;
         }
-        overwrite(this->address, this->original_bytes.data(), this->original_bytes.size());
-        this->original_bytes.clear();
-    }
-
-    // Get the bytes to the instruction(s) at the given address. I'll modify this as more types of instructions are needed.
-    void get_instructions(const std::byte *at_start, std::vector<std::byte> &bytes, std::vector<std::uintptr_t> &offsets, std::size_t minimum_size = 1) {
-        offsets.clear();
-        const auto *at = at_start;
-
-        // Keep adding instructions until we have what we need.
-        while(bytes.size() < minimum_size) {
-            switch(*reinterpret_cast<const std::uint8_t *>(at)) {
-                // add eax, <val>
-                case 0x05:
-                    offsets.push_back(at - at_start);
-                    bytes.insert(bytes.end(), at, at + 5);
-                    at += 5;
-                    break;
-
-                // jmp <relative offset> or movsx
-                case 0x0F: {
-                    auto op1 = *reinterpret_cast<const std::uint8_t *>(at + 1);
-                    auto op2 = *reinterpret_cast<const std::uint8_t *>(at + 2);
-                    if(op1 == 0x84) {
-                        offsets.push_back(at - at_start);
-                        bytes.insert(bytes.end(), at, at + 6);
-                        at += 6;
-                        break;
-                    }
-                    else if(op1 == 0xBF || op1 == 0xB6 || op1 == 0xB7) {
-                        if(op2 == 0x6E || op2 == 0x4E) {
-                            offsets.push_back(at - at_start);
-                            bytes.insert(bytes.end(), at, at + 4);
-                            at += 4;
-                        }
-                        else if(op2 == 0x15) {
-                            offsets.push_back(at - at_start);
-                            bytes.insert(bytes.end(), at, at + 7);
-                            at += 7;
-                        }
-                        else {
-                            offsets.push_back(at - at_start);
-                            bytes.insert(bytes.end(), at, at + 3);
-                            at += 3;
-                        }
-                        break;
-                    }
-                    else {
-                        std::terminate();
-                    }
-                }
-
-                // and <value>
-                case 0x25: {
-                    offsets.push_back(at - at_start);
-                    bytes.insert(bytes.end(), at, at + 5);
-                    at += 5;
-                    break;
-                }
-
-                // oxr <value>
-                case 0x33: {
-                    auto op1 = *reinterpret_cast<const std::uint8_t *>(at + 1);
-                    if(op1 == 0xDB) {
-                        offsets.push_back(at - at_start);
-                        bytes.insert(bytes.end(), at, at + 2);
-                        at += 2;
-                        break;
-                    }
-                    std::terminate();
-                }
-
-                // cmp ecx, something
-                case 0x3B: {
-                    auto op1 = *reinterpret_cast<const std::uint8_t *>(at + 1);
-                    if(op1 == 0xCD) {
-                        offsets.push_back(at - at_start);
-                        bytes.insert(bytes.end(), at, at + 2);
-                        at += 2;
-                        break;
-                    }
-                    std::terminate();
-                }
-
-
-                // push/pop <register>
-                case 0x50: case 0x54: case 0x58: case 0x5C: case 0x60:
-                case 0x51: case 0x55: case 0x59: case 0x5D: case 0x61:
-                case 0x52: case 0x56: case 0x5A: case 0x5E:
-                case 0x53: case 0x57: case 0x5B: case 0x5F:
-                    offsets.push_back(at - at_start);
-                    bytes.insert(bytes.end(), at, at + 1);
-                    at += 1;
-                    break;
-
-                case 0x66: {
-                    auto op1 = *reinterpret_cast<const std::uint8_t *>(at + 1);
-                    auto op2 = *reinterpret_cast<const std::uint8_t *>(at + 2);
-                    // mov [reg]
-                    if(op1 == 0x89) {
-                        if(op2 == 0x45 || op2 == 0x4A) {
-                            offsets.push_back(at - at_start);
-                            bytes.insert(bytes.end(), at, at + 4);
-                            at += 4;
-                        }
-                        else {
-                            offsets.push_back(at - at_start);
-                            bytes.insert(bytes.end(), at, at + 3);
-                            at += 3;
-                        }
-                        break;
-                    }
-                    // mov word ptr [reg+op4]
-                    else if(op1 == 0xC7) {
-                        if(op2 == 0x45) {
-                            offsets.push_back(at - at_start);
-                            bytes.insert(bytes.end(), at, at + 6);
-                            at += 6;
-                        }
-                        else if(op2 == 0x44) {
-                            offsets.push_back(at - at_start);
-                            bytes.insert(bytes.end(), at, at + 7);
-                            at += 7;
-                        }
-                        break;
-                    }
-                    // sub dword ptr [reg+op4], reg
-                    else if(op1 == 0x29) {
-                        if(op2 == 0x8B) {
-                            offsets.push_back(at - at_start);
-                            bytes.insert(bytes.end(), at, at + 7);
-                            at += 7;
-                        }
-                        break;
-                    }
-                    // mov [addr], ax
-                    else if(op1 == 0xA3) {
-                        offsets.push_back(at - at_start);
-                        bytes.insert(bytes.end(), at, at + 6);
-                        at += 6;
-                        break;
-                    }
-                    // cmp reg, [reg+op3] or mov reg, [reg+op3]
-                    else if(op1 == 0x3B || op1 == 0x3D || op1 == 0x8B) {
-                        offsets.push_back(at - at_start);
-                        bytes.insert(bytes.end(), at, at + 4);
-                        at += 4;
-                        break;
-                    }
-                    std::terminate();
-                }
 
-                // push 0x00000000-0xFFFFFFFF
-                case 0x68: {
-                    offsets.push_back(at - at_start);
-                    bytes.insert(bytes.end(), at, at + 5);
-                    at += 5;
-                    break;
-                }
-
-                // push 0x00000000-0xFFFFFFFF
-                case 0x69: {
-                    auto op1 = *reinterpret_cast<const std::uint8_t *>(at + 1);
-                    if(op1 == 0xFF) {
-                        offsets.push_back(at - at_start);
-                        bytes.insert(bytes.end(), at, at + 6);
-                        at += 6;
-                        break;
-                    }
-                    std::terminate();
-                }
-
-                // push 0x00-0xFF
-                case 0x6A: {
-                    offsets.push_back(at - at_start);
-                    bytes.insert(bytes.end(), at, at + 2);
-                    at += 2;
-                    break;
-                }
-
-                // jz short
-                case 0x74: {
-                    offsets.push_back(at - at_start);
-                    bytes.insert(bytes.end(), at, at + 2);
-                    at += 2;
-                    break;
-                }
-
-                // jmp 0x00-0x7F
-                case 0x7D: {
-                    auto op1 = *reinterpret_cast<const std::uint8_t *>(at + 1);
-                    if(op1 < 0x80) {
-                        offsets.push_back(at - at_start);
-                        bytes.insert(bytes.end(), at, at + 2);
-                        at += 2;
-                        break;
-                    }
-                    std::terminate();
-                }
-
-                // add/or/adc/sbb/and/sub/xor/cmp <something> 0x00000000-0x7FFFFFFF
-                case 0x81: {
-                    auto op1 = *reinterpret_cast<const std::uint8_t *>(at + 1);
-                    // add/or/adc/sbb/and/sub/xor/cmp <register> 0x00000000-0x7FFFFFFF
-                    if(op1 >= 0xC0 || op1 == 0x0D) {
-                        offsets.push_back(at - at_start);
-                        bytes.insert(bytes.end(), at, at + 6);
-                        at += 6;
-                    }
-                    else {
-                        std::terminate();
-                    }
-                    break;
-                }
-
-                // add/or/adc/sbb/and/sub/xor/cmp <something> 0x00-0x7F
-                case 0x83: {
-                    auto op1 = *reinterpret_cast<const std::uint8_t *>(at + 1);
-                    // add/or/adc/sbb/and/sub/xor/cmp <register> 0x00 - 0x7F
-                    if(op1 >= 0xC0) {
-                        offsets.push_back(at - at_start);
-                        bytes.insert(bytes.end(), at, at + 3);
-                        at += 3;
-                    }
-                    else {
-                        std::terminate();
-                    }
-                    break;
-                }
-
-                // test <something>, <something>
-                case 0x84:
-                case 0x85: {
-                    auto op1 = *reinterpret_cast<const std::uint8_t *>(at + 1);
-                    // add/or/adc/sbb/and/sub/xor/cmp <register> 0x00 - 0x7F
-                    if(op1 >= 0xC0) {
-                        offsets.push_back(at - at_start);
-                        bytes.insert(bytes.end(), at, at + 2);
-                        at += 2;
-                        break;
-                    }
-                    else {
-                        std::terminate();
-                    }
-                }
-
-                // idk
-                case 0x89: {
-                    auto a = *reinterpret_cast<const std::uint8_t *>(at + 1);
-                    if(a == 0x06) {
-                        offsets.push_back(at - at_start);
-                        bytes.insert(bytes.end(), at, at + 2);
-                        at += 2;
-                        break;
-                    }
-
-                    if(a == 0x15) {
-                        offsets.push_back(at - at_start);
-                        bytes.insert(bytes.end(), at, at + 6);
-                        at += 6;
-                        break;
-                    }
-
-                    if(a == 0x6C || a == 0x4C) {
-                        offsets.push_back(at - at_start);
-                        bytes.insert(bytes.end(), at, at + 4);
-                        at += 4;
-                        break;
-                    }
-
-                    auto b = *reinterpret_cast<const std::uint8_t *>(at + 2);
-                    if(a == 0xC && b == 0x85) {
-                        offsets.push_back(at - at_start);
-                        bytes.insert(bytes.end(), at, at + 7);
-                        at += 7;
-                        break;
-                    }
-
-                    if((a == 0x94 || a == 0x84) && b == 0x24) {
-                        offsets.push_back(at - at_start);
-                        bytes.insert(bytes.end(), at, at + 7);
-                        at += 7;
-                        break;
-                    }
-
-                    std::terminate();
-                }
-
-                // mov bl, [eax+esi]
-                case 0x8A: {
-                    auto a = *reinterpret_cast<const std::uint8_t *>(at + 1);
-                    if(a == 0x1C || a == 0x48) {
-                        offsets.push_back(at - at_start);
-                        bytes.insert(bytes.end(), at, at + 3);
-                        at += 3;
-                        break;
-                    }
-
-                    std::terminate();
-                }
-
-                // moving stuff
-                case 0x8B: {
-                    auto a = *reinterpret_cast<const std::uint8_t *>(at + 1);
-                    auto b = *reinterpret_cast<const std::uint8_t *>(at + 2);
-                    if((a == 0x6C || a == 0x4C || a == 0x44 || a == 0x54) && b == 0x24) {
-                        offsets.push_back(at - at_start);
-                        bytes.insert(bytes.end(), at, at + 4);
-                        at += 4;
-                        break;
-                    }
-                    else if(a == 0xE5 || a == 0xF8 || a == 0xC3 || a == 0xC2 || a == 0xEC) {
-                        offsets.push_back(at - at_start);
-                        bytes.insert(bytes.end(), at, at + 2);
-                        at += 2;
-                        break;
-                    }
-                    else if(a == 0x50 || a == 0x40) {
-                        offsets.push_back(at - at_start);
-                        bytes.insert(bytes.end(), at, at + 3);
-                        at += 3;
-                        break;
-                    }
-                    else if(a == 0x93 || a == 0x0D || a == 0x2D || a == 0x1D || a == 0x83) {
-                        offsets.push_back(at - at_start);
-                        bytes.insert(bytes.end(), at, at + 6);
-                        at += 6;
-                        break;
-                    }
-                    std::terminate();
-                }
-
-                // lea
-                case 0x8D: {
-                    auto a = *reinterpret_cast<const std::uint8_t *>(at + 1);
-                    auto b = *reinterpret_cast<const std::uint8_t *>(at + 2);
-                    if(a == 0x44 && (b == 0x0C || b == 0x24)) {
-                        offsets.push_back(at - at_start);
-                        bytes.insert(bytes.end(), at, at + 4);
-                        at += 4;
-                        break;
-                    }
-                    else if(a == 0x7E) {
-                        offsets.push_back(at - at_start);
-                        bytes.insert(bytes.end(), at, at + 3);
-                        at += 3;
-                        break;
-                    }
-
-                    std::terminate();
-                }
+        // Give back the old one
+        if(hook.hook) {
+            free_trampolines.push_back({hook.hook, hook.hook_size});
+            hook.hook = nullptr;
+            hook.hook_size = 0;
+        }
+        else {
+            active_hooks.push_back(&hook);
+        }
 
-                // shl
-                case 0xD3: {
-                    auto a = *reinterpret_cast<const std::uint8_t *>(at + 1);
-                    if(a == 0xE3) {
-                        offsets.push_back(at - at_start);
-                        bytes.insert(bytes.end(), at, at + 2);
-                        at += 2;
-                        break;
-                    }
-
-                    std::terminate();
-                }
+        // See if something was given back that we can use
+        for(auto t = free_trampolines.begin(); t != free_trampolines.end(); t++) {
+            if(t->size >= size) {
+                hook.hook = t->data;
+                hook.hook_size = t->size;
+                free_trampolines.erase(t);
+                return;
+            }
+        }
 
-                // nop
-                case 0x90: {
-                    offsets.push_back(at - at_start);
-                    bytes.insert(bytes.end(), at, at + 1);
-                    at ++;
-                    break;
-                }
+        // Otherwise, take more from the arena, getting a new one if we ran out
+        if(trampoline_arenas.size() == 0 || trampoline_arenas.back().used + size > TRAMPOLINE_ARENA_SIZE) {
+            // Give it PAGE_EXECUTE_READWRITE so the Discord overlay doesn't crash Halo
+            auto *data = reinterpret_cast<std::byte *>(VirtualAlloc(nullptr, TRAMPOLINE_ARENA_SIZE, MEM_RESERVE | MEM_COMMIT, PAGE_EXECUTE_READWRITE));
+            if(!data) {
+                std::terminate();
+            }
 
-                // mov al, byte [something]
-                case 0xA0:
-                // mov eax, dword [something]
-                case 0xA1:
-                // move byte [something], al
-                case 0xA2:
-                // move dword [something], eax
-                case 0xA3: {
-                    offsets.push_back(at - at_start);
-                    bytes.insert(bytes.end(), at, at + 5);
-                    at += 5;
-                    break;
-                }
+            // Fill it with int3 so anything that jumps into unused space breaks immediately
+            std::memset(data, 0xCC, TRAMPOLINE_ARENA_SIZE);
+            trampoline_arenas.push_back({data, 0});
+        }
 
-                // mov something
-                case 0xBA:
-                case 0xBE: {
-                    offsets.push_back(at - at_start);
-                    bytes.insert(bytes.end(), at, at + 5);
-                    at += 5;
-                    break;
-                }
+        auto &arena = trampoline_arenas.back();
+        hook.hook = arena.data + arena.used;
+        hook.hook_size = size;
+        arena.used += size;
+    }
 
-                // mov something
-                case 0xC7: {
-                    auto a = *reinterpret_cast<const std::uint8_t *>(at + 1);
-                    if(a == 0x05) {
-                        offsets.push_back(at - at_start);
-                        bytes.insert(bytes.end(), at, at + 6);
-                        at += 6;
-                        break;
-                    }
-                    else if(a == 0x44) {
-                        offsets.push_back(at - at_start);
-                        bytes.insert(bytes.end(), at, at + 8);
-                        at += 8;
-                        break;
-                    }
-                    std::terminate();
-                }
+    // Give back the hook's trampoline so another hook can use it
+    static void free_trampoline(Hook &hook) {
+        if(!hook.hook) {
+            return;
+        }
+        free_trampolines.push_back({hook.hook, hook.hook_size});
+        hook.hook = nullptr;
+        hook.hook_size = 0;
+        active_hooks.erase(std::remove(active_hooks.begin(), active_hooks.end(), &hook), active_hooks.end());
+    }
 
-                // fld
-                case 0xD9: {
-                    auto op1 = *reinterpret_cast<const std::uint8_t *>(at + 1);
-                    if(op1 == 0x47) {
-                        offsets.push_back(at - at_start);
-                        bytes.insert(bytes.end(), at, at + 3);
-                        at += 3;
-                        break;
-                    }
-                    else if(op1 == 0xC0) {
-                        offsets.push_back(at - at_start);
-                        bytes.insert(bytes.end(), at, at + 2);
-                        at += 2;
-                        break;
-                    }
-                    else if(op1 == 0x1C || op1 == 0x9C) {
-                        offsets.push_back(at - at_start);
-                        bytes.insert(bytes.end(), at, at + 7);
-                        at += 7;
-                        break;
-                    }
-                    std::terminate();
-                }
+    const std::vector<const Hook *> &get_active_hooks() noexcept {
+        return active_hooks;
+    }
 
-                // call <relative offset>
-                case 0xE8:
-                    offsets.push_back(at - at_start);
-                    bytes.insert(bytes.end(), at, at + 5);
-                    at += 5;
-                    break;
-
-                // call dword ptr[x]
-                case 0xFF: {
-                    auto op1 = *reinterpret_cast<const std::uint8_t *>(at + 1);
-                    if(op1 == 0x51 || op1 == 0x52) {
-                        offsets.push_back(at - at_start);
-                        bytes.insert(bytes.end(), at, at + 3);
-                        at += 3;
-                    }
-                    else if(op1 == 0x54) {
-                        offsets.push_back(at - at_start);
-                        bytes.insert(bytes.end(), at, at + 4);
-                        at += 4;
-                    }
-                    else if(op1 == 0x15 || op1 == 0x92) {
-                        offsets.push_back(at - at_start);
-                        bytes.insert(bytes.end(), at, at + 6);
-                        at += 6;
-                    }
-                    else {
-                        std::terminate();
-                    }
-                    break;
-                }
+    void Hook::rollback() noexcept {
+        if(this->original_bytes.size() == 0) {
+            return;
+        }
+        overwrite(this->address, this->original_bytes.data(), this->original_bytes.size());
+        this->original_bytes.clear();
+    }
 
-                // Terminate. We don't know what to do.
-                default:
-                    std::cout << "Cannot figure out what's at " << std::to_string(reinterpret_cast<std::uintptr_t>(at)) << std::endl;
-                    std::terminate();
-            }
+    // Overwrite the original bytes with a jmp instruction to the hook followed by NOPs. If that can't be done, the hook is left without
+    // original bytes or a trampoline, since nothing was patched.
+    static bool write_jmp_to_hook(Hook &hook, std::size_t size) {
+        auto *jmp_at = hook.address;
+        auto *hook_data = hook.hook;
+        std::vector<std::byte> jmp(size, static_cast<std::byte>(0x90));
+        jmp[0] = static_cast<std::byte>(0xE9);
+        *reinterpret_cast<std::uintptr_t *>(jmp.data() + 1) = hook_data - (jmp_at + 5);
+
+        PatchTransaction patch;
+        patch.overwrite(jmp_at, jmp.data(), jmp.size());
+        if(!patch.commit()) {
+            hook.original_bytes.clear();
+            free_trampoline(hook);
+            return false;
         }
+        return true;
     }
 
-    void write_jmp_call(void *jmp_at, Hook &hook, const void *call_before, const void *call_after, bool pushad_pushfd) {
+    bool write_jmp_call(void *jmp_at, Hook &hook, const void *call_before, const void *call_after, bool pushad_pushfd) {
         // Rollback the hook if not already done so
         hook.rollback();
 
@@ -498,35 +131,23 @@ namespace Chimera {
         hook.address = reinterpret_cast<std::byte *>(jmp_at);
 
         // Get the instructions
-        std::vector<std::uintptr_t> offsets;
-        std::vector<std::byte> bytes;
+        RelocatedInstructions instructions;
         std::byte *jmp_at_byte = reinterpret_cast<std::byte *>(jmp_at);
-        get_instructions(jmp_at_byte, bytes, offsets, 5);
+        if(!instructions.relocate(jmp_at_byte, 5)) {
+            std::cout << "Cannot figure out what's at " << std::to_string(reinterpret_cast<std::uintptr_t>(jmp_at_byte)) << std::endl;
+            return false;
+        }
 
-        // Calculate how much data we'll need. (size of bytes plus 9 bytes per call [5 for the call and 4 for pushad/popad and pushfd/popfd])
+        // Calculate how much data we'll need. (size of the relocated code plus 9 bytes per call [5 for the call and 4 for pushad/popad and pushfd/popfd])
         std::size_t added_pushad_bytes = pushad_pushfd ? 4 : 0;
-        std::size_t size = bytes.size() + (call_before ? 5 + added_pushad_bytes : 0) + (call_after ? 5 + added_pushad_bytes : 0) + 5;
+        std::size_t size = instructions.code.size() + (call_before ? 5 + added_pushad_bytes : 0) + (call_after ? 5 + added_pushad_bytes : 0) + 5;
 
         // Back up the original bytes
-        hook.original_bytes.insert(hook.original_bytes.end(), jmp_at_byte, jmp_at_byte + bytes.size());
+        hook.original_bytes.insert(hook.original_bytes.end(), jmp_at_byte, jmp_at_byte + instructions.original_size);
 
         // Now make the hook
-        hook.hook = std::make_unique<std::byte []>(size);
-        auto *hook_data = hook.hook.get();
-        DWORD old_protection;
-
-        // Give it PAGE_EXECUTE_READWRITE so the Discord overlay doesn't crash Halo
-        VirtualProtect(hook_data, size, PAGE_EXECUTE_READWRITE, &old_protection);
-
-        // Overwrite the original bytes with NOPs and a jmp instruction
-        DWORD new_protection = PAGE_EXECUTE_READWRITE;
-        VirtualProtect(jmp_at_byte, bytes.size(), new_protection, &old_protection);
-        *reinterpret_cast<std::uint8_t *>(jmp_at_byte) = 0xE9;
-        *reinterpret_cast<std::uintptr_t *>(jmp_at_byte + 1) = hook_data - (jmp_at_byte + 5);
-        std::memset(jmp_at_byte + 5, 0x90, bytes.size() - 5);
-        if(old_protection != new_protection) {
-            VirtualProtect(jmp_at, bytes.size(), old_protection, &new_protection);
-        }
+        allocate_trampoline(hook, size);
+        auto *hook_data = hook.hook;
 
         // Let's do dis
         auto add_call = [&pushad_pushfd](const void *where, std::byte *data) {
@@ -555,21 +176,9 @@ namespace Chimera {
             hook_data += 5 + added_pushad_bytes;
         }
 
-        // Copy the original instructions
-        std::copy(bytes.data(), bytes.data() + bytes.size(), hook_data);
-
-        // Look for any call instructions to modify before proceeding
-        for(const std::uintptr_t &offset : offsets) {
-            if(*reinterpret_cast<std::uint8_t *>(hook_data + offset) == 0xE8) {
-                // Find where this call instruction is calling.
-                auto &op = *reinterpret_cast<std::uintptr_t *>(hook_data + offset + 1);
-                const auto *actual_address = (jmp_at_byte + offset + 5) + op;
-
-                // Update the instruction
-                op = reinterpret_cast<std::uintptr_t>(actual_address) - reinterpret_cast<std::uintptr_t>(hook_data + offset + 5);
-            }
-        }
-        hook_data += bytes.size();
+        // Copy the original instructions (this also points any relative branches back to where they went)
+        instructions.write(hook_data);
+        hook_data += instructions.code.size();
 
         // Add the other call
         if(call_after) {
@@ -579,10 +188,13 @@ namespace Chimera {
 
         // Add the jmp instruction to exit this hook
         *reinterpret_cast<std::uint8_t *>(hook_data) = 0xE9;
-        *reinterpret_cast<std::uintptr_t *>(hook_data + 1) = (jmp_at_byte + bytes.size()) - (hook_data + 5);
+        *reinterpret_cast<std::uintptr_t *>(hook_data + 1) = (jmp_at_byte + instructions.original_size) - (hook_data + 5);
+
+        // Now that the hook is ready, jump to it
+        return write_jmp_to_hook(hook, instructions.original_size);
     }
 
-    void write_function_override(void *jmp_at, Hook &hook, const void *new_function, const void **original_function) {
+    bool write_function_override(void *jmp_at, Hook &hook, const void *new_function, const void **original_function) {
         // Rollback the hook if not already done so
         hook.rollback();
 
@@ -590,60 +202,44 @@ namespace Chimera {
         hook.address = reinterpret_cast<std::byte *>(jmp_at);
 
         // Get the instructions
-        std::vector<std::uintptr_t> offsets;
-        std::vector<std::byte> bytes;
+        RelocatedInstructions instructions;
         std::byte *jmp_at_byte = reinterpret_cast<std::byte *>(jmp_at);
-        get_instructions(jmp_at_byte, bytes, offsets, 5);
+        if(!instructions.relocate(jmp_at_byte, 5)) {
+            std::cout << "Cannot figure out what's at " << std::to_string(reinterpret_cast<std::uintptr_t>(jmp_at_byte)) << std::endl;
+            *original_function = jmp_at;
+            return false;
+        }
 
-        // Calculate how much data we'll need. (five bytes for jmping to new_function, the size of bytes, and five bytes to jmp back to the original function)
-        std::size_t size = 5 + bytes.size() + 5;
+        // Calculate how much data we'll need. (five bytes for jmping to new_function, the size of the relocated code, and five bytes to jmp back to the original function)
+        std::size_t size = 5 + instructions.code.size() + 5;
 
         // Back up the original bytes
-        hook.original_bytes.insert(hook.original_bytes.end(), jmp_at_byte, jmp_at_byte + bytes.size());
+        hook.original_bytes.insert(hook.original_bytes.end(), jmp_at_byte, jmp_at_byte + instructions.original_size);
 
         // Now make the hook
-        hook.hook = std::make_unique<std::byte []>(size);
-        auto *hook_data = hook.hook.get();
-        DWORD old_protection;
-
-        // Give it PAGE_EXECUTE_READWRITE so the Discord overlay doesn't crash Halo
-        VirtualProtect(hook_data, size, PAGE_EXECUTE_READWRITE, &old_protection);
-
-        // Overwrite the original bytes with NOPs and a jmp instruction
-        DWORD new_protection = PAGE_EXECUTE_READWRITE;
-        VirtualProtect(jmp_at_byte, bytes.size(), new_protection, &old_protection);
-        *reinterpret_cast<std::uint8_t *>(jmp_at_byte) = 0xE9;
-        *reinterpret_cast<std::uintptr_t *>(jmp_at_byte + 1) = hook_data - (jmp_at_byte + 5);
-        std::memset(jmp_at_byte + 5, 0x90, bytes.size() - 5);
-        if(old_protection != new_protection) {
-            VirtualProtect(jmp_at, bytes.size(), old_protection, &new_protection);
-        }
+        allocate_trampoline(hook, size);
+        auto *hook_data = hook.hook;
 
         // Write a jmp to the new function
         *reinterpret_cast<std::uint8_t *>(hook_data) = 0xE9;
         *reinterpret_cast<std::uintptr_t *>(hook_data + 1) = reinterpret_cast<const std::byte *>(new_function) - (hook_data + 5);
         hook_data += 5;
 
-        // Copy the original instructions
-        std::copy(bytes.data(), bytes.data() + bytes.size(), hook_data);
+        // Copy the original instructions (this also points any relative branches back to where they went)
+        instructions.write(hook_data);
         *original_function = hook_data;
 
-        // Look for any call instructions to modify before proceeding
-        for(const std::uintptr_t &offset : offsets) {
-            if(*reinterpret_cast<std::uint8_t *>(hook_data + offset) == 0xE8) {
-                // Find where this call instruction is calling.
-                auto &op = *reinterpret_cast<std::uintptr_t *>(hook_data + offset + 1);
-                const auto *actual_address = (jmp_at_byte + offset + 5) + op;
-
-                // Update the instruction
-                op = reinterpret_cast<std::uintptr_t>(actual_address) - reinterpret_cast<std::uintptr_t>(hook_data + offset + 5);
-            }
-        }
-
         // Write a jmp to the original function after all is said and done
-        hook_data += bytes.size();
+        hook_data += instructions.code.size();
         *reinterpret_cast<std::uint8_t *>(hook_data) = 0xE9;
-        *reinterpret_cast<std::uintptr_t *>(hook_data + 1) = reinterpret_cast<const std::byte *>(jmp_at) + bytes.size() - (hook_data + 5);
+        *reinterpret_cast<std::uintptr_t *>(hook_data + 1) = jmp_at_byte + instructions.original_size - (hook_data + 5);
+
+        // Now that the hook is ready, jump to it. If that didn't work, the original function is still where it was.
+        if(!write_jmp_to_hook(hook, instructions.original_size)) {
+            *original_function = jmp_at;
+            return false;
+        }
+        return true;
     }
 
     void write_code(void *pointer, const SigByte *data, std::size_t length) noexcept {
@@ -654,6 +250,7 @@ namespace Chimera {
         VirtualProtect(pointer, length, new_protection, &old_protection);
 
         // Copy
+        remember_original_code(pointer, length);
         for(std::size_t i = 0; i < length; i++) {
             if(data[i] != -1) {
                 *(reinterpret_cast<std::uint8_t *>(pointer) + i) = static_cast<std::uint8_t>(data[i]);
@@ -665,4 +262,120 @@ namespace Chimera {
             VirtualProtect(pointer, length, old_protection, &new_protection);
         }
     }
+
+    // Halo only runs on x86, so pages are always 4 KiB
+    #define PATCH_PAGE_SIZE static_cast<std::uintptr_t>(0x1000)
+
+    void PatchTransaction::queue(void *pointer, const std::byte *data, std::size_t length) {
+        if(length == 0) {
+            return;
+        }
+        auto &write = this->p_writes.emplace_back();
+        write.address = reinterpret_cast<std::byte *>(pointer);
+        write.data.insert(write.data.end(), data, data + length);
+    }
+
+    void PatchTransaction::write_code(void *pointer, const SigByte *data, std::size_t length) {
+        // Queue each run of non-wildcard bytes as its own write
+        auto *pointer_byte = reinterpret_cast<std::byte *>(pointer);
+        std::size_t i = 0;
+        while(i < length) {
+            if(data[i] == -1) {
+                i++;
+                continue;
+            }
+
+            std::size_t run_start = i;
+            std::vector<std::byte> run;
+            while(i < length && data[i] != -1) {
+                run.push_back(static_cast<std::byte>(data[i]));
+                i++;
+            }
+            this->queue(pointer_byte + run_start, run.data(), run.size());
+        }
+    }
+
+    template<typename F> bool PatchTransaction::with_pages_unprotected(F function) noexcept {
+        // Get every page touched, sorted and without duplicates
+        std::vector<std::uintptr_t> pages;
+        std::uintptr_t lowest = UINTPTR_MAX, highest = 0;
+        for(auto &write : this->p_writes) {
+            auto start = reinterpret_cast<std::uintptr_t>(write.address);
+            auto end = start + write.data.size();
+            lowest = std::min(lowest, start);
+            highest = std::max(highest, end);
+            for(auto page = start & ~(PATCH_PAGE_SIZE - 1); page < end; page += PATCH_PAGE_SIZE) {
+                pages.push_back(page);
+            }
+        }
+        std::sort(pages.begin(), pages.end());
+        pages.erase(std::unique(pages.begin(), pages.end()), pages.end());
+
+        // Unprotect each page once. If we can't, put back what we did and give up before writing anything.
+        std::vector<DWORD> old_protections(pages.size());
+        for(std::size_t p = 0; p < pages.size(); p++) {
+            if(!VirtualProtect(reinterpret_cast<void *>(pages[p]), PATCH_PAGE_SIZE, PAGE_EXECUTE_READWRITE, &old_protections[p])) {
+                DWORD unused;
+                while(p-- > 0) {
+                    VirtualProtect(reinterpret_cast<void *>(pages[p]), PATCH_PAGE_SIZE, old_protections[p], &unused);
+                }
+                return false;
+            }
+        }
+
+        function();
+
+        // Restore the older protection unless it's the same
+        for(std::size_t p = 0; p < pages.size(); p++) {
+            DWORD unused;
+            if(old_protections[p] != PAGE_EXECUTE_READWRITE) {
+                VirtualProtect(reinterpret_cast<void *>(pages[p]), PATCH_PAGE_SIZE, old_protections[p], &unused);
+            }
+        }
+
+        // Flush the instruction cache once for everything we touched
+        if(pages.size() > 0) {
+            FlushInstructionCache(GetCurrentProcess(), reinterpret_cast<const void *>(lowest), highest - lowest);
+        }
+
+        return true;
+    }
+
+    bool PatchTransaction::commit() noexcept {
+        if(this->p_committed) {
+            return false;
+        }
+
+        this->p_committed = this->with_pages_unprotected([this]() {
+            // Back up each write's original data right before it's written so overlapping writes roll back correctly
+            for(auto &write : this->p_writes) {
+                write.original_data.assign(write.address, write.address + write.data.size());
+                remember_original_code(write.address, write.data.size());
+                std::copy(write.data.begin(), write.data.end(), write.address);
+            }
+        });
+
+        return this->p_committed;
+    }
+
+    void PatchTransaction::rollback() noexcept {
+        if(!this->p_committed) {
+            return;
+        }
+
+        bool restored = this->with_pages_unprotected([this]() {
+            for(auto write = this->p_writes.rbegin(); write != this->p_writes.rend(); write++) {
+                std::copy(write->original_data.begin(), write->original_data.end(), write->address);
+                write->original_data.clear();
+            }
+        });
+
+        if(restored) {
+            this->p_committed = false;
+        }
+    }
+
+    bool PatchTransaction::committed() const noexcept {
+        return this->p_committed;
+    }
 }
@@ -22,15 +22,32 @@ namespace Chimera {
         /** This is the address to the first modified byte in Halo's code. */
         std::byte *address;
 
-        /** This is the code being jumped to. */
-        std::unique_ptr<std::byte []> hook;
+        /** This is the code being jumped to. It is allocated from the trampoline arena and reused if the hook is written again. */
+        std::byte *hook = nullptr;
+
+        /** This is the number of bytes allocated for the code being jumped to. */
+        std::size_t hook_size = 0;
 
         /**
          * Roll back the hook. This will write original_bytes to address and then clear original_bytes.
          */
         void rollback() noexcept;
+
+        Hook() = default;
+
+        /** Hooks are tracked by address once they have a trampoline, so they can't be copied or moved. */
+        Hook(const Hook &) = delete;
+        Hook(Hook &&) = delete;
+        Hook &operator=(const Hook &) = delete;
+        Hook &operator=(Hook &&) = delete;
     };
 
+    /**
+     * Get every hook that currently has a trampoline allocated. This is intended for debugging.
+     * @return hooks with trampolines
+     */
+    const std::vector<const Hook *> &get_active_hooks() noexcept;
+
     /**
      * Write an x86 jmp instruction over the given instruction, copying the original instruction to a hook.
      * @param jmp_at             This is a pointer to the instruction to overwrite.
@@ -38,17 +55,22 @@ namespace Chimera {
      * @param call_before        This is the function to call before the original instruction is run.
      * @param call_after         This is the function to call after the original instruction is run and just before returning to Halo's code.
      * @param bool pushad_pushfd Use pushad/pushfd
+     * @return                   true if the hook was written, false if the instructions at jmp_at could not be relocated or the
+     *                           jmp to the hook could not be written
      */
-    void write_jmp_call(void *jmp_at, Hook &hook, const void *call_before = nullptr, const void *call_after = nullptr, bool pushad_pushfd = true);
+    bool write_jmp_call(void *jmp_at, Hook &hook, const void *call_before = nullptr, const void *call_after = nullptr, bool pushad_pushfd = true);
 
     /**
      * Override the given function with a function.
      * @param jmp_at            This is a pointer to the function to override.
      * @param hook              This is the hook to write the changes to.
      * @param new_function      This is the function to override with.
-     * @param original_function This is an address that can be called for the original function.
+     * @param original_function This is an address that can be called for the original function. If the hook could not be written,
+     *                          this is set to jmp_at.
+     * @return                  true if the hook was written, false if the instructions at jmp_at could not be relocated or the jmp
+     *                          to the hook could not be written
      */
-    void write_function_override(void *jmp_at, Hook &hook, const void *new_function, const void **original_function);
+    bool write_function_override(void *jmp_at, Hook &hook, const void *new_function, const void **original_function);
 
     /**
      * Overwrite the data at the pointer with the given bytes, ignoring any wildcard bytes.
@@ -65,10 +87,7 @@ namespace Chimera {
      */
     #define write_code_s(pointer, data) \
         static_assert(sizeof(data[0]) == sizeof(SigByte), "write_code_s requires a SigByte");\
-        for(std::size_t i = 0; i < sizeof(data) / sizeof(data[0]); i++) {\
-            if(data[i] == -1) continue;\
-            overwrite(pointer + i, static_cast<std::uint8_t>(data[i]));\
-        }
+        write_code(pointer, data, sizeof(data) / sizeof(data[0]))
 
     /**
      * Overwrite the data at the pointer with the given data even if this pointer is read-only.
@@ -84,6 +103,7 @@ namespace Chimera {
         VirtualProtect(pointer, length, new_protection, &old_protection);
 
         // Copy
+        remember_original_code(pointer, sizeof(T) * length);
         std::copy(data, data + length, reinterpret_cast<T *>(pointer));
 
         // Restore the older protection unless it's the same
@@ -100,6 +120,99 @@ namespace Chimera {
     template<typename T> inline void overwrite(void *pointer, const T &data) noexcept {
         return overwrite(pointer, &data, 1);
     }
+
+    /**
+     * A patch transaction queues writes to Halo's code and applies them all at once, changing each page's protection only once and flushing
+     * the instruction cache only once. Everything it wrote can then be rolled back together.
+     */
+    class PatchTransaction {
+    public:
+        /**
+         * Queue overwriting the data at the pointer with the given data
+         * @param pointer This is the pointer that points to the data to be overwritten.
+         * @param data    This is the pointer that points to the data to be copied.
+         * @param length  This is the length of the data.
+         */
+        template<typename T> void overwrite(void *pointer, const T *data, std::size_t length) {
+            this->queue(pointer, reinterpret_cast<const std::byte *>(data), sizeof(T) * length);
+        }
+
+        /**
+         * Queue overwriting the data at the pointer with the given data
+         * @param pointer This is the pointer that points to the data to be overwritten.
+         * @param data    This is the data to be copied.
+         */
+        template<typename T> void overwrite(void *pointer, const T &data) {
+            this->overwrite(pointer, &data, 1);
+        }
+
+        /**
+         * Queue overwriting the data at the pointer with the given bytes, ignoring any wildcard bytes.
+         * @param pointer This is the pointer that points to the data to be overwritten.
+         * @param data    This is the pointer that points to the data to be copied, excluding wildcards.
+         * @param length  This is the length of the data.
+         */
+        void write_code(void *pointer, const SigByte *data, std::size_t length);
+
+        /**
+         * Queue overwriting the data at the pointer with the given SigByte array, ignoring any wildcard bytes.
+         * @param pointer This is the pointer that points to the data to be overwritten.
+         * @param data    This is the array to be copied, excluding wildcards.
+         */
+        template<std::size_t length> void write_code(void *pointer, const SigByte (&data)[length]) {
+            this->write_code(pointer, data, length);
+        }
+
+        /**
+         * Apply every queued write. If any page cannot be made writable, nothing is written.
+         * @return true if everything was written
+         */
+        bool commit() noexcept;
+
+        /**
+         * Restore everything written by commit(), in reverse order. The writes stay queued so the transaction can be committed again.
+         */
+        void rollback() noexcept;
+
+        /**
+         * Check if the transaction has been committed and not rolled back
+         * @return true if committed
+         */
+        bool committed() const noexcept;
+
+    private:
+        struct Write {
+            /** Address being written to */
+            std::byte *address;
+
+            /** Data to write */
+            std::vector<std::byte> data;
+
+            /** Data that was there before the write was committed */
+            std::vector<std::byte> original_data;
+        };
+
+        /** Writes in the order they were queued */
+        std::vector<Write> p_writes;
+
+        /** Whether the writes are currently applied */
+        bool p_committed = false;
+
+        /**
+         * Queue a write
+         * @param pointer address to write to
+         * @param data    data to write
+         * @param length  length of the data
+         */
+        void queue(void *pointer, const std::byte *data, std::size_t length);
+
+        /**
+         * Make every page touched by the writes writable, run the function, then restore the protection
+         * @param  function function to run while the pages are writable
+         * @return          true if the pages could be made writable and the function was run
+         */
+        template<typename F> bool with_pages_unprotected(F function) noexcept;
+    };
 }
 
 #endif
@@ -0,0 +1,315 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include <cstring>
+#include "instruction.hpp"
+
+namespace Chimera {
+    // Instructions can't be longer than this
+    #define MAX_INSTRUCTION_LENGTH 15
+
+    // Opcode flags
+    #define M  0x01 // ModRM byte (plus SIB and displacement)
+    #define I8 0x02 // 8-bit immediate
+    #define IW 0x04 // 16-bit immediate
+    #define IZ 0x08 // 32-bit immediate (16-bit with an operand size prefix)
+    #define R8 0x10 // 8-bit relative branch
+    #define RZ 0x20 // 32-bit relative branch (16-bit with an operand size prefix)
+    #define MO 0x40 // 32-bit memory offset (16-bit with an address size prefix)
+    #define XX 0x80 // Invalid or unsupported
+    #define __ 0x00 // Just the opcode
+
+    // One-byte opcodes. Prefixes and 0x0F are handled separately.
+    static const std::uint8_t one_byte_opcodes[256] = {
+        //  0       1       2       3       4       5       6       7       8       9       A       B       C       D       E       F
+            M,      M,      M,      M,      I8,     IZ,     __,     __,     M,      M,      M,      M,      I8,     IZ,     __,     XX,     // 0
+            M,      M,      M,      M,      I8,     IZ,     __,     __,     M,      M,      M,      M,      I8,     IZ,     __,     __,     // 1
+            M,      M,      M,      M,      I8,     IZ,     XX,     __,     M,      M,      M,      M,      I8,     IZ,     XX,     __,     // 2
+            M,      M,      M,      M,      I8,     IZ,     XX,     __,     M,      M,      M,      M,      I8,     IZ,     XX,     __,     // 3
+            __,     __,     __,     __,     __,     __,     __,     __,     __,     __,     __,     __,     __,     __,     __,     __,     // 4
+            __,     __,     __,     __,     __,     __,     __,     __,     __,     __,     __,     __,     __,     __,     __,     __,     // 5
+            __,     __,     M,      M,      XX,     XX,     XX,     XX,     IZ,     M|IZ,   I8,     M|I8,   __,     __,     __,     __,     // 6
+            R8,     R8,     R8,     R8,     R8,     R8,     R8,     R8,     R8,     R8,     R8,     R8,     R8,     R8,     R8,     R8,     // 7
+            M|I8,   M|IZ,   M|I8,   M|I8,   M,      M,      M,      M,      M,      M,      M,      M,      M,      M,      M,      M,      // 8
+            __,     __,     __,     __,     __,     __,     __,     __,     __,     __,     IZ|IW,  __,     __,     __,     __,     __,     // 9
+            MO,     MO,     MO,     MO,     __,     __,     __,     __,     I8,     IZ,     __,     __,     __,     __,     __,     __,     // A
+            I8,     I8,     I8,     I8,     I8,     I8,     I8,     I8,     IZ,     IZ,     IZ,     IZ,     IZ,     IZ,     IZ,     IZ,     // B
+            M|I8,   M|I8,   IW,     __,     M,      M,      M|I8,   M|IZ,   IW|I8,  __,     IW,     __,     __,     I8,     __,     __,     // C
+            M,      M,      M,      M,      I8,     I8,     XX,     __,     M,      M,      M,      M,      M,      M,      M,      M,      // D
+            R8,     R8,     R8,     R8,     I8,     I8,     I8,     I8,     RZ,     RZ,     IZ|IW,  R8,     __,     __,     __,     __,     // E
+            XX,     __,     XX,     XX,     __,     __,     M,      M,      __,     __,     __,     __,     __,     __,     M,      M       // F
+    };
+
+    // Two-byte opcodes (0x0F xx). 0x0F 0x38 and 0x0F 0x3A are handled separately.
+    static const std::uint8_t two_byte_opcodes[256] = {
+        //  0       1       2       3       4       5       6       7       8       9       A       B       C       D       E       F
+            M,      M,      M,      M,      XX,     __,     __,     __,     __,     __,     XX,     __,     XX,     M,      __,     XX,     // 0
+            M,      M,      M,      M,      M,      M,      M,      M,      M,      M,      M,      M,      M,      M,      M,      M,      // 1
+            M,      M,      M,      M,      XX,     XX,     XX,     XX,     M,      M,      M,      M,      M,      M,      M,      M,      // 2
+            __,     __,     __,     __,     __,     __,     XX,     __,     XX,     XX,     XX,     XX,     XX,     XX,     XX,     XX,     // 3
+            M,      M,      M,      M,      M,      M,      M,      M,      M,      M,      M,      M,      M,      M,      M,      M,      // 4
+            M,      M,      M,      M,      M,      M,      M,      M,      M,      M,      M,      M,      M,      M,      M,      M,      // 5
+            M,      M,      M,      M,      M,      M,      M,      M,      M,      M,      M,      M,      M,      M,      M,      M,      // 6
+            M|I8,   M|I8,   M|I8,   M|I8,   M,      M,      M,      __,     M,      M,      XX,     XX,     M,      M,      M,      M,      // 7
+            RZ,     RZ,     RZ,     RZ,     RZ,     RZ,     RZ,     RZ,     RZ,     RZ,     RZ,     RZ,     RZ,     RZ,     RZ,     RZ,     // 8
+            M,      M,      M,      M,      M,      M,      M,      M,      M,      M,      M,      M,      M,      M,      M,      M,      // 9
+            __,     __,     __,     M,      M|I8,   M,      XX,     XX,     __,     __,     __,     M,      M|I8,   M,      M,      M,      // A
+            M,      M,      M,      M,      M,      M,      M,      M,      M,      M,      M|I8,   M,      M,      M,      M,      M,      // B
+            M,      M,      M|I8,   M,      M|I8,   M|I8,   M|I8,   M,      __,     __,     __,     __,     __,     __,     __,     __,     // C
+            M,      M,      M,      M,      M,      M,      M,      M,      M,      M,      M,      M,      M,      M,      M,      M,      // D
+            M,      M,      M,      M,      M,      M,      M,      M,      M,      M,      M,      M,      M,      M,      M,      M,      // E
+            M,      M,      M,      M,      M,      M,      M,      M,      M,      M,      M,      M,      M,      M,      M,      M       // F
+    };
+
+    // Get the length of the ModRM byte along with any SIB byte and displacement
+    static std::size_t modrm_length(const std::uint8_t *modrm, bool address_size_16) noexcept {
+        std::uint8_t mod = *modrm >> 6;
+        std::uint8_t rm = *modrm & 7;
+
+        // Register operand
+        if(mod == 3) {
+            return 1;
+        }
+
+        // 16-bit addressing has no SIB byte
+        if(address_size_16) {
+            if(mod == 0) {
+                return rm == 6 ? 3 : 1;
+            }
+            return mod == 1 ? 2 : 3;
+        }
+
+        std::size_t length = 1;
+
+        // SIB byte; a base of 5 without a displacement means disp32
+        if(rm == 4) {
+            length++;
+            if(mod == 0 && (modrm[1] & 7) == 5) {
+                length += 4;
+            }
+        }
+
+        // disp32 by itself
+        else if(mod == 0 && rm == 5) {
+            length += 4;
+        }
+
+        if(mod == 1) {
+            length += 1;
+        }
+        else if(mod == 2) {
+            length += 4;
+        }
+
+        return length;
+    }
+
+    bool decode_instruction(const std::byte *code, Instruction &instruction) noexcept {
+        instruction = {};
+        const auto *bytes = reinterpret_cast<const std::uint8_t *>(code);
+        std::size_t at = 0;
+        bool operand_size_16 = false;
+        bool address_size_16 = false;
+
+        // Go through the prefixes
+        for(bool prefix = true; prefix; ) {
+            switch(bytes[at]) {
+                case 0x66:
+                    operand_size_16 = true;
+                    at++;
+                    break;
+                case 0x67:
+                    address_size_16 = true;
+                    at++;
+                    break;
+                case 0xF0: case 0xF2: case 0xF3:
+                case 0x26: case 0x2E: case 0x36: case 0x3E: case 0x64: case 0x65:
+                    at++;
+                    break;
+                default:
+                    prefix = false;
+                    break;
+            }
+            if(at >= MAX_INSTRUCTION_LENGTH) {
+                return false;
+            }
+        }
+        instruction.prefix_count = at;
+
+        // Get the opcode
+        std::uint8_t opcode = bytes[at++];
+        std::uint8_t flags;
+        bool two_byte = opcode == 0x0F;
+        if(two_byte) {
+            opcode = bytes[at++];
+            if(opcode == 0x38) {
+                at++;
+                flags = M;
+            }
+            else if(opcode == 0x3A) {
+                at++;
+                flags = M | I8;
+            }
+            else {
+                flags = two_byte_opcodes[opcode];
+            }
+        }
+        else {
+            flags = one_byte_opcodes[opcode];
+
+            // test is the only F6/F7 instruction with an immediate
+            if((opcode == 0xF6 || opcode == 0xF7) && ((bytes[at] >> 3) & 7) < 2) {
+                flags |= opcode == 0xF6 ? I8 : IZ;
+            }
+        }
+
+        if(flags & XX) {
+            return false;
+        }
+
+        // mov to/from control and debug registers always uses registers, whatever the mod field says
+        if(two_byte && opcode >= 0x20 && opcode <= 0x23) {
+            at += 1;
+        }
+        else if(flags & M) {
+            at += modrm_length(bytes + at, address_size_16);
+        }
+
+        // An operand size prefix makes any relative branch truncate EIP to 16 bits, so there's no sense in supporting them
+        if(flags & (R8 | RZ)) {
+            if(operand_size_16) {
+                return false;
+            }
+            instruction.relative_offset = at;
+            instruction.relative_size = (flags & R8) ? 1 : 4;
+        }
+
+        // Add everything else after the ModRM
+        if(flags & MO) {
+            at += address_size_16 ? 2 : 4;
+        }
+        if(flags & (I8 | R8)) {
+            at += 1;
+        }
+        if(flags & IW) {
+            at += 2;
+        }
+        if(flags & (IZ | RZ)) {
+            at += operand_size_16 ? 2 : 4;
+        }
+
+        if(at > MAX_INSTRUCTION_LENGTH) {
+            return false;
+        }
+
+        instruction.length = at;
+        return true;
+    }
+
+    #undef M
+    #undef I8
+    #undef IW
+    #undef IZ
+    #undef R8
+    #undef RZ
+    #undef MO
+    #undef XX
+    #undef __
+
+    bool RelocatedInstructions::relocate(const std::byte *from, std::size_t minimum_size) {
+        this->original_size = 0;
+        this->code.clear();
+        this->p_branches.clear();
+
+        // Where each instruction started in the original code and where it starts in the relocated code
+        std::vector<std::pair<std::size_t, std::size_t>> instruction_offsets;
+
+        while(this->original_size < minimum_size) {
+            const auto *at = from + this->original_size;
+            Instruction instruction;
+            if(!decode_instruction(at, instruction)) {
+                return false;
+            }
+            instruction_offsets.emplace_back(this->original_size, this->code.size());
+
+            // Anything that doesn't branch relatively can be copied as-is
+            if(instruction.relative_size == 0) {
+                this->code.insert(this->code.end(), at, at + instruction.length);
+                this->original_size += instruction.length;
+                continue;
+            }
+
+            // Find where it's going
+            std::int32_t displacement;
+            if(instruction.relative_size == 1) {
+                displacement = static_cast<std::int8_t>(at[instruction.relative_offset]);
+            }
+            else {
+                std::memcpy(&displacement, at + instruction.relative_offset, sizeof(displacement));
+            }
+            const auto *target = at + instruction.length + displacement;
+
+            // Copy any prefixes
+            this->code.insert(this->code.end(), at, at + instruction.prefix_count);
+
+            // 32-bit branches can stay as they are
+            auto opcode = static_cast<std::uint8_t>(at[instruction.prefix_count]);
+            if(instruction.relative_size == 4) {
+                this->code.insert(this->code.end(), at + instruction.prefix_count, at + instruction.relative_offset);
+            }
+
+            // jmp short -> jmp
+            else if(opcode == 0xEB) {
+                this->code.push_back(static_cast<std::byte>(0xE9));
+            }
+
+            // jcc short -> jcc
+            else if(opcode >= 0x70 && opcode <= 0x7F) {
+                this->code.push_back(static_cast<std::byte>(0x0F));
+                this->code.push_back(static_cast<std::byte>(0x80 + (opcode - 0x70)));
+            }
+
+            // loop/loope/loopne/jecxz have no 32-bit form, so branch over a jmp to get there
+            else {
+                this->code.push_back(static_cast<std::byte>(opcode));
+                this->code.push_back(static_cast<std::byte>(0x02));
+                this->code.push_back(static_cast<std::byte>(0xEB));
+                this->code.push_back(static_cast<std::byte>(0x05));
+                this->code.push_back(static_cast<std::byte>(0xE9));
+            }
+
+            this->p_branches.push_back({this->code.size(), target, 0, false});
+            this->code.insert(this->code.end(), 4, std::byte());
+            this->original_size += instruction.length;
+        }
+
+        // Anything branching into the relocated code has to branch into the new copy since the original will be overwritten
+        for(auto &branch : this->p_branches) {
+            if(branch.target < from || branch.target >= from + this->original_size) {
+                continue;
+            }
+            for(auto &offset : instruction_offsets) {
+                if(from + offset.first == branch.target) {
+                    branch.internal = true;
+                    branch.internal_target = offset.second;
+                    break;
+                }
+            }
+
+            // Branching into the middle of an instruction? No thanks.
+            if(!branch.internal) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    void RelocatedInstructions::write(std::byte *to) const noexcept {
+        std::copy(this->code.begin(), this->code.end(), to);
+        for(auto &branch : this->p_branches) {
+            auto target = reinterpret_cast<std::uintptr_t>(branch.internal ? to + branch.internal_target : branch.target);
+            auto displacement = static_cast<std::uint32_t>(target - reinterpret_cast<std::uintptr_t>(to + branch.offset + 4));
+            std::memcpy(to + branch.offset, &displacement, sizeof(displacement));
+        }
+    }
+}
@@ -0,0 +1,82 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#ifndef CHIMERA_INSTRUCTION_HPP
+#define CHIMERA_INSTRUCTION_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Chimera {
+    /**
+     * A decoded IA-32 instruction
+     */
+    struct Instruction {
+        /** Total length of the instruction, including prefixes */
+        std::size_t length = 0;
+
+        /** Number of prefix bytes */
+        std::size_t prefix_count = 0;
+
+        /** Offset of the relative branch displacement, or 0 if the instruction does not branch relatively */
+        std::size_t relative_offset = 0;
+
+        /** Size of the relative branch displacement (1 or 4), or 0 if the instruction does not branch relatively */
+        std::size_t relative_size = 0;
+    };
+
+    /**
+     * Decode the length of the 32-bit x86 instruction at the given address.
+     * @param  code        pointer to the instruction
+     * @param  instruction instruction to write to
+     * @return             true if the instruction was decoded, false if it is invalid or unsupported
+     */
+    bool decode_instruction(const std::byte *code, Instruction &instruction) noexcept;
+
+    /**
+     * Whole instructions copied from one place so they can be run from another
+     */
+    class RelocatedInstructions {
+    public:
+        /** Number of bytes of original code that were relocated */
+        std::size_t original_size = 0;
+
+        /** Relocated code. Relative branches are filled in by write(). */
+        std::vector<std::byte> code;
+
+        /**
+         * Write the code to the given address, pointing any relative branches to where they originally went
+         * @param to address to write to; this must have at least code.size() bytes
+         */
+        void write(std::byte *to) const noexcept;
+
+        /**
+         * Relocate whole instructions starting at the given address until at least minimum_size bytes are covered. Short branches are
+         * widened to 32-bit branches since they may no longer reach their target.
+         * @param  from         pointer to the first instruction
+         * @param  minimum_size minimum number of bytes to relocate
+         * @return              true on success, false if an instruction could not be decoded or relocated
+         */
+        bool relocate(const std::byte *from, std::size_t minimum_size);
+
+    private:
+        struct Branch {
+            /** Offset of the 32-bit displacement in code */
+            std::size_t offset;
+
+            /** Address the branch originally went to */
+            const std::byte *target;
+
+            /** If the target was inside the relocated code, this is its offset in code */
+            std::size_t internal_target;
+
+            /** Whether or not the target was inside the relocated code */
+            bool internal;
+        };
+
+        /** Branches that need their displacement filled in */
+        std::vector<Branch> p_branches;
+    };
+}
+
+#endif
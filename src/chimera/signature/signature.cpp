@@ -1,12 +1,87 @@
 // SPDX-License-Identifier: GPL-3.0-only
 
+#include <algorithm>
 #include <cstring>
+#include <map>
 #include "signature.hpp"
 #include "hac/codefinder.h"
 #include "../chimera.hpp"
 #include "hook.hpp"
 
 namespace Chimera {
+    // Copy of Halo's code from before anything was modified so signatures can still be searched for while startup hooks are written
+    static std::vector<BYTE> code_snapshot;
+
+    // Halo's code section
+    static const BYTE *code_start = nullptr;
+    static std::size_t code_size = 0;
+
+    // Original value of every byte in Halo's code that was modified since the snapshot was freed, keyed by address
+    static std::map<const BYTE *, BYTE> original_code;
+
+    // Number of signatures not searched for yet; the snapshot is freed early if this hits 0
+    static std::size_t unsearched_signatures = 0;
+
+    // Get what the byte at the address was before Chimera modified anything
+    static BYTE original_code_byte(const BYTE *address) noexcept {
+        auto original = original_code.find(address);
+        return original == original_code.end() ? *address : original->second;
+    }
+
+    // Check if the signature matches Halo's original code at the address
+    static bool matches_original_code(const BYTE *address, const SigByte *signature, std::size_t length) noexcept {
+        for(std::size_t i = 0; i < length; i++) {
+            if(signature[i] != -1 && signature[i] != original_code_byte(address + i)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Find the first place in Halo's original code that matches the signature without using the snapshot. Anything that matches in the
+    // live code and doesn't touch a modified byte matched before it was modified, too. Anything else has to overlap a modified byte, so
+    // only the code around those needs to be checked against the original bytes.
+    static const BYTE *find_in_original_code(const SigByte *signature, std::size_t length) noexcept {
+        if(length == 0 || length > code_size) {
+            return nullptr;
+        }
+
+        const BYTE *found = nullptr;
+        const BYTE *last_start = code_start + code_size - length;
+
+        for(auto location : CodeFinder(GetModuleHandle(nullptr), signature, length).find()) {
+            auto *address = reinterpret_cast<const BYTE *>(location);
+            auto modified = original_code.lower_bound(address);
+            if(modified == original_code.end() || modified->first >= address + length) {
+                found = address;
+                break;
+            }
+        }
+
+        for(auto &[modified_address, original] : original_code) {
+            auto *first = modified_address - std::min<std::size_t>(length - 1, modified_address - code_start);
+            auto *last = std::min(modified_address, last_start);
+            if(found && first >= found) {
+                break;
+            }
+            for(auto *address = first; address <= last && (!found || address < found); address++) {
+                if(matches_original_code(address, signature, length)) {
+                    found = address;
+                    break;
+                }
+            }
+        }
+
+        return found;
+    }
+
+    // Signatures for these features are needed to determine if Chimera can load at all, so they're searched for immediately
+    static const char *eager_features[] = {
+        "core", "core_full", "core_retail", "core_custom_edition", "core_demo",
+        "client", "client_full", "client_retail", "client_custom_edition", "client_demo",
+        "server", "server_retail", "server_custom"
+    };
+
     const char *Signature::name() const noexcept {
         return this->p_name.data();
     }
@@ -14,24 +89,59 @@ namespace Chimera {
         return this->p_feature.data();
     }
     const std::byte *Signature::original_data() const noexcept {
+        this->find();
         return this->p_original_data.data();
     }
     std::size_t Signature::original_data_size() const noexcept {
+        this->find();
         return this->p_original_data.size();
     }
     std::byte *Signature::data() const noexcept {
+        this->find();
         return this->p_data;
     }
+    bool Signature::searched() const noexcept {
+        return this->p_searched;
+    }
+
+    void Signature::find() const noexcept {
+        if(this->p_searched) {
+            return;
+        }
+        this->p_searched = true;
+
+        // Search the snapshot so we get the original bytes even if something else has since been hooked nearby. Once that's gone, search
+        // the live code and see through anything that was modified.
+        const BYTE *found;
+        if(code_snapshot.size() > 0) {
+            found = reinterpret_cast<const BYTE *>(FindCode(GetModuleHandle(nullptr), code_snapshot.data(), this->p_signature.data(), this->p_signature.size()));
+        }
+        else {
+            found = find_in_original_code(this->p_signature.data(), this->p_signature.size());
+        }
+        this->p_data = reinterpret_cast<std::byte *>(const_cast<BYTE *>(found));
+
+        if(found) {
+            for(std::size_t i = 0; i < this->p_signature.size(); i++) {
+                auto offset = found + i - code_start;
+                auto original = code_snapshot.size() > 0 ? code_snapshot[offset] : original_code_byte(found + i);
+                this->p_original_data.push_back(static_cast<std::byte>(original));
+            }
+        }
+
+        // We don't need the pattern anymore
+        this->p_signature = std::vector<SigByte>();
+        if(--unsearched_signatures == 0) {
+            free_code_snapshot();
+        }
+    }
 
     void Signature::rollback() const noexcept {
         overwrite(this->data(), this->original_data(), this->original_data_size());
     }
 
-    Signature::Signature(const char *name, const char *feature, const SigByte *signature, std::size_t length) : p_name(name), p_feature(feature) {
-        this->p_data = reinterpret_cast<std::byte *>(FindCode(GetModuleHandle(nullptr), signature, length));
-        if(this->p_data) {
-            this->p_original_data.insert(this->p_original_data.begin(), this->p_data, this->p_data + length);
-        }
+    Signature::Signature(const char *name, const char *feature, const SigByte *signature, std::size_t length) : p_name(name), p_feature(feature), p_signature(signature, signature + length) {
+        unsearched_signatures++;
     }
 
     #define FIND(name, feature, ...) {\
@@ -41,6 +151,8 @@ namespace Chimera {
 
     std::vector<Signature> find_all_signatures() {
         std::vector<Signature> signatures;
+        code_snapshot = CopyCodeSection(GetModuleHandle(nullptr), &code_start);
+        code_size = code_snapshot.size();
 
         // Core
         FIND("tick_progress_sig", "client", { 0xA1, -1, -1, -1, -1, 0x8A, 0x48, 0x02, 0x84, 0xC9 });
@@ -484,6 +596,45 @@ namespace Chimera {
 
         FIND("load_main_menu_demo_sig", "client_demo", { 0x80, 0x3D, -1, -1, -1, -1, 0x01, 0xC6, 0x05, -1, -1, -1, -1, 0x00, 0x75, 0x21, 0xA1 });
 
+        // Search for what we need now; everything else can wait until it's used
+        for(auto &signature : signatures) {
+            for(auto *feature : eager_features) {
+                if(std::strcmp(signature.feature(), feature) == 0) {
+                    signature.find();
+                    break;
+                }
+            }
+        }
+
         return signatures;
     }
+
+    void free_code_snapshot() noexcept {
+        if(code_snapshot.size() == 0) {
+            return;
+        }
+
+        // Remember everything that was modified while we had the snapshot
+        for(std::size_t i = 0; i < code_size; i++) {
+            if(code_start[i] != code_snapshot[i]) {
+                original_code.emplace(code_start + i, code_snapshot[i]);
+            }
+        }
+
+        code_snapshot = std::vector<BYTE>();
+    }
+
+    void remember_original_code(const void *pointer, std::size_t length) noexcept {
+        // While we have the snapshot, it has the original code
+        if(code_snapshot.size() > 0) {
+            return;
+        }
+
+        // Only Halo's code matters, and only the first time each byte is modified
+        auto *start = std::max(reinterpret_cast<const BYTE *>(pointer), code_start);
+        auto *end = std::min(reinterpret_cast<const BYTE *>(pointer) + length, code_start + code_size);
+        for(auto *address = start; address < end; address++) {
+            original_code.emplace(address, *address);
+        }
+    }
 }
@@ -25,6 +25,17 @@ namespace Chimera {
          */
         const char *feature() const noexcept;
 
+        /**
+         * Check if the signature has been searched for yet
+         * @return true if the signature has been searched for
+         */
+        bool searched() const noexcept;
+
+        /**
+         * Search for the signature if it has not been searched for yet. This is done automatically when the data is first accessed.
+         */
+        void find() const noexcept;
+
         /**
          * Get the original data retrieved when the signature was found or nullptr
          * @return original data
@@ -63,18 +74,39 @@ namespace Chimera {
         /** Feature of the signature */
         std::string p_feature;
 
+        /** Byte signature to search for */
+        mutable std::vector<SigByte> p_signature;
+
         /** Original bytes of the signature */
-        std::vector<std::byte> p_original_data;
+        mutable std::vector<std::byte> p_original_data;
 
         /** Pointer to where the signature is */
-        std::byte *p_data = nullptr;
+        mutable std::byte *p_data = nullptr;
+
+        /** Whether or not the signature has been searched for */
+        mutable bool p_searched = false;
     };
 
     /**
-     * Find all signatures
+     * Declare all signatures. Only core, client, and server signatures are searched for immediately; everything else is searched for when its
+     * feature is first checked or when the signature is first used.
      * @return vector of all signatures
      */
     std::vector<Signature> find_all_signatures();
+
+    /**
+     * Free the copy of Halo's code that signatures are searched in. This should be done once startup hooking is done. Signatures searched
+     * for after this are searched for in the live code, using the original bytes of anything that was modified since.
+     */
+    void free_code_snapshot() noexcept;
+
+    /**
+     * Remember the original bytes of Halo's code before they are overwritten so signatures can still be found afterward. This must be
+     * called before anything in Halo's code is modified. Anything outside of Halo's code is ignored.
+     * @param pointer pointer to the data about to be overwritten
+     * @param length  length of the data
+     */
+    void remember_original_code(const void *pointer, std::size_t length) noexcept;
 }
 
 
@@ -0,0 +1,131 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include <chrono>
+#include <cmath>
+#include "../miscellaneous/frame_pacer.hpp"
+#include "test.hpp"
+
+using namespace Chimera;
+using namespace std::chrono_literals;
+
+typedef FramePacer::clock Clock;
+
+// Some arbitrary time to start at, since nothing should depend on what time it is
+static const Clock::time_point START = Clock::time_point(1h);
+
+static bool near(double a, double b) {
+    return std::fabs(a - b) < 1e-9;
+}
+
+// Sleeping stops short of the frame by the spin time plus however late sleeping has been waking up, so spinning covers the rest
+static void test_sleep_duration() {
+    FramePacer pacer;
+    pacer.start(10ms, START);
+
+    // The first frame is due right away
+    CHECK(pacer.sleep_duration(START) == Clock::duration::zero());
+    pacer.frame_started(START);
+    CHECK(pacer.next_frame() == START + 10ms);
+
+    // Sleep until 250 us before the next frame...
+    CHECK(pacer.sleep_duration(START) == 9750us);
+    CHECK(pacer.sleep_duration(START + 4ms) == 5750us);
+
+    // ...and then spin
+    CHECK(pacer.sleep_duration(START + 9750us) == Clock::duration::zero());
+    CHECK(pacer.sleep_duration(START + 9900us) == Clock::duration::zero());
+
+    // Once sleeping is known to wake up late, sleep that much less
+    pacer.record_sleep(5ms, 6ms);
+    CHECK(pacer.sleep_duration(START) == 8750us);
+    CHECK(pacer.sleep_duration(START + 8800us) == Clock::duration::zero());
+
+    // Waking up early doesn't count as a negative overshoot
+    FramePacer early;
+    early.start(10ms, START);
+    early.frame_started(START);
+    early.record_sleep(5ms, 4ms);
+    CHECK(early.sleep_duration(START) == 9750us);
+}
+
+// A worse overshoot is taken right away, a better one only takes 1/16 of the difference each time, and it never goes past half a frame
+static void test_sleep_overshoot() {
+    FramePacer pacer;
+    pacer.start(10ms, START);
+    pacer.frame_started(START);
+    auto sleep_without_overshoot = pacer.sleep_duration(START);
+    auto overshoot = [&]() {
+        return sleep_without_overshoot - pacer.sleep_duration(START);
+    };
+
+    pacer.record_sleep(1ms, 4ms);
+    CHECK(overshoot() == 3ms);
+
+    pacer.record_sleep(1ms, 1ms);
+    CHECK(overshoot() == 3ms - Clock::duration(3ms) / 16);
+
+    pacer.record_sleep(1ms, 1ms);
+    CHECK(overshoot() == 2812500ns - Clock::duration(2812500ns) / 16);
+
+    pacer.record_sleep(1ms, 5ms);
+    CHECK(overshoot() == 4ms);
+
+    // Decaying towards an overshoot that isn't zero
+    pacer.record_sleep(1ms, 3ms);
+    CHECK(overshoot() == 4ms - Clock::duration(2ms) / 16);
+
+    // A huge stall is capped to half the interval
+    pacer.record_sleep(1ms, 100ms);
+    CHECK(overshoot() == 5ms);
+}
+
+// Statistics are published once the window is over
+static void test_statistics() {
+    FramePacer pacer;
+    pacer.start(100ms, START);
+
+    // Frames 100, 100, 102, 98, and 100 ms apart, with the one at 302 ms being late
+    pacer.frame_started(START);
+    pacer.frame_started(START + 100ms);
+    pacer.frame_started(START + 200ms);
+    pacer.frame_started(START + 302ms);
+    pacer.frame_started(START + 400ms);
+    CHECK(pacer.statistics().frames == 0);
+    pacer.frame_started(START + 500ms);
+
+    // Mean is 500 / 5 = 100, the variance is (0 + 0 + 4 + 4 + 0) / 5 = 1.6, and the furthest from the interval was 2 ms
+    auto &statistics = pacer.statistics();
+    CHECK(statistics.frames == 5);
+    CHECK(statistics.late_frames == 1);
+    CHECK(near(statistics.mean_ms, 100.0));
+    CHECK(near(statistics.jitter_ms, std::sqrt(1.6)));
+    CHECK(near(statistics.max_deviation_ms, 2.0));
+
+    // Frames that are just within the spin time aren't late, and falling more than a frame behind skips ahead
+    pacer.frame_started(START + 600ms + 200us);
+    CHECK(pacer.next_frame() == START + 700ms);
+    pacer.frame_started(START + 810ms);
+    CHECK(pacer.next_frame() == START + 900ms);
+    pacer.frame_started(START + 900ms);
+    CHECK(statistics.frames == 5);
+    pacer.frame_started(START + 1000ms);
+
+    // Frames 100.2, 209.8, 90, and 100 ms apart: mean 500 / 4 = 125, variance (24.8^2 + 84.8^2 + 35^2 + 25^2) / 4 = 2414.02
+    CHECK(statistics.frames == 4);
+    CHECK(statistics.late_frames == 1);
+    CHECK(near(statistics.mean_ms, 125.0));
+    CHECK(std::fabs(statistics.jitter_ms - std::sqrt(2414.02)) < 1e-6);
+    CHECK(std::fabs(statistics.max_deviation_ms - 109.8) < 1e-9);
+
+    // Starting over clears them
+    pacer.start(100ms, START + 2s);
+    CHECK(pacer.statistics().frames == 0);
+    CHECK(pacer.next_frame() == START + 2s);
+}
+
+int main() {
+    test_sleep_duration();
+    test_sleep_overshoot();
+    test_statistics();
+    return test_result();
+}
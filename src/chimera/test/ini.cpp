@@ -0,0 +1,154 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+#include <string>
+#include "../config/ini.hpp"
+#include "test.hpp"
+
+using namespace Chimera;
+
+namespace Chimera {
+    void ini_invalid_value(const char *key, const char *value, const char *expected) noexcept {
+        std::fprintf(stderr, "%s (=> %s) is not %s\n", key, value, expected);
+        std::abort();
+    }
+}
+
+static bool load(Ini &ini, const std::string &data, IniError &error) {
+    std::istringstream stream(data);
+    return ini.load(stream, error);
+}
+
+static bool value_is(const Ini &ini, const char *key, const char *value) {
+    auto *v = ini.get_value(key);
+    return v && std::strcmp(v, value) == 0;
+}
+
+static void test_parse() {
+    Ini ini;
+    IniError error;
+    CHECK(load(ini,
+        "; comment\n"
+        "no_group=1\n"
+        "\n"
+        "   \t\n"
+        "[halo]\n"
+        "path=C:\\Games\\Halo\n"
+        "client_port=2303\r\n"
+        "empty=\r\n"
+        "equals=a=b\n"
+        "[memory]\r"
+        "map_size=512\n"
+        "client_port=1\n"
+        "[halo]\n"
+        "client_port=2304\n"
+        "exec=init.txt", error));
+
+    CHECK(value_is(ini, "no_group", "1"));
+    CHECK(value_is(ini, "halo.path", "C:\\Games\\Halo"));
+    CHECK(value_is(ini, "halo.empty", ""));
+    CHECK(value_is(ini, "halo.equals", "a=b"));
+    CHECK(value_is(ini, "memory.map_size", "512"));
+    CHECK(value_is(ini, "memory.client_port", "1"));
+    CHECK(value_is(ini, "halo.exec", "init.txt"));
+
+    // The last one in the file wins
+    CHECK(value_is(ini, "halo.client_port", "2304"));
+
+    // Keys are the whole thing
+    CHECK(ini.get_value("halo") == nullptr);
+    CHECK(ini.get_value("client_port") == nullptr);
+    CHECK(ini.get_value("halo.client_por") == nullptr);
+    CHECK(ini.get_value("halo.client_port2") == nullptr);
+    CHECK(ini.get_value("memory") == nullptr);
+    CHECK(ini.get_value("") == nullptr);
+}
+
+static void test_types() {
+    Ini ini;
+    IniError error;
+    CHECK(load(ini, "[t]\nyes=1\ntrue=true\nno=0\nfloat=1.5\nlong=-42\nsize=18446744073709551615\n", error));
+
+    CHECK(ini.get_value_bool("t.yes") == true);
+    CHECK(ini.get_value_bool("t.true") == true);
+    CHECK(ini.get_value_bool("t.no") == false);
+    CHECK(!ini.get_value_bool("t.missing").has_value());
+    CHECK(ini.get_value_float("t.float") == 1.5);
+    CHECK(ini.get_value_long("t.long") == -42);
+    CHECK(ini.get_value_size("t.size") == 18446744073709551615ULL);
+
+    // Asking again gives the same thing (these are cached after the first time)
+    CHECK(ini.get_value_long("t.long") == -42);
+    CHECK(ini.get_value_float("t.float") == 1.5);
+}
+
+static void test_set_delete() {
+    Ini ini;
+    IniError error;
+    CHECK(load(ini, "[a]\nb=1\n", error));
+
+    ini.set_value("a.b", "2");
+    CHECK(value_is(ini, "a.b", "2"));
+    CHECK(ini.get_value_long("a.b") == 2);
+
+    ini.set_value({"c.d", "3"});
+    CHECK(value_is(ini, "c.d", "3"));
+
+    ini.delete_value("a.b");
+    CHECK(ini.get_value("a.b") == nullptr);
+    CHECK(!ini.get_value_long("a.b").has_value());
+
+    ini.set_value("a.b", "4");
+    CHECK(ini.get_value_long("a.b") == 4);
+
+    // Setting a lot of values has to grow the table without losing anything
+    for(int i = 0; i < 1000; i++) {
+        ini.set_value(("many." + std::to_string(i)).c_str(), std::to_string(i * 2).c_str());
+    }
+    bool all_found = true;
+    for(int i = 0; i < 1000; i++) {
+        all_found = all_found && ini.get_value_long(("many." + std::to_string(i)).c_str()) == i * 2;
+    }
+    CHECK(all_found);
+    CHECK(value_is(ini, "c.d", "3"));
+}
+
+static void test_errors() {
+    // Lines that aren't a group, a key, or a comment can't be parsed
+    Ini ini;
+    IniError error;
+    CHECK(!load(ini, "[a]\nb=1\n\nthis is not valid\nc=2\n", error));
+    CHECK(error.line_number == 4);
+    CHECK(error.line == "this is not valid");
+    CHECK(ini.get_value("a.b") == nullptr);
+
+    // An unterminated group isn't a group
+    CHECK(!load(ini, "a=1\r\n[group\r\n", error));
+    CHECK(error.line_number == 2);
+    CHECK(error.line == "[group");
+
+    // Loading again replaces everything
+    CHECK(load(ini, "x=1\n", error));
+    CHECK(value_is(ini, "x", "1"));
+    CHECK(load(ini, "y=1\n", error));
+    CHECK(ini.get_value("x") == nullptr);
+    CHECK(value_is(ini, "y", "1"));
+
+    // Nothing to load
+    CHECK(!ini.load("this file does not exist.ini", error));
+    CHECK(error.line_number == 0);
+
+    // Empty is fine
+    CHECK(load(ini, "", error));
+    CHECK(ini.get_value("y") == nullptr);
+}
+
+int main() {
+    test_parse();
+    test_types();
+    test_set_delete();
+    test_errors();
+    return test_result();
+}
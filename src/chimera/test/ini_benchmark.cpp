@@ -0,0 +1,71 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "../config/ini.hpp"
+
+using namespace Chimera;
+
+namespace Chimera {
+    void ini_invalid_value(const char *key, const char *value, const char *expected) noexcept {
+        std::fprintf(stderr, "%s (=> %s) is not %s\n", key, value, expected);
+        std::abort();
+    }
+}
+
+// Parse a generated ini with the given number of keys (spread across groups of 32) and look every key up a few times
+int main(int argc, const char **argv) {
+    if(argc > 3) {
+        std::printf("Usage: %s [key count] [iterations]\n", argv[0]);
+        return 1;
+    }
+    std::size_t key_count = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 1000;
+    std::size_t iterations = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 100;
+
+    std::string data = "; generated\n";
+    std::vector<std::string> keys;
+    for(std::size_t i = 0; i < key_count; i++) {
+        std::string group = "group_" + std::to_string(i / 32);
+        std::string key = "some_setting_" + std::to_string(i);
+        if(i % 32 == 0) {
+            data += "\n[" + group + "]\n";
+        }
+        data += key + "=" + std::to_string(i) + "\n";
+        keys.emplace_back(group + "." + key);
+    }
+
+    using clock = std::chrono::steady_clock;
+    double parse_seconds = 0.0, lookup_seconds = 0.0;
+    std::size_t checksum = 0;
+    for(std::size_t i = 0; i < iterations; i++) {
+        std::istringstream stream(data);
+        Ini ini;
+        IniError error;
+
+        auto start = clock::now();
+        if(!ini.load(stream, error)) {
+            std::fprintf(stderr, "Failed to parse line %zu: %s\n", error.line_number, error.line.c_str());
+            return 1;
+        }
+        auto parsed = clock::now();
+        for(int repeat = 0; repeat < 4; repeat++) {
+            for(auto &key : keys) {
+                checksum += static_cast<std::size_t>(ini.get_value_long(key.c_str()).value_or(0));
+            }
+        }
+        auto looked_up = clock::now();
+
+        parse_seconds += std::chrono::duration<double>(parsed - start).count();
+        lookup_seconds += std::chrono::duration<double>(looked_up - parsed).count();
+    }
+
+    std::printf("%zu keys, %zu bytes, %zu iterations\n", key_count, data.size(), iterations);
+    std::printf("parse:  %10.3f us per file, %7.1f MiB/s\n", parse_seconds / iterations * 1e6, data.size() * iterations / parse_seconds / 1024.0 / 1024.0);
+    std::printf("lookup: %10.3f ns per lookup\n", lookup_seconds / (iterations * key_count * 4) * 1e9);
+    std::printf("checksum: %zu\n", checksum);
+    return 0;
+}
@@ -0,0 +1,239 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "../signature/instruction.hpp"
+#include "test.hpp"
+
+using namespace Chimera;
+
+// Each corpus instruction is copied here with NOPs after it so reading too far gives the wrong length instead of garbage
+#define BUFFER_SIZE 32
+
+static std::vector<std::byte> from_hex(const std::string &hex) {
+    std::vector<std::byte> bytes;
+    for(std::size_t i = 0; i + 1 < hex.size(); i += 2) {
+        bytes.push_back(static_cast<std::byte>(std::stoul(hex.substr(i, 2), nullptr, 16)));
+    }
+    return bytes;
+}
+
+static std::int32_t read_displacement(const std::byte *at) {
+    std::int32_t displacement;
+    std::memcpy(&displacement, at, sizeof(displacement));
+    return displacement;
+}
+
+// Everything in the corpus that we decode has to be the length objdump says it is. If objdump couldn't decode it, it isn't a real
+// instruction, so it doesn't matter what we do with it as long as we don't crash.
+static void test_corpus(const char *path) {
+    std::ifstream corpus(path);
+    CHECK(corpus.is_open());
+
+    std::size_t total = 0, decoded = 0;
+    std::string line;
+    while(std::getline(corpus, line)) {
+        if(line.empty() || line[0] == '#') {
+            continue;
+        }
+
+        std::istringstream fields(line);
+        std::string hex;
+        std::size_t length, relative_offset, relative_size;
+        fields >> hex >> length >> relative_offset >> relative_size;
+        total++;
+
+        std::byte buffer[BUFFER_SIZE];
+        std::fill(buffer, buffer + BUFFER_SIZE, static_cast<std::byte>(0x90));
+        auto bytes = from_hex(hex);
+        std::copy(bytes.begin(), bytes.end(), buffer);
+
+        Instruction instruction;
+        if(!decode_instruction(buffer, instruction) || length == 0) {
+            continue;
+        }
+        decoded++;
+
+        bool correct = instruction.length == length && instruction.relative_offset == relative_offset && instruction.relative_size == relative_size;
+        if(!correct) {
+            std::fprintf(stderr, "%s: decoded as %zu %zu %zu\n", line.c_str(), instruction.length, instruction.relative_offset, instruction.relative_size);
+        }
+        CHECK(correct);
+    }
+
+    std::printf("Decoded %zu / %zu corpus instructions\n", decoded, total);
+    CHECK(total > 0);
+}
+
+// Things that have to decode to exactly this
+static void test_decode() {
+    struct Expected {
+        std::vector<std::byte> bytes;
+        std::size_t length;
+        std::size_t prefix_count;
+    };
+
+    auto b = from_hex;
+    const Expected expected[] = {
+        { b("55"), 1, 0 },                              // push ebp
+        { b("8BEC"), 2, 0 },                            // mov ebp, esp
+        { b("83EC10"), 3, 0 },                          // sub esp, 0x10
+        { b("8B442404"), 4, 0 },                        // mov eax, [esp+4]
+        { b("8B0424"), 3, 0 },                          // mov eax, [esp]
+        { b("8B042500000000"), 7, 0 },                  // mov eax, [disp32] (SIB, no base)
+        { b("8B0500000000"), 6, 0 },                    // mov eax, [disp32]
+        { b("8B8000000000"), 6, 0 },                    // mov eax, [eax+disp32]
+        { b("C7050000000001000000"), 10, 0 },           // mov dword [disp32], 1
+        { b("66C705000000000100"), 9, 1 },              // mov word [disp32], 1
+        { b("678B06"), 5, 1 },                          // mov eax, [disp16]
+        { b("678B4010"), 4, 1 },                        // mov eax, [bx+si+0x10]
+        { b("66A10000"), 6, 1 },                        // mov ax, [moffs32]
+        { b("67A10000"), 4, 1 },                        // mov eax, [moffs16]
+        { b("F60501000000FF"), 7, 0 },                  // test byte [disp32], 0xFF
+        { b("F71501000000"), 6, 0 },                    // not dword [disp32]
+        { b("F3A5"), 2, 1 },                            // rep movsd
+        { b("F00FB10A"), 4, 1 },                        // lock cmpxchg [edx], ecx
+        { b("0F20C0"), 3, 0 },                          // mov eax, cr0
+        { b("0F2000"), 3, 0 },                          // mov eax, cr0 (mod is ignored)
+        { b("0F2105"), 3, 0 },                          // mov ebp, dr0 (not disp32)
+        { b("0F2284"), 3, 0 },                          // mov cr0, esp (not SIB + disp32)
+        { b("0F2345"), 3, 0 },                          // mov dr0, ebp (not disp8)
+        { b("0F3800C1"), 4, 0 },                        // pshufb mm0, mm1
+        { b("660F3A0FC108"), 6, 1 },                    // palignr xmm0, xmm1, 8
+    };
+
+    for(auto &e : expected) {
+        Instruction instruction;
+        std::byte buffer[BUFFER_SIZE];
+        std::fill(buffer, buffer + BUFFER_SIZE, static_cast<std::byte>(0x90));
+        std::copy(e.bytes.begin(), e.bytes.end(), buffer);
+        CHECK(decode_instruction(buffer, instruction));
+        CHECK(instruction.length == e.length);
+        CHECK(instruction.prefix_count == e.prefix_count);
+    }
+}
+
+// Relative branches with an operand size prefix truncate EIP, and things we don't know can't be relocated
+static void test_reject() {
+    auto b = from_hex;
+    const std::vector<std::byte> rejected[] = {
+        b("66EB00"),                                    // jmp short (16-bit)
+        b("667400"),                                    // je short (16-bit)
+        b("66E200"),                                    // loop (16-bit)
+        b("66E30000"),                                  // jcxz (16-bit)
+        b("66E80000"),                                  // call rel16
+        b("66E90000"),                                  // jmp rel16
+        b("660F840000"),                                // je rel16
+        b("0F04"),                                      // nothing
+        b("0F0A"),                                      // nothing
+        b("D6"),                                        // salc
+    };
+
+    for(auto &bytes : rejected) {
+        std::byte buffer[BUFFER_SIZE] = {};
+        std::copy(bytes.begin(), bytes.end(), buffer);
+        Instruction instruction;
+        CHECK(!decode_instruction(buffer, instruction));
+    }
+
+    // 15 prefixes is too many
+    std::byte prefixes[BUFFER_SIZE];
+    std::fill(prefixes, prefixes + BUFFER_SIZE, static_cast<std::byte>(0x2E));
+    Instruction instruction;
+    CHECK(!decode_instruction(prefixes, instruction));
+}
+
+// Relocated branches have to end up going where they went before
+static void test_relocate() {
+    // Code lives somewhere in here and gets relocated further along
+    std::vector<std::byte> memory(0x1000, static_cast<std::byte>(0xCC));
+    auto *original = memory.data() + 0x100;
+    auto *relocated = memory.data() + 0x800;
+
+    auto place = [&](const char *hex) {
+        auto bytes = from_hex(hex);
+        std::fill(original, original + 0x100, static_cast<std::byte>(0x90));
+        std::copy(bytes.begin(), bytes.end(), original);
+    };
+
+    // jmp short +0x10 -> jmp rel32
+    place("EB10");
+    RelocatedInstructions r;
+    CHECK(r.relocate(original, 1));
+    CHECK(r.original_size == 2);
+    r.write(relocated);
+    CHECK(r.code.size() == 5);
+    CHECK(relocated[0] == static_cast<std::byte>(0xE9));
+    CHECK(relocated + 5 + read_displacement(relocated + 1) == original + 2 + 0x10);
+
+    // jne short -0x20 -> jne rel32, with a branch hint prefix kept
+    place("3E75E0");
+    CHECK(r.relocate(original, 1));
+    CHECK(r.original_size == 3);
+    r.write(relocated);
+    CHECK(r.code.size() == 7);
+    CHECK(relocated[0] == static_cast<std::byte>(0x3E));
+    CHECK(relocated[1] == static_cast<std::byte>(0x0F));
+    CHECK(relocated[2] == static_cast<std::byte>(0x85));
+    CHECK(relocated + 7 + read_displacement(relocated + 3) == original + 3 - 0x20);
+
+    // loop +0x30 -> loop over a jmp short to a jmp rel32
+    place("E230");
+    CHECK(r.relocate(original, 1));
+    r.write(relocated);
+    CHECK(r.code.size() == 9);
+    CHECK(relocated[0] == static_cast<std::byte>(0xE2));
+    CHECK(relocated[1] == static_cast<std::byte>(0x02));
+    CHECK(relocated[2] == static_cast<std::byte>(0xEB));
+    CHECK(relocated[3] == static_cast<std::byte>(0x05));
+    CHECK(relocated[4] == static_cast<std::byte>(0xE9));
+    CHECK(relocated + 9 + read_displacement(relocated + 5) == original + 2 + 0x30);
+
+    // call rel32 stays a call rel32 but has to be pointed back at its target
+    place("E800010000");
+    CHECK(r.relocate(original, 5));
+    r.write(relocated);
+    CHECK(r.code.size() == 5);
+    CHECK(relocated[0] == static_cast<std::byte>(0xE8));
+    CHECK(relocated + 5 + read_displacement(relocated + 1) == original + 5 + 0x100);
+
+    // Instructions that don't branch are copied as-is, and we keep going until we have enough bytes
+    place("558BEC83EC10");
+    CHECK(r.relocate(original, 5));
+    CHECK(r.original_size == 6);
+    r.write(relocated);
+    CHECK(std::memcmp(relocated, original, 6) == 0);
+
+    // A branch to an instruction that was relocated has to go to the relocated copy (xor eax, eax; jz short back to it)
+    place("31C074FC");
+    CHECK(r.relocate(original, 4));
+    r.write(relocated);
+    CHECK(r.code.size() == 8);
+    CHECK(relocated + 8 + read_displacement(relocated + 4) == relocated);
+
+    // A branch into the middle of a relocated instruction can't be done
+    place("B80000000074FA");
+    CHECK(!r.relocate(original, 7));
+
+    // Neither can anything we can't decode
+    place("0F04");
+    CHECK(!r.relocate(original, 1));
+}
+
+int main(int argc, const char **argv) {
+    if(argc != 2) {
+        std::printf("Usage: %s <instruction_corpus.txt>\n", argv[0]);
+        return 1;
+    }
+
+    test_corpus(argv[1]);
+    test_decode();
+    test_reject();
+    test_relocate();
+
+    return test_result();
+}
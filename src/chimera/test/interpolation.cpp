@@ -0,0 +1,275 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "../fix/interpolate/object_interpolator.hpp"
+#include "../fix/interpolate/particle_interpolator.hpp"
+#include "interpolation_recording.hpp"
+#include "test.hpp"
+
+using namespace Chimera;
+
+// A tiny object table for the interpolator to work on
+struct TestObject {
+    bool exists = true;
+    TagID tag_id = { 0xE7410001 };
+    bool biped = false;
+    Point3D center = {};
+    std::vector<ModelNode> nodes;
+};
+
+#define TEST_OBJECT_COUNT 4
+
+static TestObject test_objects[TEST_OBJECT_COUNT];
+
+static bool find_object(std::size_t index, InterpolatorObject &object) {
+    auto &test = test_objects[index];
+    if(!test.exists) {
+        return false;
+    }
+    object = InterpolatorObject { index, test.tag_id, test.biped, &test.center, test.nodes.data(), test.nodes.size() };
+    return true;
+}
+
+static ModelNode make_node(float x, float angle) {
+    ModelNode node;
+    node.scale = 1.0F + x;
+    Quaternion q;
+    q.z = std::sin(angle / 2.0F);
+    q.w = std::cos(angle / 2.0F);
+    node.rotation = RotationMatrix(q);
+    node.position = { x, 0.0F, 0.0F };
+    return node;
+}
+
+// Put every object at x with the given node angle
+static void place(std::size_t index, float x, float angle) {
+    auto &object = test_objects[index];
+    object.center = { x, 1.0F, 2.0F };
+    object.nodes = { make_node(x, angle), make_node(x + 0.5F, angle) };
+}
+
+static void copy(ObjectInterpolator &interpolator) {
+    std::vector<InterpolatorObject> objects;
+    for(std::size_t i = 0; i < TEST_OBJECT_COUNT; i++) {
+        InterpolatorObject object;
+        if(find_object(i, object)) {
+            objects.push_back(object);
+        }
+    }
+    interpolator.copy(objects.data(), objects.size());
+}
+
+// Only object 0 is visible; object 1 is its child
+static const std::uint16_t CHILDREN_START[TEST_OBJECT_COUNT + 1] = { 0, 1, 1, 1, 1 };
+static const std::uint16_t CHILDREN[] = { 1 };
+
+static void queue(ObjectInterpolator &interpolator, std::size_t visible_count) {
+    ObjectID visible[TEST_OBJECT_COUNT];
+    for(std::size_t i = 0; i < TEST_OBJECT_COUNT; i++) {
+        visible[i].index.index = static_cast<std::uint16_t>(i);
+        visible[i].index.id = 0;
+    }
+    interpolator.queue(visible, visible_count, CHILDREN_START, CHILDREN, find_object);
+}
+
+static bool near(float a, float b) {
+    return std::fabs(a - b) < 1e-5F;
+}
+
+// Objects go from the last tick to this tick, and get put back exactly
+static void test_objects_interpolate() {
+    ObjectInterpolator interpolator;
+    interpolator.clear(TEST_OBJECT_COUNT);
+
+    for(std::size_t i = 0; i < TEST_OBJECT_COUNT; i++) {
+        place(i, 0.0F, 0.0F);
+    }
+    copy(interpolator);
+    copy(interpolator);
+
+    place(0, 1.0F, 0.5F);
+    place(1, 2.0F, 0.5F);
+    place(2, 0.0F, 0.0F);
+    place(3, 9.0F, 0.0F);
+    copy(interpolator);
+
+    // Object 2 didn't move and object 3 moved too far
+    CHECK(interpolator.statistics().copied == 4);
+    CHECK(interpolator.statistics().unchanged == 1);
+
+    // Nothing was copied before the first tick, so the first two ticks can't be interpolated between
+    ObjectInterpolator fresh;
+    fresh.clear(TEST_OBJECT_COUNT);
+    copy(fresh);
+    copy(fresh);
+    queue(fresh, TEST_OBJECT_COUNT);
+    CHECK(fresh.queued_count() == 0);
+
+    // Object 1 gets interpolated as a child of object 0
+    auto expected = test_objects[0].nodes;
+    queue(interpolator, 1);
+    CHECK(interpolator.queued_count() == 2);
+    interpolator.interpolate(0, interpolator.queued_count(), 0.25F);
+    CHECK(near(test_objects[0].center.x, 0.25F));
+    CHECK(near(test_objects[1].center.x, 0.5F));
+    CHECK(near(test_objects[0].nodes[1].position.x, 0.75F));
+    CHECK(near(test_objects[0].nodes[1].scale, 1.75F));
+    Quaternion rotation(test_objects[0].nodes[0].rotation);
+    CHECK(near(rotation.z, std::sin(0.0625F)));
+    interpolator.restore(0, interpolator.queued_count());
+    interpolator.finish_frame();
+
+    CHECK(test_objects[0].center.x == 1.0F);
+    CHECK(std::memcmp(test_objects[0].nodes.data(), expected.data(), sizeof(ModelNode) * expected.size()) == 0);
+
+    // Everything visible: object 2 is skipped since it didn't move, and object 3 isn't interpolated at all
+    queue(interpolator, TEST_OBJECT_COUNT);
+    CHECK(interpolator.queued_count() == 2);
+    CHECK(interpolator.statistics().skipped == 1);
+    interpolator.interpolate(0, interpolator.queued_count(), 0.5F);
+    CHECK(test_objects[3].center.x == 9.0F);
+    interpolator.restore(0, interpolator.queued_count());
+    interpolator.finish_frame();
+}
+
+// Objects that changed tags, went away, or are bipeds that moved too far aren't interpolated
+static void test_objects_not_interpolated() {
+    ObjectInterpolator interpolator;
+    interpolator.clear(TEST_OBJECT_COUNT);
+
+    for(std::size_t i = 0; i < TEST_OBJECT_COUNT; i++) {
+        test_objects[i] = TestObject();
+        place(i, 0.0F, 0.0F);
+    }
+    test_objects[3].exists = false;
+    copy(interpolator);
+    copy(interpolator);
+
+    place(0, 1.0F, 0.0F);
+    test_objects[0].tag_id.index.index++;
+    place(1, 3.0F, 0.0F);
+    test_objects[1].biped = true;
+    place(2, 3.0F, 0.0F);
+    test_objects[3].exists = true;
+    place(3, 1.0F, 0.0F);
+    copy(interpolator);
+
+    queue(interpolator, TEST_OBJECT_COUNT);
+    CHECK(interpolator.queued_count() == 1);
+    interpolator.interpolate(0, interpolator.queued_count(), 0.5F);
+    CHECK(test_objects[0].center.x == 1.0F);
+    CHECK(test_objects[1].center.x == 3.0F);
+    CHECK(near(test_objects[2].center.x, 1.5F));
+    CHECK(test_objects[3].center.x == 1.0F);
+    interpolator.restore(0, interpolator.queued_count());
+    interpolator.finish_frame();
+    CHECK(test_objects[2].center.x == 3.0F);
+}
+
+// Particles are interpolated if they can be on both ticks, and only within the table
+static void test_particles() {
+    struct TestParticle {
+        std::uint32_t padding;
+        Point3D position;
+    };
+    std::vector<TestParticle> table(40);
+
+    ParticleInterpolator interpolator;
+    interpolator.clear(table.size());
+
+    auto copy_particles = [&](float x, std::size_t count) {
+        auto copy_count = interpolator.begin_tick(count);
+        CHECK(copy_count == count);
+        for(std::size_t i = 0; i < copy_count; i++) {
+            table[i].position = { x + static_cast<float>(i), 0.0F, 0.0F };
+            interpolator.copy(i, table[i].position, i % 3 != 0);
+        }
+    };
+    copy_particles(0.0F, 40);
+    copy_particles(1.0F, 35);
+
+    interpolator.interpolate(&table.data()->position, sizeof(TestParticle), 36, 0.5F);
+    CHECK(table[0].position.x == 1.0F);
+    CHECK(table[1].position.x == 1.5F);
+    CHECK(table[34].position.x == 34.5F);
+    CHECK(table[35].position.x == 35.0F);
+
+    interpolator.restore(&table.data()->position, sizeof(TestParticle), 36);
+    for(std::size_t i = 0; i < 35; i++) {
+        CHECK(table[i].position.x == 1.0F + static_cast<float>(i));
+    }
+}
+
+// Recordings are read back the way record_interpolation.cpp writes them, skipping the camera, flags, and antennas
+static void test_read_recording() {
+    const char *path = "interpolation_test_recording.bin";
+    std::string data;
+    auto write = [&data](const auto &value) {
+        data.append(reinterpret_cast<const char *>(&value), sizeof(value));
+    };
+
+    // Header with 8 byte camera data, 3 byte flags, and 5 byte antennas
+    data += "CHIR";
+    write(std::uint32_t(1));
+    write(60.0F);
+    write(std::uint32_t(sizeof(ModelNode)));
+    write(std::uint32_t(8));
+    write(std::uint32_t(3));
+    write(std::uint32_t(5));
+
+    // One tick with one object, one particle, one flag, and no antennas
+    write(std::int32_t(7));
+    write(std::uint16_t(1));
+    write(std::uint16_t(12));
+    write(TagID { 0xE7410005 });
+    write(std::uint16_t(RECORDED_OBJECT_VEHICLE));
+    write(std::uint16_t(RECORDED_NO_PARENT));
+    write(std::uint8_t(1));
+    write(Point3D { 1.0F, 2.0F, 3.0F });
+    write(std::uint16_t(2));
+    write(make_node(4.0F, 0.0F));
+    write(make_node(5.0F, 0.0F));
+    write(std::uint16_t(1));
+    write(std::uint16_t(3));
+    write(std::uint32_t(0x10001));
+    write(Point3D { 6.0F, 7.0F, 8.0F });
+    write(std::uint16_t(2));
+    data.append(8, '\0');
+    write(std::uint8_t(1));
+    data.append(1 + 3, '\0');
+    write(std::uint8_t(0));
+
+    std::ofstream(path, std::ios_base::out | std::ios_base::binary | std::ios_base::trunc) << data;
+    Recording recording;
+    std::string error;
+    CHECK(read_recording(path, recording, error));
+    CHECK(recording.tick_rate == 60.0F);
+    CHECK(recording.ticks.size() == 1);
+    if(recording.ticks.size() == 1) {
+        auto &tick = recording.ticks[0];
+        CHECK(tick.tick == 7);
+        CHECK(tick.objects.size() == 1 && tick.objects[0].index == 12 && tick.objects[0].no_collision && tick.objects[0].nodes.size() == 2 && tick.objects[0].nodes[1].position.x == 5.0F);
+        CHECK(tick.particles.size() == 1 && tick.particles[0].index == 3 && tick.particles[0].position.z == 8.0F);
+        CHECK(recording.object_table_size() == 13);
+        CHECK(recording.particle_table_size() == 4);
+    }
+
+    // Cut off partway through a tick
+    data.pop_back();
+    std::ofstream(path, std::ios_base::out | std::ios_base::binary | std::ios_base::trunc) << data;
+    CHECK(!read_recording(path, recording, error));
+    std::remove(path);
+}
+
+int main() {
+    test_objects_interpolate();
+    test_objects_not_interpolated();
+    test_particles();
+    test_read_recording();
+    return test_result();
+}
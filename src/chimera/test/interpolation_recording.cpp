@@ -0,0 +1,270 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <random>
+
+#include "interpolation_recording.hpp"
+
+namespace Chimera {
+    std::size_t Recording::object_table_size() const noexcept {
+        std::size_t size = 0;
+        for(auto &tick : this->ticks) {
+            for(auto &object : tick.objects) {
+                size = std::max<std::size_t>(size, object.index + 1);
+            }
+        }
+        return size;
+    }
+
+    std::size_t Recording::particle_table_size() const noexcept {
+        std::size_t size = 0;
+        for(auto &tick : this->ticks) {
+            for(auto &particle : tick.particles) {
+                size = std::max<std::size_t>(size, particle.index + 1);
+            }
+        }
+        return size;
+    }
+
+    static bool read(std::istream &in, void *data, std::size_t size) {
+        return static_cast<bool>(in.read(reinterpret_cast<char *>(data), static_cast<std::streamsize>(size)));
+    }
+
+    template<typename T> static bool read(std::istream &in, T &value) {
+        return read(in, &value, sizeof(value));
+    }
+
+    static bool skip(std::istream &in, std::size_t size) {
+        return static_cast<bool>(in.ignore(static_cast<std::streamsize>(size))) && static_cast<std::size_t>(in.gcount()) == size;
+    }
+
+    bool read_recording(const char *path, Recording &recording, std::string &error) {
+        std::ifstream in(path, std::ios_base::in | std::ios_base::binary);
+        if(!in.is_open()) {
+            error = std::string("can't open ") + path;
+            return false;
+        }
+
+        // See record_interpolation.cpp for the format.
+        char magic[4];
+        std::uint32_t version, model_node_size, camera_data_size, flag_size, antenna_size;
+        if(!read(in, magic) || std::memcmp(magic, "CHIR", sizeof(magic)) != 0 || !read(in, version) || version != 1) {
+            error = "not a version 1 interpolation recording";
+            return false;
+        }
+        if(!read(in, recording.tick_rate) || !read(in, model_node_size) || !read(in, camera_data_size) || !read(in, flag_size) || !read(in, antenna_size)) {
+            error = "truncated header";
+            return false;
+        }
+        if(model_node_size != sizeof(ModelNode)) {
+            error = "model nodes are " + std::to_string(model_node_size) + " bytes rather than " + std::to_string(sizeof(ModelNode));
+            return false;
+        }
+
+        recording.ticks.clear();
+        RecordedTick tick;
+        while(read(in, tick.tick)) {
+            auto truncated = [&error, &recording]() {
+                error = "truncated after " + std::to_string(recording.ticks.size()) + " tick(s)";
+                return false;
+            };
+
+            std::uint16_t object_count;
+            if(!read(in, object_count)) {
+                return truncated();
+            }
+            tick.objects.resize(object_count);
+            for(auto &object : tick.objects) {
+                std::uint8_t no_collision;
+                std::uint16_t node_count;
+                if(!read(in, object.index) || !read(in, object.tag_id) || !read(in, object.type) || !read(in, object.parent) || !read(in, no_collision) || !read(in, object.center) || !read(in, node_count)) {
+                    return truncated();
+                }
+                object.no_collision = no_collision;
+                object.nodes.resize(node_count);
+                if(!read(in, object.nodes.data(), sizeof(ModelNode) * node_count)) {
+                    return truncated();
+                }
+            }
+
+            std::uint16_t particle_count;
+            if(!read(in, particle_count)) {
+                return truncated();
+            }
+            tick.particles.resize(particle_count);
+            for(auto &particle : tick.particles) {
+                if(!read(in, particle.index) || !read(in, particle.unknown0) || !read(in, particle.position)) {
+                    return truncated();
+                }
+            }
+
+            // Skip the camera, flags, and antennas.
+            std::uint8_t flag_count, antenna_count;
+            if(!skip(in, sizeof(std::uint16_t) + camera_data_size) || !read(in, flag_count) || !skip(in, flag_count * (1 + flag_size)) || !read(in, antenna_count) || !skip(in, antenna_count * (1 + antenna_size))) {
+                return truncated();
+            }
+
+            recording.ticks.push_back(std::move(tick));
+        }
+
+        if(recording.ticks.empty()) {
+            error = "no ticks were recorded";
+            return false;
+        }
+        return true;
+    }
+
+    // A made up object and how it moves
+    struct SyntheticObject {
+        std::uint16_t type;
+        std::uint16_t parent;
+        bool no_collision;
+        std::size_t node_count;
+        Point3D position;
+        Point3D velocity;
+        Point3D axis;
+        float angle;
+        float angular_velocity;
+    };
+
+    static Quaternion axis_angle(const Point3D &axis, float angle) {
+        Quaternion q;
+        float s = std::sin(angle * 0.5F);
+        q.x = axis.x * s;
+        q.y = axis.y * s;
+        q.z = axis.z * s;
+        q.w = std::cos(angle * 0.5F);
+        return q;
+    }
+
+    Recording make_synthetic_recording(std::size_t object_count, std::size_t tick_count, std::uint32_t seed) {
+        std::mt19937 random(seed);
+        std::uniform_real_distribution<float> coordinate(-100.0F, 100.0F);
+        std::uniform_real_distribution<float> unit(-1.0F, 1.0F);
+        std::uniform_real_distribution<float> chance(0.0F, 1.0F);
+
+        auto random_axis = [&]() {
+            Point3D axis = { unit(random), unit(random), unit(random) + 2.0F };
+            float length = std::sqrt(axis.x * axis.x + axis.y * axis.y + axis.z * axis.z);
+            return Point3D { axis.x / length, axis.y / length, axis.z / length };
+        };
+
+        // Lay out the object table: bipeds each followed by the weapon they're holding, some vehicles, lots of projectiles, and the rest
+        // is scenery and dropped weapons that don't move.
+        object_count = std::min<std::size_t>(object_count, RECORDED_NO_PARENT);
+        std::vector<SyntheticObject> objects(object_count);
+        for(std::size_t i = 0; i < object_count; i++) {
+            auto &object = objects[i];
+            object.parent = RECORDED_NO_PARENT;
+            object.no_collision = false;
+            object.position = { coordinate(random), coordinate(random), coordinate(random) * 0.1F };
+            object.velocity = { 0.0F, 0.0F, 0.0F };
+            object.axis = random_axis();
+            object.angle = unit(random) * 3.0F;
+            object.angular_velocity = 0.0F;
+
+            auto kind = i % 10;
+            if(kind < 2) {
+                if(kind == 0) {
+                    object.type = RECORDED_OBJECT_BIPED;
+                    object.node_count = 19;
+                    object.velocity = { unit(random) * 0.07F, unit(random) * 0.07F, 0.0F };
+                    object.angular_velocity = unit(random) * 0.05F;
+                }
+                else {
+                    object.type = RECORDED_OBJECT_WEAPON;
+                    object.parent = static_cast<std::uint16_t>(i - 1);
+                    object.node_count = 3;
+                }
+            }
+            else if(kind == 2) {
+                object.type = RECORDED_OBJECT_VEHICLE;
+                object.node_count = 12;
+                object.velocity = { unit(random) * 0.5F, unit(random) * 0.5F, unit(random) * 0.05F };
+                object.angular_velocity = unit(random) * 0.1F;
+            }
+            else if(kind < 6) {
+                object.type = RECORDED_OBJECT_PROJECTILE;
+                object.node_count = 1;
+                object.velocity = { unit(random) * 3.0F, unit(random) * 3.0F, unit(random) * 1.0F };
+                object.angular_velocity = unit(random) * 0.3F;
+            }
+            else if(kind < 9) {
+                object.type = RECORDED_OBJECT_SCENERY;
+                object.node_count = 1 + static_cast<std::size_t>(chance(random) * 8.0F);
+            }
+            else {
+                object.type = RECORDED_OBJECT_WEAPON;
+                object.no_collision = chance(random) < 0.5F;
+                object.node_count = 3;
+            }
+        }
+
+        Recording recording;
+        recording.tick_rate = 30.0F;
+        recording.ticks.resize(tick_count);
+        for(std::size_t t = 0; t < tick_count; t++) {
+            auto &tick = recording.ticks[t];
+            tick.tick = static_cast<std::int32_t>(t);
+            tick.objects.reserve(object_count);
+
+            for(std::size_t i = 0; i < object_count; i++) {
+                auto &object = objects[i];
+
+                // Projectiles hit things and get replaced, and some get teleported too far to be interpolated.
+                if(object.type == RECORDED_OBJECT_PROJECTILE) {
+                    auto roll = chance(random);
+                    if(roll < 0.02F) {
+                        continue;
+                    }
+                    else if(roll < 0.03F) {
+                        object.position.x += 50.0F;
+                    }
+                }
+
+                // Weapons go wherever their holder is.
+                if(object.parent != RECORDED_NO_PARENT) {
+                    object.position = objects[object.parent].position;
+                    object.angle = objects[object.parent].angle;
+                }
+
+                RecordedObject recorded;
+                recorded.index = static_cast<std::uint16_t>(i);
+                recorded.tag_id.index.index = object.type;
+                recorded.tag_id.index.id = static_cast<std::uint16_t>(0xE740 + object.type);
+                recorded.type = object.type;
+                recorded.parent = object.parent;
+                recorded.no_collision = object.no_collision;
+                recorded.center = object.position;
+                recorded.nodes.resize(object.node_count);
+                for(std::size_t n = 0; n < object.node_count; n++) {
+                    auto &node = recorded.nodes[n];
+                    node.scale = 1.0F;
+                    node.rotation = RotationMatrix(axis_angle(object.axis, object.angle + static_cast<float>(n) * 0.2F));
+                    node.position = { object.position.x + static_cast<float>(n) * 0.05F, object.position.y, object.position.z + static_cast<float>(n) * 0.1F };
+                }
+                tick.objects.push_back(std::move(recorded));
+
+                object.position.x += object.velocity.x;
+                object.position.y += object.velocity.y;
+                object.position.z += object.velocity.z;
+                object.angle += object.angular_velocity;
+            }
+
+            // Some particles for each object, drifting along
+            tick.particles.resize(object_count);
+            for(std::size_t p = 0; p < object_count; p++) {
+                auto &particle = tick.particles[p];
+                auto &object = objects[p];
+                particle.index = static_cast<std::uint16_t>(p);
+                particle.unknown0 = p % 4 == 3 ? 0 : 1;
+                particle.position = { object.position.x, object.position.y + 0.5F, object.position.z + static_cast<float>(t % 30) * 0.02F };
+            }
+        }
+
+        return recording;
+    }
+}
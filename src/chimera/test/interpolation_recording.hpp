@@ -0,0 +1,99 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#ifndef CHIMERA_TEST_INTERPOLATION_RECORDING_HPP
+#define CHIMERA_TEST_INTERPOLATION_RECORDING_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "../halo_data/model_node.hpp"
+#include "../halo_data/type.hpp"
+
+namespace Chimera {
+    // Object types as Halo numbers them. object.hpp can't be included here since it only builds for 32-bit Windows.
+    #define RECORDED_OBJECT_BIPED 0
+    #define RECORDED_OBJECT_VEHICLE 1
+    #define RECORDED_OBJECT_WEAPON 2
+    #define RECORDED_OBJECT_PROJECTILE 5
+    #define RECORDED_OBJECT_SCENERY 6
+
+    // Parent index of objects without a parent
+    #define RECORDED_NO_PARENT 0xFFFF
+
+    /**
+     * An object as recorded by chimera_record_interpolation
+     */
+    struct RecordedObject {
+        std::uint16_t index;
+        TagID tag_id;
+        std::uint16_t type;
+        std::uint16_t parent;
+        bool no_collision;
+        Point3D center;
+        std::vector<ModelNode> nodes;
+    };
+
+    /**
+     * A particle as recorded by chimera_record_interpolation
+     */
+    struct RecordedParticle {
+        std::uint16_t index;
+        std::uint32_t unknown0;
+        Point3D position;
+    };
+
+    /**
+     * Everything recorded on one tick. The camera, flags, and antennas are skipped since they're interpolated separately.
+     */
+    struct RecordedTick {
+        std::int32_t tick;
+        std::vector<RecordedObject> objects;
+        std::vector<RecordedParticle> particles;
+    };
+
+    /**
+     * A recording made with chimera_record_interpolation
+     */
+    struct Recording {
+        /** Ticks per second */
+        float tick_rate = 30.0F;
+
+        /** Objects and particles on each tick */
+        std::vector<RecordedTick> ticks;
+
+        /**
+         * Get one more than the highest object index in the recording
+         * @return object table size needed to replay the recording
+         */
+        std::size_t object_table_size() const noexcept;
+
+        /**
+         * Get one more than the highest particle index in the recording
+         * @return particle table size needed to replay the recording
+         */
+        std::size_t particle_table_size() const noexcept;
+    };
+
+    /**
+     * Read a recording
+     * @param  path      path to the recording
+     * @param  recording recording to read into
+     * @param  error     set to what went wrong if the recording couldn't be read
+     * @return           true if the recording was read
+     */
+    bool read_recording(const char *path, Recording &recording, std::string &error);
+
+    /**
+     * Make up a recording of a busy map: moving bipeds holding weapons, vehicles, projectiles that come and go and sometimes jump too far
+     * to be interpolated, and stationary scenery.
+     * @param  object_count number of objects on each tick
+     * @param  tick_count   number of ticks
+     * @param  seed         random seed
+     * @return              recording
+     */
+    Recording make_synthetic_recording(std::size_t object_count, std::size_t tick_count, std::uint32_t seed);
+}
+
+#endif
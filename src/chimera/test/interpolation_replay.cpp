@@ -0,0 +1,257 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "../fix/interpolate/object_interpolator.hpp"
+#include "../fix/interpolate/particle_interpolator.hpp"
+#include "../halo_data/object_children.hpp"
+#include "interpolation_recording.hpp"
+
+using namespace Chimera;
+
+// This is the object table as the replay sees it. Interpolation writes to it just like it would write to Halo's object table.
+struct LiveObject {
+    bool exists = false;
+    TagID tag_id;
+    bool biped = false;
+    Point3D center;
+    std::vector<ModelNode> nodes;
+};
+
+static std::vector<LiveObject> live_objects;
+
+static bool find_object(std::size_t index, InterpolatorObject &object) {
+    auto &live = live_objects[index];
+    if(!live.exists) {
+        return false;
+    }
+    object.index = index;
+    object.tag_id = live.tag_id;
+    object.biped = live.biped;
+    object.center = &live.center;
+    object.nodes = live.nodes.data();
+    object.node_count = live.nodes.size();
+    return true;
+}
+
+// Same as the particle table: positions are strided like Halo's particles are
+struct LiveParticle {
+    std::uint32_t unknown0;
+    Point3D position;
+};
+
+static std::uint64_t fnv1a(std::uint64_t hash, const void *data, std::size_t size) noexcept {
+    auto *bytes = reinterpret_cast<const std::uint8_t *>(data);
+    for(std::size_t i = 0; i < size; i++) {
+        hash = (hash ^ bytes[i]) * 0x100000001B3;
+    }
+    return hash;
+}
+
+#define FNV_OFFSET_BASIS 0xCBF29CE484222325
+
+// Hash everything interpolation could have written to
+static std::uint64_t checksum_frame(const std::vector<LiveParticle> &particles) noexcept {
+    auto hash = static_cast<std::uint64_t>(FNV_OFFSET_BASIS);
+    for(auto &object : live_objects) {
+        if(object.exists) {
+            hash = fnv1a(hash, &object.center, sizeof(object.center));
+            hash = fnv1a(hash, object.nodes.data(), sizeof(ModelNode) * object.nodes.size());
+        }
+    }
+    for(auto &particle : particles) {
+        hash = fnv1a(hash, &particle.position, sizeof(particle.position));
+    }
+    return hash;
+}
+
+struct Timings {
+    std::vector<double> microseconds;
+
+    void print(const char *name) {
+        if(this->microseconds.empty()) {
+            return;
+        }
+        auto sorted = this->microseconds;
+        std::sort(sorted.begin(), sorted.end());
+        double total = 0.0;
+        for(auto t : sorted) {
+            total += t;
+        }
+        std::printf("%-24s mean %9.2f us, median %9.2f us, p99 %9.2f us, max %9.2f us (%zu)\n", name, total / sorted.size(), sorted[sorted.size() / 2], sorted[sorted.size() * 99 / 100], sorted.back(), sorted.size());
+    }
+};
+
+static double microseconds_since(std::chrono::steady_clock::time_point start) noexcept {
+    return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Replay a recording (or a made up one) at the given frame rate, timing each tick's copy and each frame's interpolation and checksumming
+// what each frame interpolated
+int main(int argc, const char **argv) {
+    bool print_frames = argc > 1 && std::strcmp(argv[argc - 1], "--frames") == 0;
+    if(print_frames) {
+        argc--;
+    }
+
+    Recording recording;
+    int arg = 1;
+    if(argc >= 4 && std::strcmp(argv[1], "--synthetic") == 0) {
+        recording = make_synthetic_recording(std::strtoul(argv[2], nullptr, 10), std::strtoul(argv[3], nullptr, 10), 12345);
+        arg = 4;
+    }
+    else if(argc >= 2 && argv[1][0] != '-') {
+        std::string error;
+        if(!read_recording(argv[1], recording, error)) {
+            std::fprintf(stderr, "%s: %s\n", argv[1], error.c_str());
+            return 1;
+        }
+        arg = 2;
+    }
+    if(argc - arg > 1 || recording.ticks.empty()) {
+        std::printf("Usage: %s <recording.bin | --synthetic <objects> <ticks>> [fps] [--frames]\n", argv[0]);
+        return 1;
+    }
+    double fps = argc > arg ? std::strtod(argv[arg], nullptr) : 144.0;
+    if(!(fps > 0.0)) {
+        std::fprintf(stderr, "fps must be positive\n");
+        return 1;
+    }
+
+    std::size_t object_table_size = recording.object_table_size();
+    std::size_t particle_table_size = recording.particle_table_size();
+    live_objects.assign(object_table_size, LiveObject {});
+    std::vector<LiveParticle> live_particles(particle_table_size);
+
+    ObjectInterpolator objects;
+    ParticleInterpolator particles;
+    objects.clear(object_table_size);
+    particles.clear(particle_table_size);
+
+    std::vector<InterpolatorObject> objects_to_copy;
+    std::vector<ObjectID> visible;
+    std::vector<std::uint16_t> parents, children_start, children;
+
+    Timings copy_timings, frame_timings;
+    std::size_t frame_count = 0, interpolated = 0, skipped = 0, restore_mismatches = 0;
+    auto checksum = static_cast<std::uint64_t>(FNV_OFFSET_BASIS);
+
+    for(std::size_t t = 0; t < recording.ticks.size(); t++) {
+        auto &tick = recording.ticks[t];
+
+        // Put the tick's objects and particles in the tables.
+        for(auto &live : live_objects) {
+            live.exists = false;
+        }
+        for(auto &object : tick.objects) {
+            auto &live = live_objects[object.index];
+            live.exists = true;
+            live.tag_id = object.tag_id;
+            live.biped = object.type == RECORDED_OBJECT_BIPED;
+            live.center = object.center;
+            live.nodes = object.nodes;
+        }
+        std::size_t particle_count = 0;
+        for(auto &particle : live_particles) {
+            particle.unknown0 = 0;
+        }
+        for(auto &particle : tick.particles) {
+            live_particles[particle.index] = LiveParticle { particle.unknown0, particle.position };
+            particle_count = std::max<std::size_t>(particle_count, particle.index + 1);
+        }
+
+        // Copy them, skipping what the game skips.
+        auto copy_start = std::chrono::steady_clock::now();
+        objects_to_copy.clear();
+        for(auto &object : tick.objects) {
+            auto &live = live_objects[object.index];
+            if((object.no_collision && object.type == RECORDED_OBJECT_WEAPON) || live.nodes.empty()) {
+                continue;
+            }
+            objects_to_copy.push_back(InterpolatorObject { object.index, live.tag_id, live.biped, &live.center, live.nodes.data(), live.nodes.size() });
+        }
+        objects.copy(objects_to_copy.data(), objects_to_copy.size());
+        auto copy_count = particles.begin_tick(particle_count);
+        for(std::size_t i = 0; i < copy_count; i++) {
+            particles.copy(i, live_particles[i].position, live_particles[i].unknown0 & 0xFFFF);
+        }
+        copy_timings.microseconds.push_back(microseconds_since(copy_start));
+
+        // Everything is visible, and children are found from their parents.
+        visible.clear();
+        parents.clear();
+        for(auto &object : tick.objects) {
+            ObjectID id;
+            id.index.index = object.index;
+            id.index.id = 0;
+            visible.push_back(id);
+            parents.push_back(object.parent < object_table_size && live_objects[object.parent].exists ? object.parent : RECORDED_NO_PARENT);
+        }
+        build_object_children(visible.data(), parents.data(), parents.size(), object_table_size, children_start, children);
+
+        // Render every frame that falls in this tick.
+        auto first_frame = static_cast<std::size_t>(std::ceil(t * fps / recording.tick_rate));
+        auto end_frame = static_cast<std::size_t>(std::ceil((t + 1) * fps / recording.tick_rate));
+        for(auto frame = first_frame; frame < end_frame; frame++) {
+            auto progress = static_cast<float>(frame * recording.tick_rate / fps - t);
+
+            auto frame_start = std::chrono::steady_clock::now();
+            objects.queue(visible.data(), visible.size(), children_start.data(), children.data(), find_object);
+            objects.interpolate(0, objects.queued_count(), progress);
+            particles.interpolate(&live_particles.data()->position, sizeof(LiveParticle), particle_count, progress);
+            auto frame_time = microseconds_since(frame_start);
+
+            auto frame_checksum = checksum_frame(live_particles);
+            checksum = fnv1a(checksum, &frame_checksum, sizeof(frame_checksum));
+            interpolated += objects.statistics().interpolated;
+            skipped += objects.statistics().skipped;
+
+            frame_start = std::chrono::steady_clock::now();
+            objects.restore(0, objects.queued_count());
+            objects.finish_frame();
+            particles.restore(&live_particles.data()->position, sizeof(LiveParticle), particle_count);
+            frame_time += microseconds_since(frame_start);
+            frame_timings.microseconds.push_back(frame_time);
+            frame_count++;
+
+            if(print_frames) {
+                std::printf("tick %6zu frame %8zu progress %.3f: %8.2f us, %016" PRIx64 "\n", t, frame, progress, frame_time, frame_checksum);
+            }
+
+            // Everything should be exactly where it was recorded once it's restored.
+            for(auto &object : tick.objects) {
+                auto &live = live_objects[object.index];
+                if(std::memcmp(&live.center, &object.center, sizeof(object.center)) != 0 || std::memcmp(live.nodes.data(), object.nodes.data(), sizeof(ModelNode) * object.nodes.size()) != 0) {
+                    restore_mismatches++;
+                }
+            }
+            for(auto &particle : tick.particles) {
+                if(std::memcmp(&live_particles[particle.index].position, &particle.position, sizeof(particle.position)) != 0) {
+                    restore_mismatches++;
+                }
+            }
+        }
+    }
+
+    std::printf("%zu tick(s) at %.2f ticks per second, %zu frame(s) at %.2f FPS, %zu object(s), %zu particle(s)\n", recording.ticks.size(), recording.tick_rate, frame_count, fps, object_table_size, particle_table_size);
+    if(frame_count) {
+        std::printf("%.1f object(s) interpolated and %.1f skipped per frame\n", static_cast<double>(interpolated) / frame_count, static_cast<double>(skipped) / frame_count);
+    }
+    copy_timings.print("copy (per tick)");
+    frame_timings.print("interpolate (per frame)");
+    std::printf("checksum %016" PRIx64 "\n", checksum);
+
+    if(restore_mismatches) {
+        std::fprintf(stderr, "%zu object(s) or particle(s) weren't restored to where they were recorded\n", restore_mismatches);
+        return 1;
+    }
+    return 0;
+}
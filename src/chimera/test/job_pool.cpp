@@ -0,0 +1,126 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include <atomic>
+#include <chrono>
+#include <ctime>
+#include <thread>
+#include <vector>
+#include "../job/job_pool.hpp"
+#include "test.hpp"
+
+using namespace Chimera;
+
+// Every job runs exactly once, and wait_idle() waits for all of them
+static void test_run_once() {
+    JobPool pool(4);
+    CHECK(pool.thread_count() == 4);
+
+    std::vector<std::atomic<int>> runs(1000);
+    for(auto &r : runs) {
+        r = 0;
+    }
+    for(auto &r : runs) {
+        pool.submit([&r]() { r++; });
+    }
+    pool.wait_idle();
+
+    for(auto &r : runs) {
+        CHECK(r == 1);
+    }
+}
+
+// Jobs can queue more jobs, and wait_idle() waits for those too
+static void test_nested() {
+    JobPool pool(3);
+    std::atomic<int> count = 0;
+    for(int i = 0; i < 100; i++) {
+        pool.submit([&pool, &count]() {
+            count++;
+            for(int j = 0; j < 10; j++) {
+                pool.submit([&count]() { count++; });
+            }
+        });
+    }
+    pool.wait_idle();
+    CHECK(count == 100 * 11);
+}
+
+// Destroying the pool finishes anything still queued
+static void test_destroy() {
+    std::atomic<int> count = 0;
+    {
+        JobPool pool(0);
+        CHECK(pool.thread_count() == 1);
+        for(int i = 0; i < 100; i++) {
+            pool.submit([&count]() { count++; });
+        }
+    }
+    CHECK(count == 100);
+}
+
+// Functions posted from any thread run on whoever calls run()
+static void test_completion_queue() {
+    CompletionQueue completions;
+    CHECK(completions.run() == 0);
+
+    auto main_thread = std::this_thread::get_id();
+    int count = 0;
+    {
+        JobPool pool(4);
+        for(int i = 0; i < 100; i++) {
+            pool.submit([&completions, &count, main_thread]() {
+                completions.post([&count, main_thread]() {
+                    CHECK(std::this_thread::get_id() == main_thread);
+                    count++;
+                });
+            });
+        }
+        pool.wait_idle();
+    }
+    CHECK(completions.run() == 100);
+    CHECK(count == 100);
+    CHECK(completions.run() == 0);
+}
+
+// Hammer the pool from several threads at once with tiny jobs, so workers take jobs as fast as they can be submitted
+static void test_stress() {
+    static const std::size_t SUBMITTERS = 4;
+    static const std::size_t ROUNDS = 200;
+    static const std::size_t JOBS = 250;
+
+    JobPool pool(4);
+    std::atomic<std::size_t> count = 0;
+    for(std::size_t round = 0; round < ROUNDS; round++) {
+        std::vector<std::thread> submitters;
+        for(std::size_t s = 0; s < SUBMITTERS; s++) {
+            submitters.emplace_back([&pool, &count]() {
+                for(std::size_t j = 0; j < JOBS; j++) {
+                    pool.submit([&count]() { count++; });
+                }
+            });
+        }
+        for(auto &s : submitters) {
+            s.join();
+        }
+        pool.wait_idle();
+        CHECK(count == (round + 1) * SUBMITTERS * JOBS);
+    }
+
+    // Idle workers have to actually be asleep. If the queued count ever went wrong, they'd spin looking for work that isn't there.
+    auto start = std::clock();
+    std::this_thread::sleep_for(std::chrono::milliseconds(250));
+    auto cpu_ms = (std::clock() - start) * 1000 / CLOCKS_PER_SEC;
+    if(cpu_ms >= 50) {
+        std::fprintf(stderr, "idle pool used %ld ms of CPU time in 250 ms\n", static_cast<long>(cpu_ms));
+    }
+    CHECK(cpu_ms < 50);
+}
+
+int main() {
+    test_run_once();
+    test_nested();
+    test_destroy();
+    test_completion_queue();
+    test_stress();
+    return test_result();
+}
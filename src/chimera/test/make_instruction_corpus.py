@@ -0,0 +1,162 @@
+#!/usr/bin/env python3
+# SPDX-License-Identifier: GPL-3.0-only
+#
+# Generate instruction_corpus.txt, the instructions the instruction length decoder is tested against. Each candidate is disassembled with
+# GNU objdump, and whatever length objdump says it has is what the decoder is expected to find.
+#
+# Usage: make_instruction_corpus.py <output>
+
+import subprocess
+import sys
+import tempfile
+
+PREFIXES = { 0x26, 0x2E, 0x36, 0x3E, 0x64, 0x65, 0x66, 0x67, 0xF0, 0xF2, 0xF3 }
+
+# Bytes after the opcode, covering each ModRM form: memory, SIB, SIB with no base (disp32), disp32, disp8, SIB + disp8, disp32, register,
+# and a few different reg fields since some opcodes (F6/F7) change meaning with them. The rest is filler for any immediate.
+FILLER = [ 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77, 0x88 ]
+MODRM_FORMS = [
+    [ 0x00 ],
+    [ 0x04, 0x88 ],
+    [ 0x04, 0x05 ],
+    [ 0x05 ],
+    [ 0x40 ],
+    [ 0x44, 0x88 ],
+    [ 0x80 ],
+    [ 0xC0 ],
+    [ 0xC8 ],
+    [ 0x10 ],
+    [ 0x38 ],
+]
+
+# Each candidate gets a slot this big, padded with NOPs, so objdump gets back in sync before the next one
+SLOT_SIZE = 64
+
+def candidates():
+    # One-byte opcodes
+    for opcode in range(0x100):
+        if opcode in PREFIXES or opcode == 0x0F:
+            continue
+        for form in MODRM_FORMS:
+            yield [ opcode ] + form + FILLER
+
+    # Two-byte opcodes
+    for opcode in range(0x100):
+        if opcode in (0x38, 0x3A):
+            for third in (0x00, 0x01, 0x0F, 0x17, 0x40):
+                for form in MODRM_FORMS[:8]:
+                    yield [ 0x0F, opcode, third ] + form + FILLER
+            continue
+        for form in MODRM_FORMS:
+            yield [ 0x0F, opcode ] + form + FILLER
+
+    # Prefixes on things compilers commonly emit
+    common = [
+        [ 0x89, 0x44, 0x24, 0x10 ],               # mov [esp+0x10], eax
+        [ 0xC7, 0x05 ],                           # mov [disp32], imm
+        [ 0xC7, 0x44, 0x24, 0x08 ],               # mov [esp+8], imm
+        [ 0x81, 0xC1 ],                           # add ecx, imm
+        [ 0x83, 0xC1 ],                           # add ecx, imm8
+        [ 0xA1 ],                                 # mov eax, [moffs]
+        [ 0xA3 ],                                 # mov [moffs], eax
+        [ 0xB8 ],                                 # mov eax, imm
+        [ 0x0F, 0xB7, 0x45, 0x08 ],               # movzx eax, word [ebp+8]
+        [ 0x0F, 0x10, 0x44, 0x24, 0x04 ],         # movups xmm0, [esp+4]
+        [ 0x0F, 0x2C, 0xC1 ],                     # cvttps2pi / cvttss2si
+        [ 0x0F, 0x58, 0xC1 ],                     # addps / addss / addpd / addsd
+        [ 0x0F, 0x6F, 0x44, 0x24, 0x10 ],         # movq / movdqa / movdqu
+        [ 0x0F, 0x7E, 0xC0 ],                     # movd / movq
+        [ 0x0F, 0xD6, 0x44, 0x24, 0x10 ],         # movq
+        [ 0xA5 ],                                 # movsd
+        [ 0xAB ],                                 # stosd
+        [ 0xF6, 0x05 ],                           # test byte [disp32], imm8
+        [ 0xF7, 0x05 ],                           # test dword [disp32], imm
+        [ 0x69, 0xC0 ],                           # imul eax, eax, imm
+        [ 0xFF, 0x15 ],                           # call [disp32]
+        [ 0x01, 0x00 ],                           # add [eax], eax
+        [ 0x8B, 0x40, 0x10 ],                     # mov eax, [eax+0x10] (16-bit addressing with 67)
+        [ 0x8B, 0x06 ],                           # mov eax, [esi] / [disp16]
+        [ 0x8B, 0x80 ],                           # mov eax, [eax+disp32] / [bx+si+disp16]
+        [ 0x8B, 0x04, 0x24 ],                     # mov eax, [esp] / [si]
+    ]
+    prefix_sets = [ [ 0x66 ], [ 0x67 ], [ 0xF2 ], [ 0xF3 ], [ 0xF0 ], [ 0x2E ], [ 0x64 ], [ 0x66, 0x67 ], [ 0x67, 0x66 ], [ 0xF3, 0x66 ],
+                    [ 0x66, 0xF2 ], [ 0x64, 0x66 ], [ 0x26, 0x67 ] ]
+    for prefixes in prefix_sets:
+        for instruction in common:
+            yield prefixes + instruction + FILLER
+
+    # Prefixes on relative branches
+    branches = [ [ 0xEB ], [ 0x74 ], [ 0xE2 ], [ 0xE3 ], [ 0xE8 ], [ 0xE9 ], [ 0x0F, 0x84 ] ]
+    for prefixes in ([ 0x2E ], [ 0x3E ], [ 0x66 ], [ 0x67 ], [ 0xF2 ]):
+        for branch in branches:
+            yield prefixes + branch + FILLER
+
+def disassemble(slots):
+    with tempfile.NamedTemporaryFile(suffix=".bin") as f:
+        for slot in slots:
+            f.write(bytes(slot + [ 0x90 ] * (SLOT_SIZE - len(slot))))
+        f.flush()
+        output = subprocess.run([ "objdump", "-D", "-b", "binary", "-m", "i386", "-M", "intel", "--insn-width=16", f.name ],
+                                check=True, capture_output=True, text=True).stdout
+
+    results = {}
+    for line in output.splitlines():
+        parts = line.split("\t")
+        if len(parts) < 2 or not parts[0].strip().endswith(":"):
+            continue
+        address = int(parts[0].strip()[:-1], 16)
+        if address % SLOT_SIZE != 0:
+            continue
+        length = len(parts[1].split())
+        text = " ".join(" ".join(parts[2:]).split()) if len(parts) > 2 else ""
+        results[address // SLOT_SIZE] = (length, text)
+    return [ results[i] for i in range(len(slots)) ]
+
+# Relative branches are the only thing the decoder reports beyond the length, so work out where their displacement is.
+def relative_branch(instruction):
+    at = 0
+    while instruction[at] in PREFIXES:
+        at += 1
+    opcode = instruction[at]
+    if opcode == 0x0F and 0x80 <= instruction[at + 1] <= 0x8F:
+        return (at + 2, 4)
+    if opcode in (0xE8, 0xE9):
+        return (at + 1, 4)
+    if 0x70 <= opcode <= 0x7F or 0xE0 <= opcode <= 0xE3 or opcode == 0xEB:
+        return (at + 1, 1)
+    return (0, 0)
+
+def main():
+    if len(sys.argv) != 2:
+        print("Usage: {} <output>".format(sys.argv[0]), file=sys.stderr)
+        sys.exit(1)
+
+    slots = list(candidates())
+    disassembly = disassemble(slots)
+
+    seen = set()
+    lines = []
+    for slot, (length, text) in zip(slots, disassembly):
+        instruction = slot[:length]
+        if bytes(instruction) in seen:
+            continue
+        seen.add(bytes(instruction))
+
+        # objdump can't tell us the length of something that isn't an instruction
+        if "(bad)" in text or text == "":
+            length = 0
+            relative = (0, 0)
+            instruction = slot[:4]
+        else:
+            relative = relative_branch(instruction)
+
+        lines.append("{} {} {} {} ; {}".format("".join("{:02X}".format(b) for b in instruction), length, relative[0], relative[1], text))
+
+    with open(sys.argv[1], "w") as f:
+        f.write("# Generated by make_instruction_corpus.py from GNU objdump. Do not edit.\n")
+        f.write("# bytes length relative_offset relative_size ; disassembly (length 0 means objdump could not decode it)\n")
+        for line in lines:
+            f.write(line + "\n")
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,202 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+#include "../math_trig/math_trig.hpp"
+#include "test.hpp"
+
+using namespace Chimera;
+
+// interpolate_quats() has to be within this many radians of a double precision slerp
+#define MAX_ROTATION_ERROR 1e-6
+
+// ...and its results have to be this close to unit length
+#define MAX_LENGTH_ERROR 2e-6
+
+static Quaternion random_quaternion(std::mt19937 &random) {
+    std::normal_distribution<double> normal;
+    double x = normal(random), y = normal(random), z = normal(random), w = normal(random);
+    double length = std::sqrt(x*x + y*y + z*z + w*w);
+    Quaternion q;
+    q.x = static_cast<float>(x / length);
+    q.y = static_cast<float>(y / length);
+    q.z = static_cast<float>(z / length);
+    q.w = static_cast<float>(w / length);
+    return q;
+}
+
+// Double precision slerp along the shortest path, which is what interpolate_quat() approximates
+static void reference_slerp(const Quaternion &before, const Quaternion &after, double t, double *out) {
+    double b[4] = { before.x, before.y, before.z, before.w };
+    double a[4] = { after.x, after.y, after.z, after.w };
+    double cos_theta = b[0]*a[0] + b[1]*a[1] + b[2]*a[2] + b[3]*a[3];
+    if(cos_theta < 0) {
+        for(auto &c : a) {
+            c = -c;
+        }
+        cos_theta = -cos_theta;
+    }
+    double theta = std::acos(std::min(cos_theta, 1.0));
+    double r0 = 1.0 - t, r1 = t;
+    if(theta > 1e-12) {
+        r0 = std::sin((1.0 - t) * theta) / std::sin(theta);
+        r1 = std::sin(t * theta) / std::sin(theta);
+    }
+    for(int i = 0; i < 4; i++) {
+        out[i] = b[i] * r0 + a[i] * r1;
+    }
+}
+
+// Angle of the rotation between a quaternion and a double precision one. This uses the distance between them rather than acos of the dot
+// product, since acos can't tell apart angles that small.
+static double rotation_error(const Quaternion &q, const double *reference) {
+    double a[4] = { q.x, q.y, q.z, q.w };
+    double a_length = std::sqrt(a[0]*a[0] + a[1]*a[1] + a[2]*a[2] + a[3]*a[3]);
+    double r_length = std::sqrt(reference[0]*reference[0] + reference[1]*reference[1] + reference[2]*reference[2] + reference[3]*reference[3]);
+    double sign = (a[0]*reference[0] + a[1]*reference[1] + a[2]*reference[2] + a[3]*reference[3]) < 0 ? -1.0 : 1.0;
+    double distance_squared = 0.0;
+    for(int i = 0; i < 4; i++) {
+        double d = a[i] / a_length - sign * reference[i] / r_length;
+        distance_squared += d * d;
+    }
+
+    // The quaternions are 2 * asin(distance / 2) apart, and the rotations are twice that
+    return 4.0 * std::asin(std::min(std::sqrt(distance_squared) / 2.0, 1.0));
+}
+
+static bool same_bits(const Quaternion &a, const Quaternion &b) {
+    return std::memcmp(&a, &b, sizeof(a)) == 0;
+}
+
+// Random pairs, interpolated in batches of random sizes so both full groups of four and leftovers get tested
+static void test_accuracy(std::size_t pairs, std::uint32_t seed) {
+    std::mt19937 random(seed);
+    std::uniform_real_distribution<float> progress(0.0F, 1.0F);
+    std::uniform_int_distribution<std::size_t> batch_size(1, 67);
+
+    double max_error = 0.0, max_error_single = 0.0, max_length_error = 0.0;
+    std::size_t skipped = 0;
+
+    std::vector<Quaternion> before, after, out;
+    for(std::size_t done = 0; done < pairs; ) {
+        std::size_t count = std::min(batch_size(random), pairs - done);
+        float t = progress(random);
+
+        before.resize(count);
+        after.resize(count);
+        out.assign(count, Quaternion());
+        for(std::size_t i = 0; i < count; i++) {
+            before[i] = random_quaternion(random);
+            after[i] = random_quaternion(random);
+        }
+        interpolate_quats(before.data(), after.data(), out.data(), count, t);
+
+        for(std::size_t i = 0; i < count; i++) {
+            // Pairs that are too far apart are left alone, just like interpolate_quat()
+            Quaternion single;
+            interpolate_quat(before[i], after[i], single, t);
+            float cos_half_theta = std::fabs(before[i].x*after[i].x + before[i].y*after[i].y + before[i].z*after[i].z + before[i].w*after[i].w);
+            if(cos_half_theta < 0.01F) {
+                CHECK(same_bits(out[i], Quaternion()));
+                skipped++;
+                continue;
+            }
+
+            double reference[4];
+            reference_slerp(before[i], after[i], t, reference);
+            max_error = std::max(max_error, rotation_error(out[i], reference));
+            max_error_single = std::max(max_error_single, rotation_error(single, reference));
+
+            double length = std::sqrt(static_cast<double>(out[i].x)*out[i].x + static_cast<double>(out[i].y)*out[i].y + static_cast<double>(out[i].z)*out[i].z + static_cast<double>(out[i].w)*out[i].w);
+            max_length_error = std::max(max_length_error, std::fabs(length - 1.0));
+
+            // The result can't depend on where it was in the batch
+            Quaternion alone;
+            interpolate_quats(&before[i], &after[i], &alone, 1, t);
+            CHECK(same_bits(alone, out[i]));
+        }
+
+        done += count;
+    }
+
+    std::printf("%zu pairs (%zu too far apart)\n", pairs, skipped);
+    std::printf("interpolate_quats: max rotation error %.3g rad, max length error %.3g\n", max_error, max_length_error);
+    std::printf("interpolate_quat:  max rotation error %.3g rad\n", max_error_single);
+    CHECK(max_error < MAX_ROTATION_ERROR);
+    CHECK(max_length_error < MAX_LENGTH_ERROR);
+}
+
+// Close pairs are the common case (a node barely moves in a tick), so make sure those are right too
+static void test_close(std::uint32_t seed) {
+    std::mt19937 random(seed);
+    std::normal_distribution<float> nudge(0.0F, 1e-3F);
+
+    double max_error = 0.0;
+    for(int i = 0; i < 100000; i++) {
+        auto before = random_quaternion(random);
+        auto after = before;
+        after.x += nudge(random);
+        after.y += nudge(random);
+        after.z += nudge(random);
+        after.w += nudge(random);
+        float length = std::sqrt(after.x*after.x + after.y*after.y + after.z*after.z + after.w*after.w);
+        after.x /= length;
+        after.y /= length;
+        after.z /= length;
+        after.w /= length;
+
+        // Identical quaternions have to stay identical
+        Quaternion out;
+        interpolate_quats(&before, &before, &out, 1, 0.5F);
+        double reference[4];
+        reference_slerp(before, before, 0.5, reference);
+        max_error = std::max(max_error, rotation_error(out, reference));
+
+        interpolate_quats(&before, &after, &out, 1, 0.25F);
+        reference_slerp(before, after, 0.25, reference);
+        max_error = std::max(max_error, rotation_error(out, reference));
+    }
+    CHECK(max_error < MAX_ROTATION_ERROR);
+}
+
+// Floats are interpolated linearly, and like quaternions, the result doesn't depend on where it was
+static void test_floats() {
+    std::mt19937 random(1);
+    std::uniform_real_distribution<float> value(-1000.0F, 1000.0F);
+    for(std::size_t count = 0; count < 40; count++) {
+        std::vector<float> before(count), after(count), out(count);
+        for(std::size_t i = 0; i < count; i++) {
+            before[i] = value(random);
+            after[i] = value(random);
+        }
+        float t = 0.3F;
+        interpolate_floats(before.data(), after.data(), out.data(), count, t);
+        for(std::size_t i = 0; i < count; i++) {
+            float alone;
+            interpolate_floats(&before[i], &after[i], &alone, 1, t);
+            CHECK(std::memcmp(&alone, &out[i], sizeof(alone)) == 0);
+            CHECK(std::fabs(out[i] - (before[i] + (after[i] - before[i]) * t)) <= 1e-4F);
+        }
+
+        // The output can be one of the inputs
+        interpolate_floats(before.data(), after.data(), before.data(), count, t);
+        CHECK(before == out);
+    }
+}
+
+int main(int argc, const char **argv) {
+    if(argc > 3) {
+        std::printf("Usage: %s [pairs] [seed]\n", argv[0]);
+        return 1;
+    }
+    std::size_t pairs = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 1000000;
+    auto seed = static_cast<std::uint32_t>(argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 1);
+
+    test_accuracy(pairs, seed);
+    test_close(seed);
+    test_floats();
+    return test_result();
+}
@@ -0,0 +1,92 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+#include "../halo_data/object_children.hpp"
+#include "interpolation_recording.hpp"
+#include "test.hpp"
+
+using namespace Chimera;
+
+// Tables bigger than this take too long to rescan
+#define MAX_RESCAN_SIZE 16384
+
+// Find children by going through the whole table for each object, which is what interpolation used to do
+static void rescan_children(const std::vector<ObjectID> &objects, const std::vector<std::uint16_t> &parents, std::vector<std::uint16_t> &children_start, std::vector<std::uint16_t> &children) {
+    std::size_t max_objects = children_start.size() - 1;
+    children.clear();
+    for(std::size_t p = 0; p < max_objects; p++) {
+        children_start[p] = static_cast<std::uint16_t>(children.size());
+        for(std::size_t i = 0; i < objects.size(); i++) {
+            if(parents[i] == p) {
+                children.push_back(objects[i].index.index);
+            }
+        }
+    }
+    children_start[max_objects] = static_cast<std::uint16_t>(children.size());
+}
+
+template<typename F> static double time_microseconds(std::size_t iterations, F function) {
+    auto start = std::chrono::steady_clock::now();
+    for(std::size_t i = 0; i < iterations; i++) {
+        function();
+    }
+    return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / iterations;
+}
+
+// Build the children of synthetic object tables of doubling sizes, both in one pass and by rescanning the table for each object, and check
+// that both agree
+int main(int argc, const char **argv) {
+    if(argc > 3) {
+        std::printf("Usage: %s [max objects] [iterations]\n", argv[0]);
+        return 1;
+    }
+    std::size_t max_size = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 65535;
+    std::size_t iterations = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 1000;
+    if(max_size == 0 || max_size > RECORDED_NO_PARENT || iterations == 0) {
+        std::printf("There can be 1 to %u objects, and there has to be at least one iteration\n", RECORDED_NO_PARENT);
+        return 1;
+    }
+
+    std::printf("%8s %8s %12s %12s %12s\n", "objects", "children", "one pass", "rescan", "speedup");
+    for(std::size_t size = std::min<std::size_t>(64, max_size); ; size = std::min(size * 2, max_size)) {
+        auto recording = make_synthetic_recording(size, 1, 12345);
+        std::vector<ObjectID> objects;
+        std::vector<std::uint16_t> parents;
+        for(auto &object : recording.ticks[0].objects) {
+            ObjectID id;
+            id.index.index = object.index;
+            id.index.id = 0;
+            objects.push_back(id);
+            parents.push_back(object.parent);
+        }
+
+        std::vector<std::uint16_t> children_start, children;
+        auto one_pass = time_microseconds(iterations, [&]() {
+            build_object_children(objects.data(), parents.data(), parents.size(), size, children_start, children);
+        });
+        std::printf("%8zu %8zu %9.2f us", size, children.size(), one_pass);
+
+        if(size <= MAX_RESCAN_SIZE) {
+            std::vector<std::uint16_t> rescan_start(size + 1), rescan;
+            auto rescan_time = time_microseconds(std::max<std::size_t>(1, iterations * 64 / size), [&]() {
+                rescan_children(objects, parents, rescan_start, rescan);
+            });
+            std::printf(" %9.2f us %11.1fx\n", rescan_time, rescan_time / one_pass);
+            CHECK(rescan_start == children_start);
+            CHECK(rescan == children);
+        }
+        else {
+            std::printf(" %12s %12s\n", "-", "-");
+        }
+
+        if(size == max_size) {
+            break;
+        }
+    }
+
+    return test_result();
+}
@@ -0,0 +1,191 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#include <cctype>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+#include "../command/split_arguments.hpp"
+#include "test.hpp"
+
+using namespace Chimera;
+
+// How split_arguments() worked before SplitArguments, one std::string at a time. SplitArguments has to give exactly the same thing.
+static std::vector<std::string> reference_split_arguments(const std::string &command) {
+    std::vector<std::string> arguments;
+    bool in_quotes = false;
+    bool escape_character = false;
+    bool allow_empty_argument = false;
+
+    std::string argument;
+    for(char c : command) {
+        if(escape_character) {
+            escape_character = false;
+        }
+        else if(c == '\\') {
+            escape_character = true;
+            continue;
+        }
+        else if(c == '"') {
+            in_quotes = !in_quotes;
+            allow_empty_argument = true;
+            continue;
+        }
+        else if((c == ' ' || c == '\r' || c == '\n' || c == '#') && !in_quotes) {
+            if(argument != "" || allow_empty_argument) {
+                arguments.push_back(argument);
+                argument = "";
+                allow_empty_argument = false;
+            }
+            if(c == '#') {
+                break;
+            }
+            continue;
+        }
+        argument += c;
+    }
+
+    if(argument != "" || allow_empty_argument) {
+        arguments.push_back(argument);
+    }
+
+    return arguments;
+}
+
+static std::vector<std::string> split(const std::string &command) {
+    SplitArguments split(command.c_str());
+    std::vector<std::string> arguments;
+    for(std::size_t i = 0; i < split.size(); i++) {
+        arguments.emplace_back(split[i]);
+        if(split.argv()[i] != split[i]) {
+            arguments.emplace_back("argv() and [] differ");
+        }
+    }
+    return arguments;
+}
+
+// Commands and what they have to split into
+static void test_corpus() {
+    struct Case {
+        std::string command;
+        std::vector<std::string> arguments;
+    };
+
+    const Case cases[] = {
+        { "", {} },
+        { "   ", {} },
+        { "# just a comment", {} },
+        { "chimera", { "chimera" } },
+        { "chimera_fov 70", { "chimera_fov", "70" } },
+        { "  leading and   trailing  ", { "leading", "and", "trailing" } },
+        { "a\tb", { "a\tb" } },
+        { "a\r\nb\nc\rd", { "a", "b", "c", "d" } },
+        { "say \"hello world\"", { "say", "hello world" } },
+        { "say \"\"", { "say", "" } },
+        { "\"\" \"\"", { "", "" } },
+        { "say hel\"lo wor\"ld", { "say", "hello world" } },
+        { "say \"unterminated quote", { "say", "unterminated quote" } },
+        { "say \"quoted # is not a comment\"", { "say", "quoted # is not a comment" } },
+        { "say unquoted#comment", { "say", "unquoted" } },
+        { "say a #comment \"with quotes\"", { "say", "a" } },
+        { "say \\\"escaped quote\\\"", { "say", "\"escaped", "quote\"" } },
+        { "say escaped\\ space", { "say", "escaped space" } },
+        { "say escaped\\#hash", { "say", "escaped#hash" } },
+        { "path C:\\\\Games\\\\Halo", { "path", "C:\\Games\\Halo" } },
+        { "trailing backslash\\", { "trailing", "backslash" } },
+        { "\"in quotes \\\" still in quotes\"", { "in quotes \" still in quotes" } },
+        { "a\"\"b", { "ab" } },
+        { "\"\"#", { "" } },
+        { "\"\"\\ ", { " " } },
+    };
+
+    for(auto &c : cases) {
+        bool correct = split(c.command) == c.arguments;
+        if(!correct) {
+            std::fprintf(stderr, "wrong split: [%s]\n", c.command.c_str());
+        }
+        CHECK(correct);
+        CHECK(split_arguments(c.command.c_str()) == c.arguments);
+        CHECK(reference_split_arguments(c.command) == c.arguments);
+    }
+
+    // Over 16 arguments and over 256 bytes go on the heap
+    std::string many;
+    std::vector<std::string> many_arguments;
+    for(int i = 0; i < 100; i++) {
+        many += " \"argument " + std::to_string(i) + "\"";
+        many_arguments.emplace_back("argument " + std::to_string(i));
+    }
+    CHECK(split(many) == many_arguments);
+
+    // Arguments can be modified in place
+    SplitArguments lowercase("CHIMERA_FOV 70");
+    for(char *c = lowercase.argument(0); *c; c++) {
+        *c = static_cast<char>(std::tolower(*c));
+    }
+    CHECK(std::string(lowercase[0]) == "chimera_fov");
+    CHECK(std::string(lowercase[1]) == "70");
+}
+
+// Random commands made mostly of the characters that matter have to split the same way they used to
+static void test_fuzz(std::size_t iterations, std::uint32_t seed) {
+    static const char alphabet[] = "\"\\# \r\n\tab";
+    std::mt19937 random(seed);
+    std::uniform_int_distribution<std::size_t> character(0, sizeof(alphabet) - 2);
+    std::uniform_int_distribution<std::size_t> length(0, 600);
+
+    std::size_t mismatches = 0;
+    for(std::size_t i = 0; i < iterations; i++) {
+        std::string command(length(random), ' ');
+        for(auto &c : command) {
+            c = alphabet[character(random)];
+        }
+        if(split(command) != reference_split_arguments(command)) {
+            if(mismatches++ == 0) {
+                std::fprintf(stderr, "split differs for seed %u, iteration %zu: [%s]\n", seed, i, command.c_str());
+            }
+        }
+    }
+    CHECK(mismatches == 0);
+}
+
+// Anything unsplit has to split back into the same arguments (except empty ones and line breaks, which unsplit_arguments() can't do)
+static void test_round_trip(std::size_t iterations, std::uint32_t seed) {
+    static const char alphabet[] = "\"\\# \tab";
+    std::mt19937 random(seed);
+    std::uniform_int_distribution<std::size_t> character(0, sizeof(alphabet) - 2);
+    std::uniform_int_distribution<std::size_t> length(1, 12);
+    std::uniform_int_distribution<std::size_t> count(0, 24);
+
+    std::size_t mismatches = 0;
+    for(std::size_t i = 0; i < iterations; i++) {
+        std::vector<std::string> arguments(count(random));
+        for(auto &argument : arguments) {
+            argument.resize(length(random));
+            for(auto &c : argument) {
+                c = alphabet[character(random)];
+            }
+        }
+        auto unsplit = unsplit_arguments(arguments);
+        if(split(unsplit) != arguments) {
+            if(mismatches++ == 0) {
+                std::fprintf(stderr, "round trip differs for seed %u, iteration %zu: [%s]\n", seed, i, unsplit.c_str());
+            }
+        }
+    }
+    CHECK(mismatches == 0);
+}
+
+int main(int argc, const char **argv) {
+    if(argc > 3) {
+        std::printf("Usage: %s [iterations] [seed]\n", argv[0]);
+        return 1;
+    }
+    std::size_t iterations = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 200000;
+    auto seed = static_cast<std::uint32_t>(argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 1);
+
+    test_corpus();
+    test_fuzz(iterations, seed);
+    test_round_trip(iterations / 4, seed);
+    return test_result();
+}
@@ -0,0 +1,88 @@
+# SPDX-License-Identifier: GPL-3.0-only
+
+# Benchmarks aren't worth much without optimizations
+if(NOT CMAKE_BUILD_TYPE)
+    set(CMAKE_BUILD_TYPE Release)
+endif()
+
+# Same warnings as Chimera, but built for whatever we're running on
+set(CMAKE_CXX_FLAGS "${CMAKE_CXX_FLAGS} -Wall -pedantic -Wextra -Wold-style-cast")
+
+# Instruction decoding and relocation, checked against instruction_corpus.txt (regenerate it with make_instruction_corpus.py)
+add_executable(instruction_test
+    src/chimera/test/instruction.cpp
+    src/chimera/signature/instruction.cpp
+)
+add_test(NAME instruction COMMAND instruction_test "${CMAKE_CURRENT_SOURCE_DIR}/src/chimera/test/instruction_corpus.txt")
+
+# Job pool, including a stress test for submitting and taking jobs at the same time
+find_package(Threads REQUIRED)
+add_executable(job_pool_test
+    src/chimera/test/job_pool.cpp
+    src/chimera/job/job_pool.cpp
+)
+target_link_libraries(job_pool_test Threads::Threads)
+add_test(NAME job_pool COMMAND job_pool_test)
+
+# Ini parsing, plus a benchmark for parsing and looking up generated files (run ini_benchmark [key count] [iterations])
+add_executable(ini_test
+    src/chimera/test/ini.cpp
+    src/chimera/config/ini.cpp
+)
+add_test(NAME ini COMMAND ini_test)
+
+add_executable(ini_benchmark
+    src/chimera/test/ini_benchmark.cpp
+    src/chimera/config/ini.cpp
+)
+
+# Splitting command arguments, checked against how it used to be done with random commands (run split_arguments_test [iterations] [seed])
+add_executable(split_arguments_test
+    src/chimera/test/split_arguments.cpp
+    src/chimera/command/split_arguments.cpp
+)
+add_test(NAME split_arguments COMMAND split_arguments_test)
+
+# Accuracy of batched quaternion interpolation against a double precision slerp (run math_trig_test [pairs] [seed] for more pairs)
+add_executable(math_trig_test
+    src/chimera/test/math_trig.cpp
+    src/chimera/math_trig/math_trig.cpp
+)
+add_test(NAME math_trig COMMAND math_trig_test)
+
+# Object and particle interpolation, plus a replayer for recordings made with chimera_record_interpolation (run interpolation_replay
+# <recording.bin | --synthetic <objects> <ticks>> [fps] [--frames] for per-frame costs and checksums)
+add_library(interpolation_harness STATIC
+    src/chimera/test/interpolation_recording.cpp
+    src/chimera/fix/interpolate/object_interpolator.cpp
+    src/chimera/fix/interpolate/particle_interpolator.cpp
+    src/chimera/halo_data/object_children.cpp
+    src/chimera/math_trig/math_trig.cpp
+)
+
+add_executable(interpolation_test
+    src/chimera/test/interpolation.cpp
+)
+target_link_libraries(interpolation_test interpolation_harness)
+add_test(NAME interpolation COMMAND interpolation_test)
+
+add_executable(interpolation_replay
+    src/chimera/test/interpolation_replay.cpp
+)
+target_link_libraries(interpolation_replay interpolation_harness)
+add_test(NAME interpolation_replay COMMAND interpolation_replay --synthetic 500 90 144)
+
+# Building each object's children in one pass compared to rescanning the table for each object, on synthetic tables of doubling sizes (run
+# object_children_benchmark [max objects] [iterations])
+add_executable(object_children_benchmark
+    src/chimera/test/object_children_benchmark.cpp
+)
+target_link_libraries(object_children_benchmark interpolation_harness)
+add_test(NAME object_children COMMAND object_children_benchmark 2048 10)
+
+# Frame pacing with made up times: how long to sleep, how oversleeping is tracked, and frame time statistics
+add_executable(frame_pacer_test
+    src/chimera/test/frame_pacer.cpp
+    src/chimera/miscellaneous/frame_pacer.cpp
+)
+add_test(NAME frame_pacer COMMAND frame_pacer_test)
@@ -0,0 +1,36 @@
+// SPDX-License-Identifier: GPL-3.0-only
+
+#ifndef CHIMERA_TEST_HPP
+#define CHIMERA_TEST_HPP
+
+#include <cstdio>
+
+namespace Chimera {
+    /** Number of checks that have failed */
+    inline int test_failures = 0;
+
+    /**
+     * Check that a condition holds, printing where it didn't if it doesn't
+     * @param condition condition to check
+     */
+    #define CHECK(condition) do { \
+        if(!(condition)) { \
+            std::fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition); \
+            Chimera::test_failures++; \
+        } \
+    } while(0)
+
+    /**
+     * Finish the test
+     * @return exit code for main()
+     */
+    inline int test_result() noexcept {
+        if(test_failures) {
+            std::fprintf(stderr, "%d check(s) failed\n", test_failures);
+            return 1;
+        }
+        return 0;
+    }
+}
+
+#endif
@@ -179,6 +179,12 @@ BOOL WINAPI DllMain(HINSTANCE instance, DWORD reason, LPVOID reserved) {
             }
             break;
         case DLL_PROCESS_DETACH:
+            {
+                // Worker threads are already gone by now, so save anything that's still pending on this thread
+                extern void flush_chimera();
+                flush_chimera();
+            }
+
             unload_dlls();
 
             WSACleanup();